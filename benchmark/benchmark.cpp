@@ -1,13 +1,23 @@
 #include "gtest/gtest.h"
 #include "../xpjson.hpp"
+#include <sstream>
 
 #ifdef _WIN32
 	#include <Winbase.h>
 #else
 	#include <sys/time.h>
 #endif
+using namespace std;
 
 #define RUN_TIMES  100000
+// elements of the generated large document(about 10MB) and its run times
+#define LARGE_ELEMS      20000
+#define LARGE_RUN_TIMES  20
+// elements of the generated medium document(about 50KB) and its run times
+#define MEDIUM_ELEMS     100
+#define MEDIUM_RUN_TIMES 4000
+
+static const char* SAMPLE = "{\"images\":[{\"height\":768,\"size\":\"LARGE\",\"title\":\"Javaone Keynote\",\"uri\":\"http:\\/\\/javaone.com\\/keynote_large.jpg\",\"width\":1024},{\"height\":240,\"size\":\"SMALL\",\"title\":\"Javaone Keynote\",\"uri\":\"http:\\/\\/javaone.com\\/keynote_small.jpg\",\"width\":320}],\"media\":{\"bitrate\":262144,\"copyright\":null,\"duration\":1800000,\"format\":\"video\\/mpg4\",\"height\":480,\"persons\":[\"Bill Gates\",\"Steve Jobs\"],\"player\":\"JAVA\",\"size\":58982400,\"title\":\"Javaone Keynote\",\"uri\":\"http:\\/\\/javaone.com\\/keynote.mpg\",\"width\":640}}";
 
 class TimeCost
 {
@@ -148,7 +158,7 @@ TEST(benchmark_xpjson, read)
 	try {
 		TimeCost tc;
 		int times = RUN_TIMES;
-		string in("{\"images\":[{\"height\":768,\"size\":\"LARGE\",\"title\":\"Javaone Keynote\",\"uri\":\"http:\\/\\/javaone.com\\/keynote_large.jpg\",\"width\":1024},{\"height\":240,\"size\":\"SMALL\",\"title\":\"Javaone Keynote\",\"uri\":\"http:\\/\\/javaone.com\\/keynote_small.jpg\",\"width\":320}],\"media\":{\"bitrate\":262144,\"copyright\":null,\"duration\":1800000,\"format\":\"video\\/mpg4\",\"height\":480,\"persons\":[\"Bill Gates\",\"Steve Jobs\"],\"player\":\"JAVA\",\"size\":58982400,\"title\":\"Javaone Keynote\",\"uri\":\"http:\\/\\/javaone.com\\/keynote.mpg\",\"width\":640}}");
+		string in(SAMPLE);
 		do {
 			JSON::Value v;
 			tc.start();
@@ -164,6 +174,680 @@ TEST(benchmark_xpjson, read)
 	}
 }
 
+// same as read, one value read again in place, nothing allocated after the first
+TEST(benchmark_xpjson, read_reuse)
+{
+	try {
+		TimeCost tc;
+		int times = RUN_TIMES;
+		string in(SAMPLE);
+		JSON::Value v;
+		do {
+			tc.start();
+			JSON::Reader::read_reuse(v, in);
+			tc.end();
+		}
+		while (--times);
+		printf("time cost: %" PRId64 "ms\n", tc.timecost());
+	}
+	catch(std::exception &e) {
+		printf("Error : %s.", e.what());
+		ASSERT_TRUE(false);
+	}
+}
+
+void large_document(string& in, int elems = LARGE_ELEMS)
+{
+	in = "[";
+	for(int i = 0; i < elems; ++i) {
+		if(i) in += ",\n  ";
+		in += SAMPLE;
+	}
+	in += "]";
+}
+
+void print_throughput(size_t bytes, uint64_t ms)
+{
+	printf("time cost: %" PRId64 "ms, %.1f MB/s\n", ms, ms ? bytes * 1000.0 / 1048576 / ms : 0.0);
+}
+
+TEST(benchmark_xpjson, read_medium)
+{
+	try {
+		TimeCost tc;
+		int times = MEDIUM_RUN_TIMES;
+		string in;
+		large_document(in, MEDIUM_ELEMS);
+		do {
+			JSON::Value v;
+			tc.start();
+			JSON::Reader::read(v, in);
+			tc.end();
+		}
+		while (--times);
+		print_throughput(in.length() * MEDIUM_RUN_TIMES, tc.timecost());
+	}
+	catch(std::exception &e) {
+		printf("Error : %s.", e.what());
+		ASSERT_TRUE(false);
+	}
+}
+
+TEST(benchmark_xpjson, read_large)
+{
+	try {
+		TimeCost tc;
+		int times = LARGE_RUN_TIMES;
+		string in;
+		large_document(in);
+		do {
+			JSON::Value v;
+			tc.start();
+			JSON::Reader::read(v, in);
+			tc.end();
+		}
+		while (--times);
+		print_throughput(in.length() * LARGE_RUN_TIMES, tc.timecost());
+	}
+	catch(std::exception &e) {
+		printf("Error : %s.", e.what());
+		ASSERT_TRUE(false);
+	}
+}
+
+// counts events only, for SAX parse cost
+struct count_handler
+{
+	size_t n;
+	count_handler() : n(0) {}
+	bool on_null() {++n; return true;}
+	bool on_boolean(bool) {++n; return true;}
+	bool on_int(int64_t) {++n; return true;}
+	bool on_double(double) {++n; return true;}
+	bool on_string(const char*, size_t) {++n; return true;}
+	bool on_key(const char*, size_t) {++n; return true;}
+	bool on_object_begin() {++n; return true;}
+	bool on_object_end() {++n; return true;}
+	bool on_array_begin() {++n; return true;}
+	bool on_array_end() {++n; return true;}
+};
+
+TEST(benchmark_xpjson, sax_parse_large)
+{
+	try {
+		TimeCost tc;
+		int times = LARGE_RUN_TIMES;
+		string in;
+		large_document(in);
+		do {
+			count_handler h;
+			tc.start();
+			JSON::Reader::parse(h, in);
+			tc.end();
+		}
+		while (--times);
+		print_throughput(in.length() * LARGE_RUN_TIMES, tc.timecost());
+	}
+	catch(std::exception &e) {
+		printf("Error : %s.", e.what());
+		ASSERT_TRUE(false);
+	}
+}
+
+// reads 3 fields of each element, others are skipped
+TEST(benchmark_xpjson, cursor_large)
+{
+	try {
+		TimeCost tc;
+		int times = LARGE_RUN_TIMES;
+		string in;
+		large_document(in);
+		int64_t sum = 0;
+		do {
+			tc.start();
+			for(JSON::Cursor e = JSON::Cursor(in).begin(); e.valid(); e = e.next()) {
+				JSON::Cursor media = e["media"];
+				sum += media["duration"].i() + media["width"].i() + media["height"].i();
+			}
+			tc.end();
+		}
+		while (--times);
+		ASSERT_TRUE(sum == int64_t(1800000 + 640 + 480) * LARGE_ELEMS * LARGE_RUN_TIMES);
+		print_throughput(in.length() * LARGE_RUN_TIMES, tc.timecost());
+	}
+	catch(std::exception &e) {
+		printf("Error : %s.", e.what());
+		ASSERT_TRUE(false);
+	}
+}
+
+// elements are kept raw, like a gateway passes the body through
+TEST(benchmark_xpjson, read_lazy_large)
+{
+	try {
+		TimeCost tc;
+		int times = LARGE_RUN_TIMES;
+		string in;
+		large_document(in);
+		do {
+			JSON::Value v;
+			tc.start();
+			JSON::Reader::read_lazy(v, in);
+			tc.end();
+		}
+		while (--times);
+		print_throughput(in.length() * LARGE_RUN_TIMES, tc.timecost());
+	}
+	catch(std::exception &e) {
+		printf("Error : %s.", e.what());
+		ASSERT_TRUE(false);
+	}
+}
+
+// same 3 fields as cursor_large, selected by a field mask
+TEST(benchmark_xpjson, read_projected_large)
+{
+	try {
+		TimeCost tc;
+		int times = LARGE_RUN_TIMES;
+		string in;
+		large_document(in);
+		JSON::FieldMask mask;
+		mask.add("/*/media/duration").add("/*/media/width").add("/*/media/height");
+		int64_t sum = 0;
+		do {
+			JSON::Value v;
+			tc.start();
+			JSON::Reader::read(v, in, mask);
+			tc.end();
+			for(size_t i = 0; i < v.a().size(); ++i) {
+				sum += v[i]["media"]["duration"].i() + v[i]["media"]["width"].i() + v[i]["media"]["height"].i();
+			}
+		}
+		while (--times);
+		ASSERT_TRUE(sum == int64_t(1800000 + 640 + 480) * LARGE_ELEMS * LARGE_RUN_TIMES);
+		print_throughput(in.length() * LARGE_RUN_TIMES, tc.timecost());
+	}
+	catch(std::exception &e) {
+		printf("Error : %s.", e.what());
+		ASSERT_TRUE(false);
+	}
+}
+
+// same elements as read_large, one per line
+void lines_document(string& in, int elems = LARGE_ELEMS)
+{
+	in.clear();
+	for(int i = 0; i < elems; ++i) {
+		in += SAMPLE;
+		in += '\n';
+	}
+}
+
+void read_lines_large(unsigned threads)
+{
+	try {
+		TimeCost tc;
+		int times = LARGE_RUN_TIMES;
+		string in;
+		lines_document(in);
+		do {
+			vector<JSON::Value> out;
+			tc.start();
+			JSON::Reader::read_lines(out, in, NULL, threads);
+			tc.end();
+			ASSERT_TRUE(out.size() == LARGE_ELEMS);
+		}
+		while (--times);
+		print_throughput(in.length() * LARGE_RUN_TIMES, tc.timecost());
+	}
+	catch(std::exception &e) {
+		printf("Error : %s.", e.what());
+		ASSERT_TRUE(false);
+	}
+}
+
+TEST(benchmark_xpjson, read_lines_large)
+{
+	read_lines_large(1);
+}
+
+// scales with cores
+TEST(benchmark_xpjson, read_lines_large_threads)
+{
+	read_lines_large(0);
+}
+
+// scales with cores, same as read_large on one
+TEST(benchmark_xpjson, read_parallel_large)
+{
+	try {
+		TimeCost tc;
+		int times = LARGE_RUN_TIMES;
+		string in;
+		large_document(in);
+		do {
+			JSON::Value v;
+			tc.start();
+			JSON::Reader::read_parallel(v, in);
+			tc.end();
+			ASSERT_TRUE(v.a().size() == LARGE_ELEMS);
+		}
+		while (--times);
+		print_throughput(in.length() * LARGE_RUN_TIMES, tc.timecost());
+	}
+	catch(std::exception &e) {
+		printf("Error : %s.", e.what());
+		ASSERT_TRUE(false);
+	}
+}
+
+// same as read_large, escaped uris are decoded in place
+TEST(benchmark_xpjson, read_insitu_large)
+{
+	try {
+		TimeCost tc;
+		int times = LARGE_RUN_TIMES;
+		string in, buf;
+		large_document(in);
+		do {
+			JSON::Value v;
+			// input is modified, so read a fresh copy each time
+			buf = in;
+			tc.start();
+			JSON::Reader::read_insitu(v, buf);
+			tc.end();
+			ASSERT_TRUE(v.a().size() == LARGE_ELEMS);
+		}
+		while (--times);
+		print_throughput(in.length() * LARGE_RUN_TIMES, tc.timecost());
+	}
+	catch(std::exception &e) {
+		printf("Error : %s.", e.what());
+		ASSERT_TRUE(false);
+	}
+}
+
+// same as read_large, keys and unescaped strings refer to input
+TEST(benchmark_xpjson, read_cow_large)
+{
+	try {
+		TimeCost tc;
+		int times = LARGE_RUN_TIMES;
+		string in;
+		large_document(in);
+		do {
+			JSON::Value v;
+			tc.start();
+			JSON::Reader::read(v, in, true);
+			tc.end();
+			ASSERT_TRUE(v.a().size() == LARGE_ELEMS);
+		}
+		while (--times);
+		print_throughput(in.length() * LARGE_RUN_TIMES, tc.timecost());
+	}
+	catch(std::exception &e) {
+		printf("Error : %s.", e.what());
+		ASSERT_TRUE(false);
+	}
+}
+
+// same document in a file, mapped and owned by document, file loading included
+TEST(benchmark_xpjson, read_file_large)
+{
+	const char* path = "benchmark_read_file_large.json";
+	try {
+		TimeCost tc;
+		int times = LARGE_RUN_TIMES;
+		string in;
+		large_document(in);
+		FILE* fp = fopen(path, "wb");
+		ASSERT_TRUE(fp && fwrite(in.data(), 1, in.length(), fp) == in.length());
+		fclose(fp);
+		do {
+			JSON::Document doc;
+			tc.start();
+			JSON::Reader::read_file(doc, path);
+			tc.end();
+			ASSERT_TRUE(doc.a().size() == LARGE_ELEMS);
+		}
+		while (--times);
+		remove(path);
+		print_throughput(in.length() * LARGE_RUN_TIMES, tc.timecost());
+	}
+	catch(std::exception &e) {
+		remove(path);
+		printf("Error : %s.", e.what());
+		ASSERT_TRUE(false);
+	}
+}
+
+// same as read_large, pulled from stream by blocks of 64KB
+TEST(benchmark_xpjson, read_stream_large)
+{
+	try {
+		TimeCost tc;
+		int times = LARGE_RUN_TIMES;
+		string in;
+		large_document(in);
+		do {
+			JSON::Value v;
+			istringstream is(in);
+			tc.start();
+			JSON::Reader::read_stream(v, is);
+			tc.end();
+			ASSERT_TRUE(v.a().size() == LARGE_ELEMS);
+		}
+		while (--times);
+		print_throughput(in.length() * LARGE_RUN_TIMES, tc.timecost());
+	}
+	catch(std::exception &e) {
+		printf("Error : %s.", e.what());
+		ASSERT_TRUE(false);
+	}
+}
+
+// same document as read_large, checked only without building it
+TEST(benchmark_xpjson, validate_large)
+{
+	TimeCost tc;
+	int times = LARGE_RUN_TIMES;
+	string in;
+	large_document(in);
+	do {
+		size_t depth = 0;
+		tc.start();
+		const JSON::ReadResult r = JSON::Reader::validate(in, &depth);
+		tc.end();
+		ASSERT_TRUE(r.ok() && r.offset == in.length() && depth == 4);
+	}
+	while (--times);
+	print_throughput(in.length() * LARGE_RUN_TIMES, tc.timecost());
+}
+
+// SAMPLE cut short at every 16 chars, all malformed
+void malformed_documents(vector<string>& out)
+{
+	const string in(SAMPLE);
+	for(size_t i = 16; i < in.length(); i += 16) out.push_back(in.substr(0, i));
+}
+
+// errors caught as exceptions, compare with read_malformed_try
+TEST(benchmark_xpjson, read_malformed_throw)
+{
+	TimeCost tc;
+	int times = RUN_TIMES / 10;
+	vector<string> in;
+	malformed_documents(in);
+	size_t bytes = 0, errors = 0;
+	tc.start();
+	do {
+		for(size_t i = 0; i < in.size(); ++i) {
+			JSON::Value v;
+			try {
+				JSON::Reader::read(v, in[i]);
+			}
+			catch(std::exception&) {
+				++errors;
+			}
+			bytes += in[i].length();
+		}
+	}
+	while (--times);
+	tc.end();
+	ASSERT_TRUE(errors == in.size() * (RUN_TIMES / 10));
+	print_throughput(bytes, tc.timecost());
+}
+
+// errors returned by try_read, message is not formatted
+TEST(benchmark_xpjson, read_malformed_try)
+{
+	TimeCost tc;
+	int times = RUN_TIMES / 10;
+	vector<string> in;
+	malformed_documents(in);
+	size_t bytes = 0, errors = 0;
+	tc.start();
+	do {
+		for(size_t i = 0; i < in.size(); ++i) {
+			JSON::Value v;
+			if(!JSON::Reader::try_read(v, in[i]).ok()) ++errors;
+			bytes += in[i].length();
+		}
+	}
+	while (--times);
+	tc.end();
+	ASSERT_TRUE(errors == in.size() * (RUN_TIMES / 10));
+	print_throughput(bytes, tc.timecost());
+}
+
+// same as read_large, with generous limits to show cost of counting
+TEST(benchmark_xpjson, read_limits_large)
+{
+	TimeCost tc;
+	int times = LARGE_RUN_TIMES;
+	string in;
+	large_document(in);
+	do {
+		JSON::Value v;
+		JSON::ReadLimits limits(64, in.length(), in.length(), in.length() * 16);
+		tc.start();
+		const JSON::ReadResult r = JSON::Reader::try_read(v, in.data(), in.length(), limits);
+		tc.end();
+		ASSERT_TRUE(r.ok() && v.a().size() == LARGE_ELEMS);
+	}
+	while (--times);
+	print_throughput(in.length() * LARGE_RUN_TIMES, tc.timecost());
+}
+
+// many tiny keys in one object, about 2MB
+void hostile_document(string& in)
+{
+	char buf[32];
+	in = "{";
+	for(int i = 0; i < LARGE_ELEMS * 10; ++i) {
+		snprintf(buf, sizeof(buf), "%s\"%x\":0", i ? "," : "", i);
+		in += buf;
+	}
+	in += "}";
+}
+
+// hostile document built as a whole, compare with read_hostile_limited
+TEST(benchmark_xpjson, read_hostile)
+{
+	TimeCost tc;
+	int times = LARGE_RUN_TIMES;
+	string in;
+	hostile_document(in);
+	do {
+		JSON::Value v;
+		tc.start();
+		const JSON::ReadResult r = JSON::Reader::try_read(v, in);
+		tc.end();
+		ASSERT_TRUE(r.ok());
+	}
+	while (--times);
+	print_throughput(in.length() * LARGE_RUN_TIMES, tc.timecost());
+}
+
+// hostile document rejected at 10000 nodes, throughput of whole input
+TEST(benchmark_xpjson, read_hostile_limited)
+{
+	TimeCost tc;
+	int times = LARGE_RUN_TIMES;
+	string in;
+	hostile_document(in);
+	do {
+		JSON::Value v;
+		JSON::ReadLimits limits(0, 10000);
+		tc.start();
+		const JSON::ReadResult r = JSON::Reader::try_read(v, in.data(), in.length(), limits);
+		tc.end();
+		ASSERT_TRUE(r.error == JSON::ERROR_LIMIT && limits.exceeded == JSON::LIMIT_NODES);
+	}
+	while (--times);
+	print_throughput(in.length() * LARGE_RUN_TIMES, tc.timecost());
+}
+
+// coordinates like canada.json, about 10MB
+void float_document(string& in)
+{
+	char buf[64];
+	srand(1);
+	in = "[";
+	for(int i = 0; i < LARGE_ELEMS * 12; ++i) {
+		if(i) in += ',';
+		snprintf(buf, sizeof(buf), "[%.14f,%.14f]", -180 + rand() * 360.0 / RAND_MAX, -90 + rand() * 180.0 / RAND_MAX);
+		in += buf;
+	}
+	in += "]";
+}
+
+TEST(benchmark_xpjson, read_float_large)
+{
+	try {
+		TimeCost tc;
+		int times = LARGE_RUN_TIMES;
+		string in;
+		float_document(in);
+		do {
+			JSON::Value v;
+			tc.start();
+			JSON::Reader::read(v, in);
+			tc.end();
+		}
+		while (--times);
+		print_throughput(in.length() * LARGE_RUN_TIMES, tc.timecost());
+	}
+	catch(std::exception &e) {
+		printf("Error : %s.", e.what());
+		ASSERT_TRUE(false);
+	}
+}
+
+// ids and millisecond timestamps, about 10MB
+void integer_document(string& in)
+{
+	char buf[64];
+	srand(1);
+	in = "[";
+	for(int i = 0; i < LARGE_ELEMS * 12; ++i) {
+		if(i) in += ',';
+		snprintf(buf, sizeof(buf), "[%" PRIu64 ",%" PRIu64 "]", (uint64_t)(((uint64_t)rand() << 32 | rand()) % 9000000000000000000ULL), (uint64_t)(1500000000000ULL + rand()));
+		in += buf;
+	}
+	in += "]";
+}
+
+TEST(benchmark_xpjson, read_integer_large)
+{
+	try {
+		TimeCost tc;
+		int times = LARGE_RUN_TIMES;
+		string in;
+		integer_document(in);
+		do {
+			JSON::Value v;
+			tc.start();
+			JSON::Reader::read(v, in);
+			tc.end();
+		}
+		while (--times);
+		print_throughput(in.length() * LARGE_RUN_TIMES, tc.timecost());
+	}
+	catch(std::exception &e) {
+		printf("Error : %s.", e.what());
+		ASSERT_TRUE(false);
+	}
+}
+
+// pretty print like upstream partners do: a line per member, indented by 4 spaces each level
+void indent_document(const string& in, string& out)
+{
+	int depth = 0;
+	bool in_str = false;
+	out.clear();
+	for(size_t i = 0; i < in.length(); ++i) {
+		const char ch = in[i];
+		if(in_str) {
+			out += ch;
+			if(ch == '\\') out += in[++i];
+			else if(ch == '\"') in_str = false;
+			continue;
+		}
+		switch(ch) {
+			case '{': case '[': out += ch; out += '\n'; out.append(++depth * 4, ' '); break;
+			case '}': case ']': out += '\n'; out.append(--depth * 4, ' '); out += ch; break;
+			case ',': out += ",\n"; out.append(depth * 4, ' '); break;
+			case ':': out += ": "; break;
+			case '\"': in_str = true; // fall through
+			default: out += ch; break;
+		}
+	}
+}
+
+TEST(benchmark_xpjson, skip_ws)
+{
+	string large, in;
+	large_document(large);
+	indent_document(large, in);
+	const char* p = in.data();
+	const size_t len = in.length();
+	// readers skip whitespaces after structural characters
+	vector<size_t> starts;
+	for(size_t pos = 0; pos < len; ++pos) {
+		if(strchr("{[,:", p[pos])) starts.push_back(pos + 1);
+	}
+	size_t sum = 0;
+	TimeCost tc;
+	tc.start();
+	for(int times = 0; times < LARGE_RUN_TIMES; ++times) {
+		for(size_t i = 0; i < starts.size(); ++i) {
+			size_t pos = starts[i];
+			while(pos < len && JSON::is_ws(p[pos])) ++pos;
+			sum += pos;
+		}
+	}
+	tc.end();
+	printf("is_ws   ");
+	print_throughput(len * LARGE_RUN_TIMES, tc.timecost());
+	TimeCost tc2;
+	tc2.start();
+	for(int times = 0; times < LARGE_RUN_TIMES; ++times) {
+		for(size_t i = 0; i < starts.size(); ++i) {
+			sum -= JSON::detail::skip_ws(p, starts[i], len);
+		}
+	}
+	tc2.end();
+	printf("skip_ws ");
+	print_throughput(len * LARGE_RUN_TIMES, tc2.timecost());
+	// both skip to the same offsets
+	ASSERT_EQ(sum, 0u);
+}
+
+TEST(benchmark_xpjson, read_indented_large)
+{
+	try {
+		TimeCost tc;
+		int times = LARGE_RUN_TIMES;
+		string large, in;
+		large_document(large);
+		indent_document(large, in);
+		do {
+			JSON::Value v;
+			tc.start();
+			JSON::Reader::read(v, in);
+			tc.end();
+		}
+		while (--times);
+		print_throughput(in.length() * LARGE_RUN_TIMES, tc.timecost());
+	}
+	catch(std::exception &e) {
+		printf("Error : %s.", e.what());
+		ASSERT_TRUE(false);
+	}
+}
+
 int main(int argc, char** argv)
 {
 	testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,116 @@
+#include "../xpjson.hpp"
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+
+// query one value from every line of NDJSON files, e.g.
+//   xpjson_query /tenant/id a.ndjson b.ndjson
+//   xpjson_query -d /tenant/id a.ndjson  (build whole Value of each line, for comparison)
+//   cat a.ndjson | xpjson_query tenant.id
+
+static void usage()
+{
+	std::cerr << "usage: xpjson_query [-d] [-q] <pointer|path> [file ...]" << std::endl
+			  << "  pointer is RFC 6901 JSON pointer like /a/0/b, others are paths like a[0].b" << std::endl
+			  << "  -d  build Value of each line instead of on-demand cursor, pointer only" << std::endl
+			  << "  -q  print summary only" << std::endl;
+}
+
+// walk pointer on DOM, NULL if not found
+static const JSON::Value* dom_at(const JSON::Value& v, const std::string& pointer)
+{
+	const JSON::Value* p = &v;
+	for(size_t pos = 0, end; pos < pointer.length(); pos = end) {
+		end = pointer.find('/', pos + 1);
+		if(end == std::string::npos) end = pointer.length();
+		std::string token;
+		for(size_t i = pos + 1; i < end; ++i) {
+			if(pointer[i] == '~' && i + 1 < end) token += (pointer[++i] == '0') ? '~' : '/';
+			else token += pointer[i];
+		}
+		if(p->type() == JSON::OBJECT) {
+			JSON::Object::const_iterator it = p->o().find(token);
+			if(it == p->o().end()) return NULL;
+			p = &it->second;
+		}
+		else if(p->type() == JSON::ARRAY) {
+			char* e = NULL;
+			size_t index = strtoul(token.c_str(), &e, 10);
+			if(token.empty() || *e || index >= p->a().size()) return NULL;
+			p = &p->a()[index];
+		}
+		else return NULL;
+	}
+	return p;
+}
+
+int main(int argc, char* argv[])
+{
+	bool dom = false, quiet = false;
+	int i = 1;
+	for(; i < argc && argv[i][0] == '-' && argv[i][1]; ++i) {
+		if(!strcmp(argv[i], "-d")) dom = true;
+		else if(!strcmp(argv[i], "-q")) quiet = true;
+		else {usage(); return 1;}
+	}
+	if(i >= argc) {usage(); return 1;}
+	const std::string query(argv[i++]);
+	const bool pointer = query.empty() || query[0] == '/';
+	if(dom && !pointer) {usage(); return 1;}
+
+	size_t lines = 0, matched = 0, bad = 0, bytes = 0;
+	clock_t cost = 0;
+	std::string out;
+	for(int f = i; f < argc || f == i; ++f) {
+		std::stringstream ss;
+		if(f < argc) {
+			std::ifstream ifs(argv[f], std::ios::binary);
+			if(!ifs) {std::cerr << "can't open " << argv[f] << std::endl; return 1;}
+			ss << ifs.rdbuf();
+		}
+		else ss << std::cin.rdbuf();
+		const std::string data(ss.str());
+		bytes += data.length();
+
+		const clock_t start = clock();
+		for(size_t pos = 0, end; pos < data.length(); pos = end + 1) {
+			const char* eol = (const char*)memchr(data.data() + pos, '\n', data.length() - pos);
+			end = eol ? eol - data.data() : data.length();
+			if(end == pos || (end == pos + 1 && data[pos] == '\r')) continue;
+			++lines;
+			try {
+				const char* s = NULL;
+				size_t len = 0;
+				if(dom) {
+					JSON::Value v;
+					v.read(data.data() + pos, end - pos);
+					const JSON::Value* p = dom_at(v, query);
+					if(!p) continue;
+					out.clear();
+					p->write(out);
+					s = out.data();
+					len = out.length();
+				}
+				else {
+					JSON::Cursor c(data.data() + pos, end - pos);
+					c = pointer ? c.at(query) : c.path(query);
+					if(!c.valid()) continue;
+					c.raw(s, len);
+				}
+				++matched;
+				if(!quiet) fwrite(s, 1, len, stdout), fputc('\n', stdout);
+			}
+			catch(std::exception&) {
+				++bad;
+			}
+		}
+		cost += clock() - start;
+	}
+	const double sec = (double)cost / CLOCKS_PER_SEC;
+	fprintf(stderr, "%lu lines, %lu matched, %lu bad, %.3fs, %.1f MB/s\n",
+		(unsigned long)lines, (unsigned long)matched, (unsigned long)bad, sec, sec > 0 ? bytes / 1048576.0 / sec : 0.0);
+	return 0;
+}
@@ -3,6 +3,7 @@
 #include "gtest/gtest.h"
 
 #include <iostream>
+#include <sstream>
 #include <climits>
 #include "../xpjson.hpp"
 using namespace std;
@@ -209,6 +210,12 @@ TEST(ut_xpjson, read)
 		{
 			in = "\r\n\t {\t\n \"a\" \r:\n \"b\" \n\r\t}";
 			ASSERT_TRUE(JSON::Reader::read(v, in.c_str(), in.length()) == in.length());
+
+			// runs longer than a SIMD block
+			in = "{\n\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\"a\"\r\n                                  :\n                 [ \r\n\t 1 ,                      null\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n ]\r\n\r\n\r\n\r\n\r\n\r\n\r\n\r\n\r\n}";
+			ASSERT_TRUE(JSON::Reader::read(v, in.c_str(), in.length()) == in.length());
+			ASSERT_TRUE(v["a"].a().size() == 2);
+			ASSERT_TRUE(v["a"].a().size() == 2);
 		}
 
 		// case 8 duplicate key
@@ -222,6 +229,13 @@ TEST(ut_xpjson, read)
 
 			ASSERT_TRUE(o1["a"].type() == JSON::INTEGER);
 			ASSERT_TRUE(o1["a"].i() == 1);
+
+			// the later value replaces a former container
+			in = "{\"a\":[1,2],\"a\":{\"b\":3},\"a\":[4]}";
+			ASSERT_TRUE(JSON::Reader::read(v, in.c_str(), in.length()) == in.length());
+			ASSERT_TRUE(v.o().size() == 1);
+			ASSERT_TRUE(v["a"].a().size() == 1);
+			ASSERT_TRUE(v["a"][0].i() == 4);
 		}
 
 		// case 9 nested object
@@ -242,6 +256,20 @@ TEST(ut_xpjson, read)
 		ASSERT_TRUE(JSON::Reader::read(v, in.c_str(), in.length()) == in.length());
 		ASSERT_TRUE(v["aa\b\""].s() == "b");
 
+		// case 12 nesting as deep as __XPJSON_MAX_DEPTH__
+		{
+			string arrays(__XPJSON_MAX_DEPTH__, '['), objects;
+			arrays.append(__XPJSON_MAX_DEPTH__, ']');
+			for(int i = 0; i < __XPJSON_MAX_DEPTH__; ++i) objects += "{\"a\":";
+			objects += "{}";
+			objects.append(__XPJSON_MAX_DEPTH__, '}');
+			ASSERT_TRUE(JSON::Reader::read(v, arrays.c_str(), arrays.length()) == arrays.length());
+			EXPECT_THROW(JSON::Reader::read(v, objects.c_str(), objects.length()), std::logic_error);
+			objects.erase(0, 5);
+			objects.erase(objects.length() - 1);
+			ASSERT_TRUE(JSON::Reader::read(v, objects.c_str(), objects.length()) == objects.length());
+		}
+
 		// exception cases
 		// case 1 bracket not match
 		in = "{\"a\":\"b\"";
@@ -304,7 +332,11 @@ TEST(ut_xpjson, read)
 		in = "{\"a\\";
 		EXPECT_THROW(JSON::Reader::read(v, in.c_str(), in.length()), std::logic_error);
 
-		// case 10 bad cow case when hit sso(1/5/9/13 bytes)
+		// case 10 nesting deeper than __XPJSON_MAX_DEPTH__
+		in.assign(__XPJSON_MAX_DEPTH__ + 1, '[');
+		EXPECT_THROW(JSON::Reader::read(v, in.c_str(), in.length()), std::logic_error);
+
+		// case 11 bad cow case when hit sso(1/5/9/13 bytes)
 		JSON::Value v2("yyyyy");
 		v = v2; // incorrect treat as cow when cow(sso_len highest bit) is true
 		*const_cast<char*>(v2.c_str()) = 'z';
@@ -1231,6 +1263,21 @@ TEST(ut_xpjson, read_string)
 		ASSERT_TRUE(v.read_string("\"abc\" {} []", 11) == 5);
 		ASSERT_TRUE(v.s() == "abc");
 
+		// case 6 long string, escape and quote at each offset of SIMD blocks
+		for(size_t i = 0; i < 70; ++i) {
+			in = '\"' + string(i, 'a') + "\\/" + string(70 - i, 'b') + '\"';
+			ASSERT_TRUE(v.read_string(in.c_str(), in.length()) == in.length());
+			ASSERT_TRUE(v.s() == string(i, 'a') + '/' + string(70 - i, 'b'));
+			in = '\"' + string(i, 'a') + '\"' + string(70, 'c');
+			ASSERT_TRUE(v.read_string(in.c_str(), in.length(), true) == i + 2);
+			ASSERT_TRUE(v.s() == string(i, 'a'));
+		}
+
+		// case 7 plain runs between escapes and unicode escapes
+		in = "\"plain run \\u4e2d\\u6587\\n\\u00e9 tail\\ud83d\\ude00\"";
+		ASSERT_TRUE(v.read_string(in.c_str(), in.length()) == in.length());
+		ASSERT_TRUE(v.s() == "plain run \xE4\xB8\xAD\xE6\x96\x87\n\xC3\xA9 tail\xF0\x9F\x98\x80");
+
 		// 2. exception cases
 		// case 1 no left double quotation
 		EXPECT_THROW(v.read_string("abc", 3), std::logic_error);
@@ -1280,6 +1327,14 @@ TEST(ut_xpjson, read_number)
 		ASSERT_TRUE(v.i() == -12345);
 		ASSERT_TRUE(v.read_number("-12345]", 7) == 6);
 		ASSERT_TRUE(v.i() == -12345);
+		ASSERT_TRUE(v.read_number("12345678", 8) == 8);
+		ASSERT_TRUE(v.i() == 12345678);
+		ASSERT_TRUE(v.read_number("1234567890123456,", 17) == 16);
+		ASSERT_TRUE(v.i() == 1234567890123456LL);
+		ASSERT_TRUE(v.read_number("-123456789012345678]", 20) == 19);
+		ASSERT_TRUE(v.i() == -123456789012345678LL);
+		ASSERT_TRUE(v.read_number("1567000000123.25", 16) == 16);
+		ASSERT_TRUE(v.f() == 1567000000123.25);
 
 		// case 3 integer number limits
 		ASSERT_TRUE(v.read_number("2147483647", 10) == 10);
@@ -1319,19 +1374,41 @@ TEST(ut_xpjson, read_number)
 		ASSERT_TRUE(v.read_number("9223372036854775808.0", 21) == 21);
 		ASSERT_TRUE(v.f() == 9.2233720368547758e+18);
 		ASSERT_TRUE(v.read_number("7205759403792793199999e-5", 25) == 25);
-		ASSERT_TRUE(v.f() == 72057594037927936);
+		ASSERT_TRUE(v.f() == 72057594037927928);
 		ASSERT_TRUE(v.read_number("7205759403792793200001e-5", 25) == 25);
 		ASSERT_TRUE(v.f() == 72057594037927936);
 		ASSERT_TRUE(v.read_number("1.725073858507201136057409796709131975934819546351645648023426109724822222021076945516529523908135087914149158913039621106870086438694594645527657207407820621743379988141063267329253552286881372149012981122451451889849057222307285255133155755015914397476397983411801999323962548289017107081850690630666655994938275772572015763062690663332647565300009245888316433037779791869612049497390377829704905051080609940730262937128958950003583799967207254304360284078895771796150945516748243471030702609144621572289880258182545180325707018860872113128079512233426288368622321503775666622503982534335974568884423900265498198385487948292206894721689831099698365846814022854243330660339850886445804001034933970427567186443383770486037861622771738545623065874679014086723327636718751234567890123456789012345678901e-290", 805) == 805);
-		ASSERT_TRUE(v.f() == 1.7250738585072009e-290);
+		ASSERT_TRUE(v.f() == 1.7250738585072012e-290);
 		ASSERT_TRUE(v.read_number("1014120480182583464902367222169599999e-5", 40) == 40);
 		ASSERT_TRUE(v.f() == 1.0141204801825834e+31);
 		ASSERT_TRUE(v.read_number("1014120480182583464902367222169600001e-5", 40) == 40);
-		ASSERT_TRUE(v.f() == 1.0141204801825834e+31);
+		ASSERT_TRUE(v.f() == 1.0141204801825835e+31);
 		ASSERT_TRUE(v.read_number("5708990770823839207320493820740630171355185151999e-3", 52) == 52);
 		ASSERT_TRUE(v.f() == 5.7089907708238389e+45);
 		ASSERT_TRUE(v.read_number("5708990770823839207320493820740630171355185152001e-3", 52) == 52);
-		ASSERT_TRUE(v.f() == 5.7089907708238389e+45);
+		ASSERT_TRUE(v.f() == 5.7089907708238395e+45);
+
+		// case 7 correctly rounded, out of range exponents
+		ASSERT_TRUE(v.read_number("0.1", 3) == 3);
+		ASSERT_TRUE(v.f() == 0.1);
+		ASSERT_TRUE(v.read_number("123456.789e-3", 13) == 13);
+		ASSERT_TRUE(v.f() == 123.456789);
+		ASSERT_TRUE(v.read_number("2.2250738585072011e-308", 23) == 23);
+		ASSERT_TRUE(v.f() == 2.2250738585072011e-308);
+		ASSERT_TRUE(v.read_number("4.9406564584124654e-324", 23) == 23);
+		ASSERT_TRUE(v.f() == 4.9406564584124654e-324);
+		ASSERT_TRUE(v.read_number("1.7976931348623157e308", 22) == 22);
+		ASSERT_TRUE(v.f() == DBL_MAX);
+		ASSERT_TRUE(v.read_number("0.0000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000001e520", 226) == 226);
+		ASSERT_TRUE(v.f() == 1e300);
+		ASSERT_TRUE(v.read_number("1000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000e-520", 225) == 225);
+		ASSERT_TRUE(v.f() == 1e-301);
+		ASSERT_TRUE(v.read_number("1e600", 5) == 5);
+		ASSERT_TRUE(v.f() == HUGE_VAL);
+		ASSERT_TRUE(v.read_number("-1e-600", 7) == 7);
+		ASSERT_TRUE(v.f() == 0);
+		ASSERT_TRUE(v.read_number("1e99999999999999999999", 22) == 22);
+		ASSERT_TRUE(v.f() == HUGE_VAL);
 
 		// 2. exception cases
 		// case 1 unexcept endings after integer number
@@ -1342,6 +1419,8 @@ TEST(ut_xpjson, read_number)
 		EXPECT_THROW(v.read_number("-0.1ea", 6), std::logic_error);
 		EXPECT_THROW(v.read_number("-0.1e+a", 7), std::logic_error);
 		EXPECT_THROW(v.read_number("-0.1e+1a", 8), std::logic_error);
+		EXPECT_THROW(v.read_number("1234567a90", 10), std::logic_error);
+		EXPECT_THROW(v.read_number("0.1234567/9", 11), std::logic_error);
 
 		// case 2 unexpect zero-leading
 		EXPECT_THROW(v.read_number("00", 2), std::logic_error);
@@ -1523,3 +1602,981 @@ TEST(ut_xpjson, zh_cn)
 		ASSERT_TRUE(false);
 	}
 }
+
+TEST(ut_xpjson, incremental_reader)
+{
+	try {
+		// normal cases
+		// case 1 same as read, split at every offset
+		const char* cases[] = {
+			"[null,2147483647,68719476735,1.3e-12,true,false,\"test\\\"\\\\\\/\\b\\f\\n\\r\\t\",\"test\"]",
+			"  \r\n\t{\"ver\":123,\r\n \"o\":\tnull,\"flag\":true,\"data\":[[0,0.1,1.3e2]\r\n]\t  }",
+			"{}", "[]", "[[[[]]]]", "[{}]",
+			"{\"aa\\b\\\"\":\"b\",\"a\":{\"a\":1},\"a\":[1 , 2 ]}",
+			"[\"\\u4e2d\\u6587\",\"\\\\\",-0.5e-3]"
+		};
+		JSON::Value v, v2;
+		for(size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i) {
+			string in(cases[i]);
+			ASSERT_TRUE(JSON::Reader::read(v2, in) == in.length());
+			for(size_t split = 0; split < in.length(); ++split) {
+				JSON::IncrementalReader r(v);
+				ASSERT_TRUE(r.feed(in.data(), split) == JSON::IncrementalReader::NEED_MORE);
+				ASSERT_TRUE(r.consumed() == split);
+				ASSERT_TRUE(r.feed(in.data() + split, in.length() - split) == JSON::IncrementalReader::DONE);
+				ASSERT_TRUE(r.consumed() == in.length() - split);
+				ASSERT_TRUE(v == v2);
+			}
+		}
+
+		// case 2 one char a time, chars after document are left
+		string in("{\"a\\nb\":[\"x\\\"y\",12345678901,true,null,{}]} [1]");
+		JSON::IncrementalReader r(v);
+		size_t pos = 0;
+		while(r.feed(in.data() + pos, 1) == JSON::IncrementalReader::NEED_MORE) ++pos;
+		ASSERT_TRUE(r.done() && r.consumed() == 1);
+		ASSERT_TRUE(pos + 1 == in.find(' ', in.find('}', 40)));
+		ASSERT_TRUE(v["a\nb"][0].s() == "x\"y");
+		ASSERT_TRUE(v["a\nb"][1].i() == 12345678901LL);
+
+		// case 3 reset for next document
+		r.reset(v);
+		ASSERT_TRUE(r.feed(in.substr(pos + 1)) == JSON::IncrementalReader::DONE);
+		ASSERT_TRUE(r.consumed() == 4);
+		ASSERT_TRUE(v[0].i() == 1);
+
+		// exception cases
+		const char* bad_cases[] = {
+			"\"a\":\"b\"", "abcd", "{\"a\":]}", "{\"a\" \n\r\t a}",
+			"[a]", "[123,a]", "[1 2]", "[1 \"a\"]", "[\"a\",\"b\"a",
+			"[truex]", "[nul]", "[\"a\"}", "{\"a\":1]", "[1.]", "[-]"
+		};
+		for(size_t i = 0; i < sizeof(bad_cases) / sizeof(bad_cases[0]); ++i) {
+			in = bad_cases[i];
+			r.reset(v);
+			EXPECT_THROW(r.feed(in), std::logic_error);
+		}
+		// feed after done
+		r.reset(v);
+		ASSERT_TRUE(r.feed("[]", 2) == JSON::IncrementalReader::DONE);
+		EXPECT_THROW(r.feed("[]", 2), std::logic_error);
+	}
+	catch(std::exception &e) {
+		printf("Error : %s.", e.what());
+		ASSERT_TRUE(false);
+	}
+}
+
+TEST(ut_xpjson, readv)
+{
+	try {
+		// normal cases
+		// case 1 same as read, split to 3 segments at every offset
+		string in("{\"ver\":123,\"name\":\"cow string\",\"esc\":\"a\\tb\",\"data\":[0,0.1,1.3e2,null]} ");
+		JSON::Value v, v2;
+		ASSERT_TRUE(JSON::Reader::read(v2, in) == in.length() - 1);
+		for(size_t i = 0; i < in.length(); ++i) {
+			for(size_t j = i; j < in.length(); ++j) {
+				struct iovec iov[3] = {{(void*)in.data(), i}, {(void*)(in.data() + i), j - i}, {(void*)(in.data() + j), in.length() - j}};
+				ASSERT_TRUE(JSON::Reader::readv(v, iov, 3, true) == in.length() - 1);
+				ASSERT_TRUE(v == v2);
+				// cow only if string and its closing quote are in one segment
+				size_t begin = in.find("cow"), quote = begin + 10;
+				bool inside = quote < i || (begin >= i && quote < j) || begin >= j;
+				ASSERT_TRUE((v["name"].c_str() == in.data() + begin) == inside);
+			}
+		}
+
+		// case 2 document ends before last segment
+		struct iovec iov[3] = {{(void*)"[1,", 3}, {(void*)"2]  ", 4}, {(void*)"[3]", 3}};
+		ASSERT_TRUE(JSON::Reader::readv(v, iov, 3) == 5);
+		ASSERT_TRUE(v.a().size() == 2 && v[1].i() == 2);
+
+		// exception cases
+		// case 1 document not finished
+		EXPECT_THROW(JSON::Reader::readv(v, iov, 1), std::logic_error);
+		// case 2 bad segments
+		iov[1].iov_base = (void*)"2,]";
+		EXPECT_THROW(JSON::Reader::readv(v, iov, 3), std::logic_error);
+	}
+	catch(std::exception &e) {
+		printf("Error : %s.", e.what());
+		ASSERT_TRUE(false);
+	}
+}
+
+// logs events as text, stops at the stop-th event
+struct sax_log_handler
+{
+	string log;
+	int count, stop;
+	sax_log_handler(int s = -1) : count(0), stop(s) {}
+	bool next(const string& event) {log += event; log += ','; return ++count != stop;}
+	bool on_null() {return next("null");}
+	bool on_boolean(bool b) {return next(b ? "true" : "false");}
+	bool on_int(int64_t i) {char buf[32]; sprintf(buf, "i:%lld", (long long)i); return next(buf);}
+	bool on_double(double f) {char buf[32]; sprintf(buf, "f:%g", f); return next(buf);}
+	bool on_string(const char* s, size_t len) {return next("s:" + string(s, len));}
+	bool on_key(const char* s, size_t len) {return next("k:" + string(s, len));}
+	bool on_object_begin() {return next("{");}
+	bool on_object_end() {return next("}");}
+	bool on_array_begin() {return next("[");}
+	bool on_array_end() {return next("]");}
+};
+
+// keeps pointer of the last string
+struct sax_ptr_handler : sax_log_handler
+{
+	const char* p;
+	bool on_string(const char* s, size_t) {p = s; return true;}
+};
+
+TEST(ut_xpjson, sax_parse)
+{
+	try {
+		// normal cases
+		// case 1 events in document order, duplicate keys kept
+		string in(" {\"b\":[null,true,false,-12,1.5e2,\"x\\ty\",{},[]],\"a\":{\"k\\u4e2d\":\"v\"},\"a\":\"plain\"} ");
+		sax_log_handler h;
+		ASSERT_TRUE(JSON::Reader::parse(h, in) == in.length() - 1);
+		ASSERT_TRUE(h.log == "{,k:b,[,null,true,false,i:-12,f:150,s:x\ty,{,},[,],],k:a,{,k:k\xe4\xb8\xad,s:v,},k:a,s:plain,},");
+
+		// case 2 plain string points into input
+		sax_ptr_handler ph;
+		ASSERT_TRUE(JSON::Reader::parse(ph, in) == in.length() - 1);
+		ASSERT_TRUE(ph.p == in.data() + in.find("plain"));
+
+		// case 3 stop at any event
+		for(int i = 1; i <= 22; ++i) {
+			sax_log_handler stop(i);
+			size_t pos = JSON::Reader::parse(stop, in);
+			ASSERT_TRUE(stop.count == i);
+			ASSERT_TRUE(h.log.compare(0, stop.log.length(), stop.log) == 0);
+			ASSERT_TRUE(pos <= in.length() - 1);
+		}
+		sax_log_handler stop(4);
+		ASSERT_TRUE(JSON::Reader::parse(stop, in) == in.find("null") + 4);
+
+		// case 4 same nesting limit as read
+		string deep(__XPJSON_MAX_DEPTH__, '[');
+		deep.append(__XPJSON_MAX_DEPTH__, ']');
+		sax_log_handler dh;
+		ASSERT_TRUE(JSON::Reader::parse(dh, deep) == deep.length());
+
+		// exception cases
+		const char* bad_cases[] = {
+			"", "  ", "\"a\":\"b\"", "abcd", "{\"a\":]}", "{\"a\" \n\r\t a}", "[a]", "[123,a]",
+			"[1 2]", "[\"a\",\"b\"a", "[truex]", "[nul]", "[\"a\"}", "{\"a\":1]", "[1.]", "[\"\\x\"]", "[1,2"
+		};
+		for(size_t i = 0; i < sizeof(bad_cases) / sizeof(bad_cases[0]); ++i) {
+			sax_log_handler bh;
+			EXPECT_THROW(JSON::Reader::parse(bh, bad_cases[i]), std::logic_error);
+		}
+		deep.insert(0, "[");
+		deep.append("]");
+		EXPECT_THROW(JSON::Reader::parse(dh, deep), std::logic_error);
+	}
+	catch(std::exception &e) {
+		printf("Error : %s.", e.what());
+		ASSERT_TRUE(false);
+	}
+}
+
+TEST(ut_xpjson, cursor)
+{
+	try {
+		// normal cases
+		string in(" {\"skip\":{\"a\":[1,{\"]\":\"}\\\"]\"}],\"b\":\"\\\\\"},\"media\":{\"bitrate\":262144,\"ratio\":1.5,"
+				  "\"title\":\"Javaone\",\"esc\":\"a\\tb\",\"live\":false,\"copyright\":null,\"persons\":[\"Bill\",{\"x\":[]},3]},"
+				  "\"e\\u0078\":[],\"media\":0} ");
+		JSON::Cursor c(in);
+		// case 1 find fields, the first one wins
+		ASSERT_TRUE(c.type() == JSON::OBJECT);
+		JSON::Cursor media = c.find_field("media");
+		ASSERT_TRUE(media.valid() && media.type() == JSON::OBJECT);
+		ASSERT_TRUE(media["bitrate"].type() == JSON::INTEGER);
+		ASSERT_TRUE(media["bitrate"].i() == 262144);
+		ASSERT_TRUE(media["ratio"].type() == JSON::FLOAT);
+		ASSERT_TRUE(media["ratio"].f() == 1.5);
+		ASSERT_TRUE(media["live"].b() == false);
+		ASSERT_TRUE(media["copyright"].is_null());
+		ASSERT_TRUE(c["ex"].type() == JSON::ARRAY);
+		// case 2 missing fields are chained
+		ASSERT_FALSE(c["none"].valid());
+		ASSERT_FALSE(c["none"]["bitrate"].valid());
+		ASSERT_FALSE(c["skip"]["x"]["c"].valid());
+		ASSERT_FALSE(JSON::Cursor("{ }")["a"].valid());
+		ASSERT_FALSE(JSON::Cursor(" ")["a"].valid());
+		// case 3 string views
+		const char* s = NULL;
+		size_t len = 0;
+		ASSERT_TRUE(media["title"].view(s, len));
+		ASSERT_TRUE(s == in.data() + in.find("Javaone") && len == 7);
+		ASSERT_FALSE(media["esc"].view(s, len));
+		ASSERT_TRUE(string(s, len) == "a\\tb");
+		ASSERT_TRUE(media["esc"].s() == "a\tb");
+		// slashes and non-ASCII chars are not escapes
+		const string plain("{\"uri\":\"http://a.com/x\",\"name\":\"caf\u00e9\"}");
+		JSON::Cursor u(plain);
+		ASSERT_TRUE(u["uri"].view(s, len) && string(s, len) == "http://a.com/x");
+		ASSERT_TRUE(u["name"].view(s, len) && s == plain.data() + plain.find("caf"));
+		ASSERT_TRUE(c["skip"]["b"].s() == "\\");
+		// case 4 iterate array
+		JSON::Cursor e = media["persons"].begin();
+		ASSERT_TRUE(e.s() == "Bill");
+		e = e.next();
+		ASSERT_FALSE(e["x"].begin().valid());
+		e = e.next();
+		ASSERT_TRUE(e.i() == 3);
+		ASSERT_FALSE(e.next().valid());
+		ASSERT_FALSE(c["ex"].begin().valid());
+		// case 5 read subtree same as read
+		JSON::Value v, v2;
+		ASSERT_TRUE(media.read(v) == in.find(",\"e\\u") - in.find("{\"bitrate"));
+		JSON::Reader::read(v2, in);
+		ASSERT_TRUE(v["bitrate"].i() == 262144 && v["persons"].a().size() == 3);
+		ASSERT_TRUE(c["skip"].read(v) > 0 && v == v2["skip"]);
+		ASSERT_TRUE(media["title"].read(v) == 9 && v.s() == "Javaone");
+
+		// exception cases
+		// case 1 type mismatch
+		EXPECT_THROW(c.begin(), std::logic_error);
+		EXPECT_THROW(media["persons"]["a"], std::logic_error);
+		EXPECT_THROW(media["bitrate"].f(), std::logic_error);
+		EXPECT_THROW(media["ratio"].i(), std::logic_error);
+		EXPECT_THROW(media["title"].i(), std::logic_error);
+		EXPECT_THROW(media["bitrate"].view(s, len), std::logic_error);
+		// case 2 invalid cursor
+		EXPECT_THROW(c["none"].i(), std::logic_error);
+		EXPECT_THROW(c["none"].begin(), std::logic_error);
+		// case 3 bad document on the way
+		const char* bad_cases[] = {"{\"a\" 1}", "{\"a\":1 \"media\":2}", "{a:1}", "{\"a\":1,}", "{\"a\":[1,2}", "{\"media\""};
+		for(size_t i = 0; i < sizeof(bad_cases) / sizeof(bad_cases[0]); ++i) {
+			EXPECT_THROW(JSON::Cursor(bad_cases[i]).find_field("media"), std::logic_error);
+		}
+		EXPECT_THROW(JSON::Cursor("[1 2]").begin().next(), std::logic_error);
+		EXPECT_THROW(JSON::Cursor("[1,").begin().next(), std::logic_error);
+		EXPECT_THROW(JSON::Cursor("{\"a\":tru}")["a"].b(), std::logic_error);
+	}
+	catch(std::exception &e) {
+		printf("Error : %s.", e.what());
+		ASSERT_TRUE(false);
+	}
+}
+
+TEST(ut_xpjson, read_lazy)
+{
+	try {
+		// normal cases
+		string in(" {\"header\":{\"id\":1,\"tags\":[\"a\",\"b\"]},\"body\":[ {\"k\" : \"v\\n\"}, [1, 2.5, null] ],\"n\":3} ");
+		JSON::Value v, v2;
+		ASSERT_TRUE(JSON::Reader::read(v2, in) == in.length() - 1);
+		// case 1 nested values are raw spans, written verbatim
+		ASSERT_TRUE(v.read_lazy(in) == in.length() - 1);
+		ASSERT_TRUE(v["n"].i() == 3);
+		ASSERT_TRUE(v.o().find("body")->second.lazy());
+		string out;
+		v.write(out);
+		ASSERT_TRUE(out == "{\"body\":[ {\"k\" : \"v\\n\"}, [1, 2.5, null] ],\"header\":{\"id\":1,\"tags\":[\"a\",\"b\"]},\"n\":3}");
+		// case 2 parsed level by level on first access
+		ASSERT_TRUE(v["header"]["id"].i() == 1);
+		ASSERT_FALSE(v["header"].lazy());
+		ASSERT_TRUE(v["header"]["tags"].lazy());
+		ASSERT_TRUE(v["header"]["tags"][1].s() == "b");
+		const JSON::Value& body = v["body"];
+		ASSERT_TRUE(body.a().size() == 2 && body.a()[0].lazy());
+		ASSERT_TRUE(body.a()[0].o().find("k")->second.s() == "v\n");
+		ASSERT_TRUE(v == v2);
+		out.clear();
+		v.write(out);
+		string out2;
+		v2.write(out2);
+		ASSERT_TRUE(out == out2);
+		// case 3 copy shares span, deeper depth
+		ASSERT_TRUE(v.read_lazy(in.data(), in.length(), 2) == in.length() - 1);
+		ASSERT_FALSE(v["body"].lazy());
+		ASSERT_TRUE(v["body"][1].lazy());
+		JSON::Value c(v["body"][1]);
+		ASSERT_TRUE(c.lazy());
+		c = v["body"][0];
+		ASSERT_TRUE(c.lazy() && c["k"].s() == "v\n");
+		ASSERT_TRUE(v["body"][0].lazy());
+		v["body"][1] = 1;
+		ASSERT_TRUE(v["body"][1].i() == 1);
+		v["body"][0].clear(JSON::OBJECT);
+		ASSERT_TRUE(!v["body"][0].lazy() && v["body"][0].o().empty());
+		// case 4 cow strings in spans
+		ASSERT_TRUE(v.read_lazy(in, 1, true) == in.length() - 1);
+		ASSERT_TRUE(v["header"]["tags"][0].c_str() == in.data() + in.find("a\""));
+
+		// exception cases
+		// case 1 mismatched or unclosed brackets
+		const char* bad_cases[] = {"{\"a\":[1}", "{\"a\":{1]}", "{\"a\":[[]", "[[\"]\"]"};
+		for(size_t i = 0; i < sizeof(bad_cases) / sizeof(bad_cases[0]); ++i) {
+			EXPECT_THROW(v.read_lazy(bad_cases[i]), std::logic_error);
+		}
+		// case 2 malformed span throws on access
+		in = "{\"a\":[1 2]}";
+		ASSERT_TRUE(v.read_lazy(in) == 11);
+		EXPECT_THROW(v["a"][0], std::logic_error);
+		// kept raw, same error again and written verbatim
+		ASSERT_TRUE(v["a"].lazy());
+		EXPECT_THROW(v["a"].a(), std::logic_error);
+		out.clear();
+		v.write(out);
+		ASSERT_TRUE(out == "{\"a\":[1 2]}");
+	}
+	catch(std::exception &e) {
+		printf("Error : %s.", e.what());
+		ASSERT_TRUE(false);
+	}
+}
+
+TEST(ut_xpjson, read_projected)
+{
+	try {
+		// normal cases
+		string in("{\"images\":[{\"height\":768,\"title\":\"Keynote\",\"width\":1024},{\"height\":240,\"width\":320},7],"
+				  "\"media\":{\"bitrate\":262144,\"uri\":\"http:\\/\\/javaone.com\\/keynote.mpg\",\"persons\":[\"Bill\",\"Steve\"]},"
+				  "\"a/b\":{\"~\":1},\"e\\u0078\":true,\"tail\":[1,2,3]}");
+		JSON::Value v, v2;
+		JSON::Reader::read(v2, in);
+		// case 1 selected paths only
+		JSON::FieldMask mask;
+		mask.add("/media/uri").add("/images/*/width").add("/a~1b/~0").add("/ex");
+		ASSERT_TRUE(JSON::Reader::read(v, in, mask) == in.length());
+		string out;
+		v.write(out);
+		// scalar 7 has no width
+		ASSERT_TRUE(out == "{\"a\\/b\":{\"~\":1},\"ex\":true,\"images\":[{\"width\":1024},{\"width\":320}],\"media\":{\"uri\":\"http:\\/\\/javaone.com\\/keynote.mpg\"}}");
+		// case 2 whole subtree and index, elements before index are null
+		mask = JSON::FieldMask();
+		mask.add("/media/persons").add("/images/1/height").add("/tail/1").add("/none/x");
+		ASSERT_TRUE(v.read(in, mask) == in.length());
+		ASSERT_TRUE(v["media"]["persons"] == v2["media"]["persons"]);
+		ASSERT_TRUE(v["images"][0].type() == JSON::NIL);
+		ASSERT_TRUE(v["images"][1]["height"].i() == 240 && v["images"][1].o().size() == 1);
+		ASSERT_TRUE(v["tail"].a().size() == 2 && v["tail"][1].i() == 2);
+		ASSERT_TRUE(v.o().size() == 3);
+		// case 3 whole document
+		mask = JSON::FieldMask();
+		mask.add("");
+		ASSERT_TRUE(v.read(in, mask) == in.length() && v == v2);
+		mask = JSON::FieldMask();
+		mask.add("/*");
+		ASSERT_TRUE(v.read(in, mask) == in.length() && v == v2);
+		// case 4 stop early
+		JSON::FieldMask early(true);
+		early.add("/images/0/width").add("/media/bitrate");
+		ASSERT_TRUE(v.read(in, early) == in.find(",\"uri\""));
+		ASSERT_TRUE(v["media"]["bitrate"].i() == 262144 && v["images"][0]["width"].i() == 1024);
+		// not stopped early with "*"
+		early.add("/tail/*");
+		ASSERT_TRUE(v.read(in, early) == in.length());
+		// case 5 skipped values are not validated
+		mask = JSON::FieldMask();
+		mask.add("/a");
+		ASSERT_TRUE(v.read("{\"b\":[1 2 x],\"a\":1}", mask) == 19 && v["a"].i() == 1);
+		// case 6 wildcard also matches where an exact key does, in any order of paths
+		string both("{\"media\":{\"uri\":\"u\",\"width\":640},\"images\":{\"width\":3}}");
+		JSON::FieldMask wild;
+		wild.add("/media/uri").add("/*/width");
+		ASSERT_TRUE(v.read(both, wild) == both.length());
+		out.clear();
+		v.write(out);
+		ASSERT_TRUE(out == "{\"images\":{\"width\":3},\"media\":{\"uri\":\"u\",\"width\":640}}");
+		wild = JSON::FieldMask();
+		wild.add("/*/width").add("/media/uri");
+		ASSERT_TRUE(v.read(both, wild) == both.length());
+		out.clear();
+		v.write(out);
+		ASSERT_TRUE(out == "{\"images\":{\"width\":3},\"media\":{\"uri\":\"u\",\"width\":640}}");
+		wild = JSON::FieldMask();
+		wild.add("/images/1/height").add("/images/*/width");
+		ASSERT_TRUE(v.read(in, wild) == in.length());
+		ASSERT_TRUE(v["images"][1]["height"].i() == 240 && v["images"][1]["width"].i() == 320 && v["images"][0].o().size() == 1);
+		// case 7 keys refer to in if cow, same as read
+		ASSERT_TRUE(v.read(in, wild, true) == in.length());
+		ASSERT_TRUE(v["images"][1].o().find("height")->first.data() == in.data() + in.find("height\":240"));
+		ASSERT_TRUE(v.read(in, wild) == in.length());
+		ASSERT_TRUE(v["images"][1].o().find("height")->first.data() != in.data() + in.find("height\":240"));
+		// case 8 selected subtree is as deep as __XPJSON_MAX_DEPTH__ from topmost
+		string deep("{\"a\":" + string(__XPJSON_MAX_DEPTH__ - 1, '[') + string(__XPJSON_MAX_DEPTH__ - 1, ']') + "}");
+		ASSERT_TRUE(v.read(deep, mask) == deep.length());
+		deep.insert(5, 1, '[').insert(deep.length() - 1, 1, ']');
+		EXPECT_THROW(v.read(deep, mask), std::logic_error);
+
+		// exception cases
+		// case 1 bad paths
+		EXPECT_THROW(mask.add("a"), std::logic_error);
+		EXPECT_THROW(mask.add("/a~2"), std::logic_error);
+		EXPECT_THROW(mask.add("/a~"), std::logic_error);
+		// case 2 bad documents
+		const char* bad_cases[] = {"", "1", "{\"a\" 1}", "{\"a\":1 \"b\":2}", "{\"b\":[1,2}", "{\"a\":[1}", "{\"a\":tru}", "{\"b\":}", "[\"a\""};
+		for(size_t i = 0; i < sizeof(bad_cases) / sizeof(bad_cases[0]); ++i) {
+			EXPECT_THROW(v.read(bad_cases[i], mask), std::logic_error);
+		}
+	}
+	catch(std::exception &e) {
+		printf("Error : %s.", e.what());
+		ASSERT_TRUE(false);
+	}
+}
+
+TEST(ut_xpjson, cursor_pointer)
+{
+	try {
+		// normal cases
+		string in("{\"tenant\":\"t1\",\"images\":[{\"width\":1024},{\"width\":320,\"ids\":[7,8]}],"
+				  "\"a/b\":{\"m~n\":1,\"\":2},\"e\\u0078\":true,\"0\":\"zero\",\"x.y\":3}");
+		JSON::Cursor c(in);
+		// case 1 JSON pointer
+		ASSERT_TRUE(c.at("/tenant").s() == "t1");
+		ASSERT_TRUE(c.at("/images/1/width").i() == 320);
+		ASSERT_TRUE(c.at("/images/1/ids/1").i() == 8);
+		ASSERT_TRUE(c.at("/a~1b/m~0n").i() == 1);
+		ASSERT_TRUE(c.at("/a~1b/").i() == 2);
+		ASSERT_TRUE(c.at("/ex").b());
+		ASSERT_TRUE(c.at("/0").s() == "zero");
+		ASSERT_TRUE(c.at("").type() == JSON::OBJECT);
+		ASSERT_TRUE(c.at(string("/images")).at("/0/width").i() == 1024);
+		// case 2 path expression
+		ASSERT_TRUE(c.path("images[1].ids[0]").i() == 7);
+		ASSERT_TRUE(c.path("a/b.m~n").i() == 1);
+		ASSERT_TRUE(c.path("images").path("[0].width").i() == 1024);
+		ASSERT_TRUE(JSON::Cursor("[[1,2],{\"k\":[3]}]").path("[1].k[0]").i() == 3);
+		// case 3 missing
+		const char* missing[] = {"/none", "/images/2", "/images/-", "/images/01", "/images/x", "/tenant/x", "/images/0/width/0", "/none/x/y"};
+		for(size_t i = 0; i < sizeof(missing) / sizeof(missing[0]); ++i) {
+			ASSERT_FALSE(c.at(missing[i]).valid());
+		}
+		ASSERT_FALSE(c.path("images[2].width").valid());
+		ASSERT_FALSE(c.path("tenant[0]").valid());
+		ASSERT_FALSE(c.path("x.y").valid());
+		// case 4 raw text
+		const char* s;
+		size_t len;
+		c.at("/images/1").raw(s, len);
+		ASSERT_TRUE(string(s, len) == "{\"width\":320,\"ids\":[7,8]}");
+		c.at("/tenant").raw(s, len);
+		ASSERT_TRUE(string(s, len) == "\"t1\"");
+		c.at("/images/1/width").raw(s, len);
+		ASSERT_TRUE(string(s, len) == "320");
+
+		// exception cases
+		// case 1 bad pointers and paths
+		EXPECT_THROW(c.at("tenant"), std::logic_error);
+		EXPECT_THROW(c.at("/a~2b"), std::logic_error);
+		EXPECT_THROW(c.at("/none/a~"), std::logic_error);
+		const char* bad_paths[] = {"images[", "images[x]", "images[01]", "images.", ".images", "images..width", "images[0]width"};
+		for(size_t i = 0; i < sizeof(bad_paths) / sizeof(bad_paths[0]); ++i) {
+			EXPECT_THROW(c.path(bad_paths[i]), std::logic_error);
+		}
+		EXPECT_THROW(JSON::Cursor("").at("").raw(s, len), std::logic_error);
+		// case 2 bad documents on the way
+		EXPECT_THROW(JSON::Cursor("{\"a\" 1}").at("/a"), std::logic_error);
+		EXPECT_THROW(JSON::Cursor("[1 2]").at("/1"), std::logic_error);
+	}
+	catch(std::exception &e) {
+		printf("Error : %s.", e.what());
+		ASSERT_TRUE(false);
+	}
+}
+
+TEST(ut_xpjson, read_lines)
+{
+	try {
+		// normal cases
+		// case 1 blank lines skipped, bad lines resynced at next newline
+		string in("{\"a\":1}\n\n  [2, 3]  \r\n{\"a\":\n{\"b\":\"x\"} 7\n\t\n[]\n{\"c\":tru}\n\"s\"\n{\"d\":[4]}");
+		vector<JSON::Value> out;
+		vector<size_t> bad;
+		ASSERT_TRUE(JSON::Reader::read_lines(out, in, &bad, 1) == 8 && out.size() == 8);
+		ASSERT_TRUE(out[0]["a"].i() == 1);
+		ASSERT_TRUE(out[1][1].i() == 3);
+		ASSERT_TRUE(out[4].type() == JSON::ARRAY && out[4].a().empty());
+		ASSERT_TRUE(out[7]["d"][0].i() == 4);
+		ASSERT_TRUE(bad.size() == 4 && bad[0] == 2 && bad[1] == 3 && bad[2] == 5 && bad[3] == 6);
+		for(size_t i = 0; i < bad.size(); ++i) {
+			ASSERT_TRUE(out[bad[i]].type() == JSON::NIL);
+		}
+		// case 2 empty input
+		ASSERT_TRUE(JSON::Reader::read_lines(out, string("\n \n")) == 0 && out.empty());
+		ASSERT_TRUE(JSON::Reader::read_lines(out, string()) == 0 && out.empty());
+		// case 3 threads keep input order
+		string big;
+		for(int i = 0; i < 6000; ++i) {
+			char line[64];
+			sprintf(line, i % 97 ? "{\"id\":%d,\"tags\":[\"t\",\"u\"]}\n" : "{\"id\":%d,\n", i);
+			big += line;
+		}
+		for(unsigned threads = 0; threads <= 4; ++threads) {
+			bad.clear();
+			ASSERT_TRUE(JSON::Reader::read_lines(out, big, &bad, threads, threads % 2) == 6000);
+			ASSERT_TRUE(bad.size() == 62);
+			for(size_t i = 0; i < out.size(); ++i) {
+				if(i % 97) ASSERT_TRUE(out[i]["id"].i() == (int64_t)i && out[i]["tags"][1].s() == "u");
+				else ASSERT_TRUE(out[i].type() == JSON::NIL && bad[i / 97] == i);
+			}
+		}
+		// case 4 SAX, handler stops the line only
+		sax_log_handler h(2);
+		bad.clear();
+		ASSERT_TRUE(JSON::Reader::parse_lines(h, "[1, 5]\n\n{\"a\":2}\n{\"a\"\n[3] x\n[null]", &bad) == 5);
+		ASSERT_TRUE(h.log == "[,i:1,{,k:a,i:2,},{,k:a,[,i:3,],[,null,],");
+		ASSERT_TRUE(bad.size() == 2 && bad[0] == 2 && bad[1] == 3);
+	}
+	catch(std::exception &e) {
+		printf("Error : %s.", e.what());
+		ASSERT_TRUE(false);
+	}
+}
+
+TEST(ut_xpjson, read_parallel)
+{
+	try {
+		// normal cases
+		// case 1 same as read, about 200KB for 3 threads
+		string in(" [");
+		for(int i = 0; i < 2400; ++i) {
+			char elem[128];
+			sprintf(elem, "%s{\"id\":%d,\"s\":\"a,]\\\"[\",\"f\":%d.5,\"a\":[[],{}]}, \"x\\u4e2d\", -%d, true, null, [[%d]]", i ? ",\n" : "", i, i, i, i);
+			in += elem;
+		}
+		in += " ] ";
+		JSON::Value v, v2;
+		const size_t ret = v2.read(in);
+		for(unsigned threads = 0; threads <= 5; ++threads) {
+			ASSERT_TRUE(v.read_parallel(in, threads, threads % 2) == ret);
+			ASSERT_TRUE(v == v2 && v.a().size() == 14400);
+		}
+		// case 2 small or other documents
+		ASSERT_TRUE(JSON::Reader::read_parallel(v, string("[]"), 4) == 2 && v.a().empty());
+		ASSERT_TRUE(JSON::Reader::read_parallel(v, string(" [1, 2]"), 4) == 7 && v[1].i() == 2);
+		ASSERT_TRUE(v.read_parallel(string("{\"a\":[1]}"), 4) == 9 && v["a"][0].i() == 1);
+		// case 3 depth limit of elements is the same
+		string deep(in.substr(0, in.length() - 3) + ",");
+		deep.append(__XPJSON_MAX_DEPTH__ - 1, '[');
+		deep.append(__XPJSON_MAX_DEPTH__ - 1, ']');
+		deep += "]";
+		ASSERT_TRUE(v.read_parallel(deep, 4) == deep.length() && v.a().size() == 14401);
+
+		// exception cases
+		// case 1 bad elements at the end or the beginning
+		const char* bad_cases[] = {"", "1 2", "truex", "1.5e", "{\"a\" 1}", "[}", "\"a", "tru", "[1,]", ":"};
+		for(size_t i = 0; i < sizeof(bad_cases) / sizeof(bad_cases[0]); ++i) {
+			string bad(in.substr(0, in.length() - 3) + "," + bad_cases[i] + "]");
+			EXPECT_THROW(v.read(bad), std::logic_error);
+			EXPECT_THROW(v.read_parallel(bad, 4), std::logic_error);
+			bad = "[" + string(bad_cases[i]) + "," + in.substr(2);
+			EXPECT_THROW(v.read(bad), std::logic_error);
+			EXPECT_THROW(v.read_parallel(bad, 4), std::logic_error);
+		}
+		// case 2 not closed
+		EXPECT_THROW(v.read_parallel(in.substr(0, in.length() - 3), 4), std::logic_error);
+		// case 3 too deep
+		deep = in.substr(0, in.length() - 3) + ",";
+		deep.append(__XPJSON_MAX_DEPTH__, '[');
+		deep.append(__XPJSON_MAX_DEPTH__, ']');
+		deep += "]";
+		EXPECT_THROW(v.read(deep), std::logic_error);
+		EXPECT_THROW(v.read_parallel(deep, 4), std::logic_error);
+	}
+	catch(std::exception &e) {
+		printf("Error : %s.", e.what());
+		ASSERT_TRUE(false);
+	}
+}
+
+TEST(ut_xpjson, read_insitu)
+{
+	try {
+		// normal cases
+		// case 1 escaped strings refer to input too
+		string in("{\"a\":\"x\\ty\\\"z\\/\",\"b\":[\"plain\",\"\\u4e2d\\ud83d\\ude00\\n\",\"\\\\\"],\"k\\u0065y\":\"\\u0041BCDEFGHIJKLMNOPQRSTUVWXYZ\"}");
+		const string copy(in);
+		JSON::Value v, v2;
+		v2.read(copy);
+		ASSERT_TRUE(v.read_insitu(in) == in.length());
+		ASSERT_TRUE(v == v2);
+		const char* begin = in.data();
+		const char* end = begin + in.length();
+		// s() of non-const value copies cow string, so check pointers first
+		ASSERT_TRUE(v["a"].c_str() >= begin && v["a"].c_str() < end && v["a"].s() == "x\ty\"z/");
+		ASSERT_TRUE(v["b"][1].c_str() >= begin && v["b"][1].c_str() < end && v["b"][1].s() == "\xe4\xb8\xad\xf0\x9f\x98\x80\n");
+		ASSERT_TRUE(v["b"][2].c_str() >= begin && v["b"][2].c_str() < end && v["b"][2].s() == "\\");
+		ASSERT_TRUE(v["b"][0].c_str() >= begin && v["b"][0].c_str() < end);
+		ASSERT_TRUE(v["key"].s() == "ABCDEFGHIJKLMNOPQRSTUVWXYZ");
+		// case 2 written escaped again
+		string out, out2;
+		v.write(out);
+		v2.write(out2);
+		ASSERT_TRUE(out == out2);
+		// case 3 raw buffer
+		char buf[] = "[\"\\n\", 1]";
+		ASSERT_TRUE(JSON::Reader::read_insitu(v, buf, sizeof(buf) - 1) == sizeof(buf) - 1);
+		ASSERT_TRUE(v[0].c_str() == buf + 2 && v[0].s() == "\n" && v[1].i() == 1);
+
+		// exception cases
+		const char* bad_cases[] = {"", "[\"\\x\"]", "[\"\\u12\"]", "[\"\\ud800\"]", "[\"a\\\"]", "{\"a\":\"\\q\"}"};
+		for(size_t i = 0; i < sizeof(bad_cases) / sizeof(bad_cases[0]); ++i) {
+			string bad(bad_cases[i]);
+			EXPECT_THROW(v.read_insitu(bad), std::logic_error);
+		}
+	}
+	catch(std::exception &e) {
+		printf("Error : %s.", e.what());
+		ASSERT_TRUE(false);
+	}
+}
+
+TEST(ut_xpjson, cow_keys)
+{
+	try {
+		// normal cases
+		// case 1 keys refer to input with cow, escaped ones are copied
+		const string in("{\"media\":{\"a_long_key_over_sso\":1,\"k\\u0065y\":2},\"b\":[{\"c\":true}]}");
+		JSON::Value v, v2;
+		ASSERT_TRUE(v.read(in, true) == in.length());
+		v2.read(in);
+		ASSERT_TRUE(v == v2);
+		const char* begin = in.data();
+		const char* end = begin + in.length();
+		JSON::Object::const_iterator it = v["media"].o().find("a_long_key_over_sso");
+		ASSERT_TRUE(it != v["media"].o().end() && it->first.cow() && it->first.data() >= begin && it->first.data() < end);
+		it = v["media"].o().find(string("key"));
+		ASSERT_TRUE(it != v["media"].o().end() && !it->first.cow() && it->first == "key" && it->second.i() == 2);
+		ASSERT_TRUE(v["b"][0].o().begin()->first.cow() && v["b"][0].o().count("c") == 1);
+		it = v2["media"].o().find("a_long_key_over_sso");
+		ASSERT_TRUE(!it->first.cow() && (it->first.data() < begin || it->first.data() >= end));
+		// case 2 works like STD string
+		const string key = v.o().begin()->first;
+		ASSERT_TRUE(key == "b" && v.o().begin()->first == key && v.o().begin()->first != "media");
+		ASSERT_TRUE(JSON::Key("ab") < JSON::Key("b") && JSON::Key("a") < JSON::Key("ab") && JSON::Key(string("a\0b", 3)).length() == 3);
+		// case 3 copy keeps cow keys, new keys are owned
+		JSON::Value v3(v);
+		ASSERT_TRUE(v3["media"].o().find("a_long_key_over_sso")->first.cow());
+		v3["media"]["new"] = 3;
+		ASSERT_TRUE(!v3["media"].o().find("new")->first.cow() && v3["media"].o().size() == 3);
+		string out, out2;
+		v.write(out);
+		v2.write(out2);
+		ASSERT_TRUE(out == out2);
+		// case 4 duplicate key keeps the first key and the last value
+		ASSERT_TRUE(v.read("{\"a\":1,\"\\u0061\":2}", true) && v.o().size() == 1 && v["a"].i() == 2);
+		// case 5 in-situ and incremental reads, key split by chunks is copied
+		string buf("{\"k\\u0065y\":1,\"plain\":2}");
+		ASSERT_TRUE(v.read_insitu(buf) == buf.length());
+		ASSERT_TRUE(v.o().find("key")->first.cow() && v.o().find("key")->first.data() == buf.data() + 2);
+		JSON::IncrementalReader r(v, true);
+		ASSERT_TRUE(r.feed(in.data(), 15) == JSON::IncrementalReader::NEED_MORE);
+		ASSERT_TRUE(r.feed(in.data() + 15, in.length() - 15) == JSON::IncrementalReader::DONE);
+		ASSERT_TRUE(v == v2 && !v["media"].o().begin()->first.cow() && v.o().find("b")->first.cow());
+	}
+	catch(std::exception &e) {
+		printf("Error : %s.", e.what());
+		ASSERT_TRUE(false);
+	}
+}
+
+TEST(ut_xpjson, read_file)
+{
+	const char* path = "ut_xpjson_read_file.json";
+	try {
+		// normal cases
+		// case 1 document refers to the mapping
+		const string in(" {\"media\":{\"title\":\"Javaone Keynote\",\"uri\":\"http:\\/\\/javaone.com\\/keynote.mpg\",\"width\":640},\"persons\":[\"Bill Gates\",\"Steve Jobs\"]}\n");
+		FILE* fp = fopen(path, "wb");
+		ASSERT_TRUE(fp && fwrite(in.data(), sizeof(char), in.length(), fp) == in.length());
+		fclose(fp);
+		JSON::Value v2;
+		const size_t ret = v2.read(in);
+		JSON::Document doc;
+		ASSERT_TRUE(JSON::Reader::read_file(doc, path) == ret && doc == v2);
+		ASSERT_TRUE(doc.o().begin()->first.cow() && doc["media"]["uri"].s() == "http://javaone.com/keynote.mpg");
+		// case 2 value is copied
+		JSON::Value v;
+		ASSERT_TRUE(JSON::Reader::read_file(v, path) == ret && v == v2 && !v.o().begin()->first.cow());
+		// case 3 read again and close
+		fp = fopen(path, "wb");
+		ASSERT_TRUE(fp && fwrite("[1,2]", sizeof(char), 5, fp) == 5);
+		fclose(fp);
+		ASSERT_TRUE(doc.read_file(path) == 5 && doc.a().size() == 2 && doc[1].i() == 2);
+		doc.close();
+		ASSERT_TRUE(doc.type() == JSON::NIL);
+
+		// exception cases
+		// case 1 bad content, document is closed
+		const char* bad_cases[] = {"", "[1,", "{\"a\":tru}", " 1"};
+		for(size_t i = 0; i < sizeof(bad_cases) / sizeof(bad_cases[0]); ++i) {
+			fp = fopen(path, "wb");
+			ASSERT_TRUE(fp);
+			fwrite(bad_cases[i], sizeof(char), strlen(bad_cases[i]), fp);
+			fclose(fp);
+			EXPECT_THROW(doc.read_file(path), std::logic_error);
+			ASSERT_TRUE(doc.type() == JSON::NIL);
+			EXPECT_THROW(JSON::Reader::read_file(v, path), std::logic_error);
+		}
+		// case 2 not a file
+		remove(path);
+		EXPECT_THROW(doc.read_file(path), std::logic_error);
+		EXPECT_THROW(JSON::Reader::read_file(v, "."), std::logic_error);
+	}
+	catch(std::exception &e) {
+		remove(path);
+		printf("Error : %s.", e.what());
+		ASSERT_TRUE(false);
+	}
+}
+
+TEST(ut_xpjson, read_stream)
+{
+	try {
+		// normal cases
+		// case 1 strings, numbers and literals split by blocks of any size
+		string in(" {\"k\\u0065y\":[\"x\\ty\\ud83d\\ude00\\\\\",-12.5e-1,true,null,false,\"");
+		in.append(300, 'z');
+		in += "\"],\"a\":{\"b\":[[],{}],\"\":12345678901234567890}} ";
+		JSON::Value v, v2;
+		const size_t ret = v2.read(in);
+		const size_t blocks[] = {1, 2, 3, 7, 64, 0x10000};
+		for(size_t i = 0; i < sizeof(blocks) / sizeof(blocks[0]); ++i) {
+			istringstream is(in);
+			ASSERT_TRUE(JSON::Reader::read_stream(v, is, blocks[i]) == ret && v == v2);
+		}
+		// case 2 FILE*
+		FILE* fp = tmpfile();
+		ASSERT_TRUE(fp && fwrite(in.data(), sizeof(char), in.length(), fp) == in.length());
+		rewind(fp);
+		ASSERT_TRUE(JSON::Reader::read_stream(v, fp, 5) == ret && v == v2);
+		fclose(fp);
+		// case 3 next document follows in the next block
+		istringstream is("[1]\n{\"a\":2}");
+		ASSERT_TRUE(JSON::Reader::read_stream(v, is, 4) == 3 && v[0].i() == 1);
+		ASSERT_TRUE(JSON::Reader::read_stream(v, is, 4) == 7 && v["a"].i() == 2);
+
+		// exception cases
+		const char* bad_cases[] = {"", "  ", "[1,", "[\"a", "{\"a\":tru}", "1", "[1}"};
+		for(size_t i = 0; i < sizeof(bad_cases) / sizeof(bad_cases[0]); ++i) {
+			istringstream bad(bad_cases[i]);
+			EXPECT_THROW(JSON::Reader::read_stream(v, bad, 2), std::logic_error);
+		}
+	}
+	catch(std::exception &e) {
+		printf("Error : %s.", e.what());
+		ASSERT_TRUE(false);
+	}
+}
+
+struct sax_stop_handler
+{
+	bool on_null() {return true;}
+	bool on_boolean(bool) {return true;}
+	bool on_int(int64_t i) {return i != 2;}
+	bool on_double(double) {return true;}
+	bool on_string(const char*, size_t) {return true;}
+	bool on_key(const char*, size_t) {return true;}
+	bool on_object_begin() {return true;}
+	bool on_object_end() {return true;}
+	bool on_array_begin() {return true;}
+	bool on_array_end() {return true;}
+};
+
+TEST(ut_xpjson, try_read)
+{
+	try {
+		// normal cases
+		// case 1 same as read
+		string in(" {\"k\\u0065y\":[\"x\\ty\",-12.5e-1,true,null,false],\"a\":{}} ");
+		JSON::Value v, v2;
+		JSON::ReadResult r = v.try_read(in);
+		ASSERT_TRUE(r.ok() && r.error == JSON::ERROR_NONE && r.offset == v2.read(in) && v == v2 && r.message().empty());
+		r = JSON::Reader::try_read(v, in.data(), in.length(), true);
+		ASSERT_TRUE(r.ok() && r.offset == in.length() - 1 && v == v2);
+		// case 2 SAX, stopped by handler is not an error
+		sax_stop_handler h;
+		r = JSON::Reader::try_parse(h, "[1,2,3]", 7);
+		ASSERT_TRUE(r.ok() && r.offset == 4);
+
+		// error cases, and where they are found
+		struct {const char* in; JSON::Error error; size_t offset;} bad_cases[] = {
+			{"  ", JSON::ERROR_END, 2},
+			{"[1,", JSON::ERROR_END, 3},
+			{"{\"a", JSON::ERROR_END, 3},
+			{"[\"a", JSON::ERROR_END, 3},
+			{"1", JSON::ERROR_SYNTAX, 0},
+			{"[1}", JSON::ERROR_SYNTAX, 2},
+			{"{\"a\" 1}", JSON::ERROR_SYNTAX, 5},
+			{"[1,tru]", JSON::ERROR_SYNTAX, 3},
+			{"[\"a\\x\"]", JSON::ERROR_STRING, 4},
+			{"{\"\\ud800\":1}", JSON::ERROR_STRING, 3},
+			{"[-]", JSON::ERROR_NUMBER, 2},
+			{"[1.e5]", JSON::ERROR_NUMBER, 3},
+			{"[01]", JSON::ERROR_NUMBER, 2},
+		};
+		for(size_t i = 0; i < sizeof(bad_cases) / sizeof(bad_cases[0]); ++i) {
+			in = bad_cases[i].in;
+			r = v.try_read(in);
+			EXPECT_TRUE(!r.ok() && r.error == bad_cases[i].error && r.offset == bad_cases[i].offset) << in;
+			EXPECT_TRUE(r.message().find(JSON::get_error_name(r.error)) != string::npos);
+			EXPECT_THROW(v.read(in), std::logic_error);
+			r = JSON::Reader::try_parse(h, in.data(), in.length());
+			EXPECT_TRUE(!r.ok() && r.error == bad_cases[i].error && r.offset == bad_cases[i].offset) << in;
+		}
+		// nested too deep
+		in = string(__XPJSON_MAX_DEPTH__ + 1, '[') + string(__XPJSON_MAX_DEPTH__ + 1, ']');
+		r = v.try_read(in);
+		ASSERT_TRUE(r.error == JSON::ERROR_DEPTH && r.offset == __XPJSON_MAX_DEPTH__);
+		ASSERT_TRUE(r.message().find("Too deep") != string::npos);
+	}
+	catch(std::exception &e) {
+		printf("Error : %s.", e.what());
+		ASSERT_TRUE(false);
+	}
+}
+
+TEST(ut_xpjson, validate)
+{
+	try {
+		// normal cases
+		// case 1 same as read
+		string in(" {\"k\\u0065y\":[\"x\\ty\\ud83d\\ude00\",-12.5e-1,true,null,false,[{}]],\"a\":{\"b\":0}} ");
+		JSON::Value v;
+		size_t depth = 0;
+		JSON::ReadResult r = JSON::Reader::validate(in, &depth);
+		ASSERT_TRUE(r.ok() && r.offset == v.read(in) && depth == 4);
+		// case 2 same errors as try_read
+		const char* bad_cases[] = {"", "[1,", "{\"a\":1", "[\"a\\", "1", "[1}", "{\"a\" 1}", "[1,tru]", "[\"\\x\"]", "[\"\\u12\"]", "[-]", "[1.]", "[1e+]", "[01]", "[1,]", "{\"a\":1,}"};
+		for(size_t i = 0; i < sizeof(bad_cases) / sizeof(bad_cases[0]); ++i) {
+			in = bad_cases[i];
+			r = JSON::Reader::validate(in);
+			JSON::ReadResult r2 = v.try_read(in);
+			EXPECT_TRUE(r.error == r2.error && r.offset == r2.offset) << in;
+#if !__XPJSON_SUPPORT_DANGLING_COMMA__
+			EXPECT_FALSE(r.ok()) << in;
+#endif
+		}
+		// case 3 depth limit
+		in = string(__XPJSON_MAX_DEPTH__, '[') + string(__XPJSON_MAX_DEPTH__, ']');
+		ASSERT_TRUE(JSON::Reader::validate(in, &depth).ok() && depth == __XPJSON_MAX_DEPTH__);
+		in = "[" + in + "]";
+		r = JSON::Reader::validate(in);
+		ASSERT_TRUE(r.error == JSON::ERROR_DEPTH && r.offset == __XPJSON_MAX_DEPTH__);
+	}
+	catch(std::exception &e) {
+		printf("Error : %s.", e.what());
+		ASSERT_TRUE(false);
+	}
+}
+
+TEST(ut_xpjson, read_limits)
+{
+	try {
+		// normal cases
+		// case 1 usage counted within budget
+		string in("{\"a\":[1,\"xy\",{}],\"b\":\"0123456789abcdefghij\"}");
+		JSON::Value v, v2;
+		JSON::ReadLimits limits(8, 16, 64, 1024 * 1024);
+		JSON::ReadResult r = v.try_read(in.data(), in.size(), limits);
+		v2.read(in);
+		ASSERT_TRUE(r.ok() && r.offset == in.size() && v == v2);
+		ASSERT_TRUE(limits.exceeded == JSON::LIMIT_NONE && limits.nodes == 6 && limits.string_bytes == 24 && limits.alloc_bytes > 0);
+		// case 2 zero means unlimited, usage reset on every read
+		JSON::ReadLimits unlimited;
+		ASSERT_TRUE(v.read(in.data(), in.size(), unlimited) == in.size() && unlimited.nodes == 6);
+		ASSERT_TRUE(v.read(in.data(), in.size(), unlimited) == in.size() && unlimited.nodes == 6);
+		// case 3 max depth
+		in = "[[[[1]]]]";
+		limits = JSON::ReadLimits(3);
+		r = v.try_read(in.data(), in.size(), limits);
+		ASSERT_TRUE(r.error == JSON::ERROR_DEPTH && r.offset == 3 && limits.exceeded == JSON::LIMIT_DEPTH);
+		limits = JSON::ReadLimits(4);
+		ASSERT_TRUE(v.try_read(in.data(), in.size(), limits).ok() && limits.exceeded == JSON::LIMIT_NONE);
+		// case 4 max nodes, stops fast at the first node over
+		in = "{\"a\":1,\"b\":2,\"c\":3,\"d\":4}";
+		limits = JSON::ReadLimits(0, 3);
+		r = v.try_read(in.data(), in.size(), limits);
+		ASSERT_TRUE(r.error == JSON::ERROR_LIMIT && r.offset == in.find("\"c\"") + 2 && limits.exceeded == JSON::LIMIT_NODES && limits.nodes == 4);
+		// case 5 max string bytes, keys and values
+		in = "[\"abc\",\"def\"]";
+		limits = JSON::ReadLimits(0, 0, 5);
+		r = v.try_read(in.data(), in.size(), limits);
+		ASSERT_TRUE(r.error == JSON::ERROR_LIMIT && limits.exceeded == JSON::LIMIT_STRING_BYTES && limits.string_bytes == 6);
+		in = "{\"abcdef\":1}";
+		r = v.try_read(in.data(), in.size(), limits);
+		ASSERT_TRUE(r.error == JSON::ERROR_LIMIT && limits.exceeded == JSON::LIMIT_STRING_BYTES);
+		// case 6 max allocated bytes
+		in = "[1";
+		for(int i = 0; i < 1000; ++i) in += ",1";
+		in += "]";
+		limits = JSON::ReadLimits(0, 0, 0, 1024);
+		r = v.try_read(in.data(), in.size(), limits);
+		ASSERT_TRUE(r.error == JSON::ERROR_LIMIT && limits.exceeded == JSON::LIMIT_ALLOC_BYTES && limits.alloc_bytes > 1024 && r.offset < in.size() / 2);
+		// case 7 read throws with message
+		try {
+			v.read(in.data(), in.size(), limits);
+			ASSERT_TRUE(false);
+		}
+		catch(std::exception &e) {
+			ASSERT_TRUE(limits.exceeded == JSON::LIMIT_ALLOC_BYTES && string(e.what()).find("Limit exceeded") != string::npos);
+		}
+		// case 8 same as Reader
+		limits = JSON::ReadLimits(0, 10);
+		r = JSON::Reader::try_read(v, in.data(), in.size(), limits);
+		ASSERT_TRUE(r.error == JSON::ERROR_LIMIT && limits.exceeded == JSON::LIMIT_NODES);
+	}
+	catch(std::exception &e) {
+		printf("Error : %s.", e.what());
+		ASSERT_TRUE(false);
+	}
+}
+
+TEST(ut_xpjson, read_reuse)
+{
+	try {
+		// normal cases
+		// case 1 same shape, members, elements and strings are kept in place
+		string in("{\"id\":1,\"name\":\"a name longer than sso\",\"tags\":[\"x\",{\"k\":\"v\"}],\"obj\":{\"a\":null}}");
+		JSON::Value v, v2;
+		ASSERT_TRUE(v.read_reuse(in) == in.size());
+		v2.read(in);
+		ASSERT_TRUE(v == v2);
+		const JSON::Value* name = &v["name"];
+		const char* s = v["name"].c_str();
+		const JSON::Value* tag = &v["tags"][1];
+		in = "{\"obj\":{\"a\":true},\"tags\":[\"y\",{\"k\":\"w\"}],\"name\":\"b name longer than sso\",\"id\":2}";
+		ASSERT_TRUE(JSON::Reader::read_reuse(v, in) == in.size());
+		v2.read(in);
+		ASSERT_TRUE(v == v2 && &v["name"] == name && v["name"].c_str() == s && &v["tags"][1] == tag);
+		// case 2 other shapes, missing members and elements erased, types changed
+		in = "{\"id\":\"3\",\"tags\":[1],\"new\":[],\"obj\":[{}]}";
+		ASSERT_TRUE(v.read_reuse(in) == in.size());
+		v2.read(in);
+		ASSERT_TRUE(v == v2 && v.o().size() == 4 && v["tags"].a().size() == 1);
+		in = " [1,[2,3],{\"a\":\"b\\n\"}] ";
+		ASSERT_TRUE(v.read_reuse(in) == in.size() - 1);
+		v2.read(in);
+		ASSERT_TRUE(v == v2);
+		// case 3 duplicate key overrides as read
+		in = "{\"a\":[1,2],\"a\":[3]}";
+		v.read_reuse(in);
+		v2.read(in);
+		ASSERT_TRUE(v == v2);
+		// case 4 errors same as try_read, next read is whole
+		const char* bad_cases[] = {"", "[1,", "{\"a\":1", "[\"\\x\"]", "{\"a\" 1}", "[1}"};
+		for(size_t i = 0; i < sizeof(bad_cases) / sizeof(bad_cases[0]); ++i) {
+			in = bad_cases[i];
+			JSON::ReadResult r = v.try_read_reuse(in);
+			JSON::ReadResult r2 = v2.try_read(in);
+			EXPECT_TRUE(!r.ok() && r.error == r2.error && r.offset == r2.offset) << in;
+		}
+		in = "{\"a\":[1,2]}";
+		ASSERT_TRUE(JSON::Reader::try_read_reuse(v, in.data(), in.size()).ok());
+		v2.read(in);
+		ASSERT_TRUE(v == v2);
+	}
+	catch(std::exception &e) {
+		printf("Error : %s.", e.what());
+		ASSERT_TRUE(false);
+	}
+}
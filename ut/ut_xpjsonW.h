@@ -3,6 +3,7 @@
 #include "gtest/gtest.h"
 
 #include <iostream>
+#include <sstream>
 #include "../xpjson.hpp"
 using namespace std;
 
@@ -208,6 +209,12 @@ TEST(ut_xpjsonW, read)
 		{
 			in = L"\r\n\t { \"a\" \r:\n \"b\" \n\r\t}";
 			ASSERT_TRUE(JSON::ReaderW::read(v, in.c_str(), in.length()) == in.length());
+
+			// runs longer than a SIMD block
+			in = L"{\n\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\"a\"\r\n                                  :\n                 [ \r\n\t 1 ,                      null\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n ]\r\n\r\n\r\n\r\n\r\n\r\n\r\n\r\n\r\n}";
+			ASSERT_TRUE(JSON::ReaderW::read(v, in.c_str(), in.length()) == in.length());
+			ASSERT_TRUE(v[L"a"].a().size() == 2);
+			ASSERT_TRUE(v[L"a"].a().size() == 2);
 		}
 
 		// case 8 duplicate key
@@ -221,6 +228,13 @@ TEST(ut_xpjsonW, read)
 
 			ASSERT_TRUE(o1[L"a"].type() == JSON::INTEGER);
 			ASSERT_TRUE(o1[L"a"].i() == 1);
+
+			// the later value replaces a former container
+			in = L"{\"a\":[1,2],\"a\":{\"b\":3},\"a\":[4]}";
+			ASSERT_TRUE(JSON::ReaderW::read(v, in.c_str(), in.length()) == in.length());
+			ASSERT_TRUE(v.o().size() == 1);
+			ASSERT_TRUE(v[L"a"].a().size() == 1);
+			ASSERT_TRUE(v[L"a"][0].i() == 4);
 		}
 
 		// case 9 nested object
@@ -241,6 +255,20 @@ TEST(ut_xpjsonW, read)
 		ASSERT_TRUE(JSON::ReaderW::read(v, in.c_str(), in.length()) == in.length());
 		ASSERT_TRUE(v[L"aa\b\""].s() == L"b");
 
+		// case 12 nesting as deep as __XPJSON_MAX_DEPTH__
+		{
+			wstring arrays(__XPJSON_MAX_DEPTH__, '['), objects;
+			arrays.append(__XPJSON_MAX_DEPTH__, ']');
+			for(int i = 0; i < __XPJSON_MAX_DEPTH__; ++i) objects += L"{\"a\":";
+			objects += L"{}";
+			objects.append(__XPJSON_MAX_DEPTH__, '}');
+			ASSERT_TRUE(JSON::ReaderW::read(v, arrays.c_str(), arrays.length()) == arrays.length());
+			EXPECT_THROW(JSON::ReaderW::read(v, objects.c_str(), objects.length()), std::logic_error);
+			objects.erase(0, 5);
+			objects.erase(objects.length() - 1);
+			ASSERT_TRUE(JSON::ReaderW::read(v, objects.c_str(), objects.length()) == objects.length());
+		}
+
 		// exception cases
 		// case 1 bracket not match
 		in = L"{\"a\":\"b\"";
@@ -303,7 +331,11 @@ TEST(ut_xpjsonW, read)
 		in = L"{\"a\\";
 		EXPECT_THROW(JSON::ReaderW::read(v, in.c_str(), in.length()), std::logic_error);
 
-		// case 10 bad cow case when hit sso(1/5 bytes if sizof(wchar_t) is 2; 1 byte if sizof(wchar_t) is 4)
+		// case 10 nesting deeper than __XPJSON_MAX_DEPTH__
+		in.assign(__XPJSON_MAX_DEPTH__ + 1, '[');
+		EXPECT_THROW(JSON::ReaderW::read(v, in.c_str(), in.length()), std::logic_error);
+
+		// case 11 bad cow case when hit sso(1/5 bytes if sizof(wchar_t) is 2; 1 byte if sizof(wchar_t) is 4)
 		JSON::ValueW v2(L"y");
 		v = v2; // incorrect treat as cow when cow(sso_len highest bit) is true
 		*const_cast<wchar_t*>(v2.c_str()) = 'z';
@@ -1229,6 +1261,21 @@ TEST(ut_xpjsonW, read_string)
 		ASSERT_TRUE(v.read_string(L"\"abc\" {} []", 11) == 5);
 		ASSERT_TRUE(v.s() == L"abc");
 
+		// case 6 long string, escape and quote at each offset of SIMD blocks
+		for(size_t i = 0; i < 70; ++i) {
+			in = L'\"' + wstring(i, L'a') + L"\\/" + wstring(70 - i, L'b') + L'\"';
+			ASSERT_TRUE(v.read_string(in.c_str(), in.length()) == in.length());
+			ASSERT_TRUE(v.s() == wstring(i, L'a') + L'/' + wstring(70 - i, L'b'));
+			in = L'\"' + wstring(i, L'a') + L'\"' + wstring(70, L'c');
+			ASSERT_TRUE(v.read_string(in.c_str(), in.length(), true) == i + 2);
+			ASSERT_TRUE(v.s() == wstring(i, L'a'));
+		}
+
+		// case 7 plain runs between escapes and unicode escapes
+		in = L"\"plain run \\u4e2d\\u6587\\n\\u00e9 tail\"";
+		ASSERT_TRUE(v.read_string(in.c_str(), in.length()) == in.length());
+		ASSERT_TRUE(v.s() == L"plain run \x4e2d\x6587\n\xe9 tail");
+
 		// 2. exception cases
 		// case 1 no left double quotation
 		EXPECT_THROW(v.read_string(L"abc", 3), std::logic_error);
@@ -1281,6 +1328,14 @@ TEST(ut_xpjsonW, read_number)
 		ASSERT_TRUE(v.i() == -12345);
 		ASSERT_TRUE(v.read_number(L"-12345]", 7) == 6);
 		ASSERT_TRUE(v.i() == -12345);
+		ASSERT_TRUE(v.read_number(L"12345678", 8) == 8);
+		ASSERT_TRUE(v.i() == 12345678);
+		ASSERT_TRUE(v.read_number(L"1234567890123456,", 17) == 16);
+		ASSERT_TRUE(v.i() == 1234567890123456LL);
+		ASSERT_TRUE(v.read_number(L"-123456789012345678]", 20) == 19);
+		ASSERT_TRUE(v.i() == -123456789012345678LL);
+		ASSERT_TRUE(v.read_number(L"1567000000123.25", 16) == 16);
+		ASSERT_TRUE(v.f() == 1567000000123.25);
 
 		// case 3 integer number limits
 		ASSERT_TRUE(v.read_number(L"2147483647", 10) == 10);
@@ -1318,19 +1373,41 @@ TEST(ut_xpjsonW, read_number)
 		ASSERT_TRUE(v.read_number(L"9223372036854775808.0", 21) == 21);
 		ASSERT_TRUE(v.f() == 9.2233720368547758e+18);
 		ASSERT_TRUE(v.read_number(L"7205759403792793199999e-5", 25) == 25);
-		ASSERT_TRUE(v.f() == 72057594037927936);
+		ASSERT_TRUE(v.f() == 72057594037927928);
 		ASSERT_TRUE(v.read_number(L"7205759403792793200001e-5", 25) == 25);
 		ASSERT_TRUE(v.f() == 72057594037927936);
 		ASSERT_TRUE(v.read_number(L"1.725073858507201136057409796709131975934819546351645648023426109724822222021076945516529523908135087914149158913039621106870086438694594645527657207407820621743379988141063267329253552286881372149012981122451451889849057222307285255133155755015914397476397983411801999323962548289017107081850690630666655994938275772572015763062690663332647565300009245888316433037779791869612049497390377829704905051080609940730262937128958950003583799967207254304360284078895771796150945516748243471030702609144621572289880258182545180325707018860872113128079512233426288368622321503775666622503982534335974568884423900265498198385487948292206894721689831099698365846814022854243330660339850886445804001034933970427567186443383770486037861622771738545623065874679014086723327636718751234567890123456789012345678901e-290", 805) == 805);
-		ASSERT_TRUE(v.f() == 1.7250738585072009e-290);
+		ASSERT_TRUE(v.f() == 1.7250738585072012e-290);
 		ASSERT_TRUE(v.read_number(L"1014120480182583464902367222169599999e-5", 40) == 40);
 		ASSERT_TRUE(v.f() == 1.0141204801825834e+31);
 		ASSERT_TRUE(v.read_number(L"1014120480182583464902367222169600001e-5", 40) == 40);
-		ASSERT_TRUE(v.f() == 1.0141204801825834e+31);
+		ASSERT_TRUE(v.f() == 1.0141204801825835e+31);
 		ASSERT_TRUE(v.read_number(L"5708990770823839207320493820740630171355185151999e-3", 52) == 52);
 		ASSERT_TRUE(v.f() == 5.7089907708238389e+45);
 		ASSERT_TRUE(v.read_number(L"5708990770823839207320493820740630171355185152001e-3", 52) == 52);
-		ASSERT_TRUE(v.f() == 5.7089907708238389e+45);
+		ASSERT_TRUE(v.f() == 5.7089907708238395e+45);
+
+		// case 7 correctly rounded, out of range exponents
+		ASSERT_TRUE(v.read_number(L"0.1", 3) == 3);
+		ASSERT_TRUE(v.f() == 0.1);
+		ASSERT_TRUE(v.read_number(L"123456.789e-3", 13) == 13);
+		ASSERT_TRUE(v.f() == 123.456789);
+		ASSERT_TRUE(v.read_number(L"2.2250738585072011e-308", 23) == 23);
+		ASSERT_TRUE(v.f() == 2.2250738585072011e-308);
+		ASSERT_TRUE(v.read_number(L"4.9406564584124654e-324", 23) == 23);
+		ASSERT_TRUE(v.f() == 4.9406564584124654e-324);
+		ASSERT_TRUE(v.read_number(L"1.7976931348623157e308", 22) == 22);
+		ASSERT_TRUE(v.f() == DBL_MAX);
+		ASSERT_TRUE(v.read_number(L"0.0000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000001e520", 226) == 226);
+		ASSERT_TRUE(v.f() == 1e300);
+		ASSERT_TRUE(v.read_number(L"1000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000e-520", 225) == 225);
+		ASSERT_TRUE(v.f() == 1e-301);
+		ASSERT_TRUE(v.read_number(L"1e600", 5) == 5);
+		ASSERT_TRUE(v.f() == HUGE_VAL);
+		ASSERT_TRUE(v.read_number(L"-1e-600", 7) == 7);
+		ASSERT_TRUE(v.f() == 0);
+		ASSERT_TRUE(v.read_number(L"1e99999999999999999999", 22) == 22);
+		ASSERT_TRUE(v.f() == HUGE_VAL);
 
 		// 2. exception cases
 		// case 1 unexcept endings after integer number
@@ -1341,6 +1418,8 @@ TEST(ut_xpjsonW, read_number)
 		EXPECT_THROW(v.read_number(L"-0.1ea", 6), std::logic_error);
 		EXPECT_THROW(v.read_number(L"-0.1e+a", 7), std::logic_error);
 		EXPECT_THROW(v.read_number(L"-0.1e+1a", 8), std::logic_error);
+		EXPECT_THROW(v.read_number(L"1234567a90", 10), std::logic_error);
+		EXPECT_THROW(v.read_number(L"0.1234567/9", 11), std::logic_error);
 
 		// case 2 unexpect zero-leading
 		EXPECT_THROW(v.read_number(L"00", 2), std::logic_error);
@@ -1440,6 +1519,9 @@ TEST(ut_xpjsonW, read_nil)
 
 		// case 4 all whitespace characters
 		EXPECT_THROW(v.read_nil(L" \t\r\n", 4), std::logic_error);
+
+		// case 5 characters with whitespace in low byte
+		EXPECT_THROW(v.read_nil(L"\x120\x109\x10a\x10dnull", 8), std::logic_error);
 	}
 	catch(std::exception &e) {
 		printf("Error : %s.", e.what());
@@ -1520,3 +1602,982 @@ TEST(ut_xpjsonW, zh_cn)
 		ASSERT_TRUE(false);
 	}
 }
+
+TEST(ut_xpjsonW, incremental_reader)
+{
+	try {
+		// normal cases
+		// case 1 same as read, split at every offset
+		const wchar_t* cases[] = {
+			L"[null,2147483647,68719476735,1.3e-12,true,false,\"test\\\"\\\\\\/\\b\\f\\n\\r\\t\",\"test\"]",
+			L"  \r\n\t{\"ver\":123,\r\n \"o\":\tnull,\"flag\":true,\"data\":[[0,0.1,1.3e2]\r\n]\t  }",
+			L"{}", L"[]", L"[[[[]]]]", L"[{}]",
+			L"{\"aa\\b\\\"\":\"b\",\"a\":{\"a\":1},\"a\":[1 , 2 ]}",
+			L"[\"\\u4e2d\\u6587\",\"\\\\\",-0.5e-3]"
+		};
+		JSON::ValueW v, v2;
+		for(size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i) {
+			wstring in(cases[i]);
+			ASSERT_TRUE(JSON::ReaderW::read(v2, in) == in.length());
+			for(size_t split = 0; split < in.length(); ++split) {
+				JSON::IncrementalReaderW r(v);
+				ASSERT_TRUE(r.feed(in.data(), split) == JSON::IncrementalReaderW::NEED_MORE);
+				ASSERT_TRUE(r.consumed() == split);
+				ASSERT_TRUE(r.feed(in.data() + split, in.length() - split) == JSON::IncrementalReaderW::DONE);
+				ASSERT_TRUE(r.consumed() == in.length() - split);
+				ASSERT_TRUE(v == v2);
+			}
+		}
+
+		// case 2 one char a time, chars after document are left
+		wstring in(L"{\"a\\nb\":[\"x\\\"y\",12345678901,true,null,{}]} [1]");
+		JSON::IncrementalReaderW r(v);
+		size_t pos = 0;
+		while(r.feed(in.data() + pos, 1) == JSON::IncrementalReaderW::NEED_MORE) ++pos;
+		ASSERT_TRUE(r.done() && r.consumed() == 1);
+		ASSERT_TRUE(pos + 1 == in.find(L' ', in.find(L'}', 40)));
+		ASSERT_TRUE(v[L"a\nb"][0].s() == L"x\"y");
+		ASSERT_TRUE(v[L"a\nb"][1].i() == 12345678901LL);
+
+		// case 3 reset for next document
+		r.reset(v);
+		ASSERT_TRUE(r.feed(in.substr(pos + 1)) == JSON::IncrementalReaderW::DONE);
+		ASSERT_TRUE(r.consumed() == 4);
+		ASSERT_TRUE(v[0].i() == 1);
+
+		// exception cases
+		const wchar_t* bad_cases[] = {
+			L"\"a\":\"b\"", L"abcd", L"{\"a\":]}", L"{\"a\" \n\r\t a}",
+			L"[a]", L"[123,a]", L"[1 2]", L"[1 \"a\"]", L"[\"a\",\"b\"a",
+			L"[truex]", L"[nul]", L"[\"a\"}", L"{\"a\":1]", L"[1.]", L"[-]"
+		};
+		for(size_t i = 0; i < sizeof(bad_cases) / sizeof(bad_cases[0]); ++i) {
+			in = bad_cases[i];
+			r.reset(v);
+			EXPECT_THROW(r.feed(in), std::logic_error);
+		}
+		// feed after done
+		r.reset(v);
+		ASSERT_TRUE(r.feed(L"[]", 2) == JSON::IncrementalReaderW::DONE);
+		EXPECT_THROW(r.feed(L"[]", 2), std::logic_error);
+	}
+	catch(std::exception &e) {
+		printf("Error : %s.", e.what());
+		ASSERT_TRUE(false);
+	}
+}
+
+TEST(ut_xpjsonW, readv)
+{
+	try {
+		// normal cases
+		// case 1 same as read, split to 3 segments at every offset
+		wstring in(L"{\"ver\":123,\"name\":\"cow string\",\"esc\":\"a\\tb\",\"data\":[0,0.1,1.3e2,null]} ");
+		JSON::ValueW v, v2;
+		ASSERT_TRUE(JSON::ReaderW::read(v2, in) == in.length() - 1);
+		const size_t c = sizeof(wchar_t);
+		for(size_t i = 0; i < in.length(); ++i) {
+			for(size_t j = i; j < in.length(); ++j) {
+				struct iovec iov[3] = {{(void*)in.data(), i * c}, {(void*)(in.data() + i), (j - i) * c}, {(void*)(in.data() + j), (in.length() - j) * c}};
+				ASSERT_TRUE(JSON::ReaderW::readv(v, iov, 3, true) == in.length() - 1);
+				ASSERT_TRUE(v == v2);
+				// cow only if string and its closing quote are in one segment
+				size_t begin = in.find(L"cow"), quote = begin + 10;
+				bool inside = quote < i || (begin >= i && quote < j) || begin >= j;
+				ASSERT_TRUE((v[L"name"].c_str() == in.data() + begin) == inside);
+			}
+		}
+
+		// case 2 document ends before last segment
+		struct iovec iov[3] = {{(void*)L"[1,", 3 * c}, {(void*)L"2]  ", 4 * c}, {(void*)L"[3]", 3 * c}};
+		ASSERT_TRUE(JSON::ReaderW::readv(v, iov, 3) == 5);
+		ASSERT_TRUE(v.a().size() == 2 && v[1].i() == 2);
+
+		// exception cases
+		// case 1 document not finished
+		EXPECT_THROW(JSON::ReaderW::readv(v, iov, 1), std::logic_error);
+		// case 2 bad segments
+		iov[1].iov_base = (void*)L"2,]";
+		EXPECT_THROW(JSON::ReaderW::readv(v, iov, 3), std::logic_error);
+	}
+	catch(std::exception &e) {
+		printf("Error : %s.", e.what());
+		ASSERT_TRUE(false);
+	}
+}
+
+// logs events as text, stops at the stop-th event
+struct sax_log_handlerW
+{
+	wstring log;
+	int count, stop;
+	sax_log_handlerW(int s = -1) : count(0), stop(s) {}
+	bool next(const wstring& event) {log += event; log += L','; return ++count != stop;}
+	bool on_null() {return next(L"null");}
+	bool on_boolean(bool b) {return next(b ? L"true" : L"false");}
+	bool on_int(int64_t i) {wchar_t buf[32]; swprintf(buf, 32, L"i:%lld", (long long)i); return next(buf);}
+	bool on_double(double f) {wchar_t buf[32]; swprintf(buf, 32, L"f:%g", f); return next(buf);}
+	bool on_string(const wchar_t* s, size_t len) {return next(L"s:" + wstring(s, len));}
+	bool on_key(const wchar_t* s, size_t len) {return next(L"k:" + wstring(s, len));}
+	bool on_object_begin() {return next(L"{");}
+	bool on_object_end() {return next(L"}");}
+	bool on_array_begin() {return next(L"[");}
+	bool on_array_end() {return next(L"]");}
+};
+
+// keeps pointer of the last string
+struct sax_ptr_handlerW : sax_log_handlerW
+{
+	const wchar_t* p;
+	bool on_string(const wchar_t* s, size_t) {p = s; return true;}
+};
+
+TEST(ut_xpjsonW, sax_parse)
+{
+	try {
+		// normal cases
+		// case 1 events in document order, duplicate keys kept
+		wstring in(L" {\"b\":[null,true,false,-12,1.5e2,\"x\\ty\",{},[]],\"a\":{\"k\\u4e2d\":\"v\"},\"a\":\"plain\"} ");
+		sax_log_handlerW h;
+		ASSERT_TRUE(JSON::ReaderW::parse(h, in) == in.length() - 1);
+		ASSERT_TRUE(h.log == L"{,k:b,[,null,true,false,i:-12,f:150,s:x\ty,{,},[,],],k:a,{,k:k\x4e2d,s:v,},k:a,s:plain,},");
+
+		// case 2 plain string points into input
+		sax_ptr_handlerW ph;
+		ASSERT_TRUE(JSON::ReaderW::parse(ph, in) == in.length() - 1);
+		ASSERT_TRUE(ph.p == in.data() + in.find(L"plain"));
+
+		// case 3 stop at any event
+		for(int i = 1; i <= 22; ++i) {
+			sax_log_handlerW stop(i);
+			size_t pos = JSON::ReaderW::parse(stop, in);
+			ASSERT_TRUE(stop.count == i);
+			ASSERT_TRUE(h.log.compare(0, stop.log.length(), stop.log) == 0);
+			ASSERT_TRUE(pos <= in.length() - 1);
+		}
+		sax_log_handlerW stop(4);
+		ASSERT_TRUE(JSON::ReaderW::parse(stop, in) == in.find(L"null") + 4);
+
+		// case 4 same nesting limit as read
+		wstring deep(__XPJSON_MAX_DEPTH__, L'[');
+		deep.append(__XPJSON_MAX_DEPTH__, L']');
+		sax_log_handlerW dh;
+		ASSERT_TRUE(JSON::ReaderW::parse(dh, deep) == deep.length());
+
+		// exception cases
+		const wchar_t* bad_cases[] = {
+			L"", L"  ", L"\"a\":\"b\"", L"abcd", L"{\"a\":]}", L"{\"a\" \n\r\t a}", L"[a]", L"[123,a]",
+			L"[1 2]", L"[\"a\",\"b\"a", L"[truex]", L"[nul]", L"[\"a\"}", L"{\"a\":1]", L"[1.]", L"[\"\\x\"]", L"[1,2"
+		};
+		for(size_t i = 0; i < sizeof(bad_cases) / sizeof(bad_cases[0]); ++i) {
+			sax_log_handlerW bh;
+			EXPECT_THROW(JSON::ReaderW::parse(bh, bad_cases[i]), std::logic_error);
+		}
+		deep.insert(0, L"[");
+		deep.append(L"]");
+		EXPECT_THROW(JSON::ReaderW::parse(dh, deep), std::logic_error);
+	}
+	catch(std::exception &e) {
+		printf("Error : %s.", e.what());
+		ASSERT_TRUE(false);
+	}
+}
+
+TEST(ut_xpjsonW, cursor)
+{
+	try {
+		// normal cases
+		wstring in(L" {\"skip\":{\"a\":[1,{\"]\":\"}\\\"]\"}],\"b\":\"\\\\\"},\"media\":{\"bitrate\":262144,\"ratio\":1.5,"
+				  L"\"title\":\"Javaone\",\"esc\":\"a\\tb\",\"live\":false,\"copyright\":null,\"persons\":[\"Bill\",{\"x\":[]},3]},"
+				  L"\"e\\u0078\":[],\"media\":0} ");
+		JSON::CursorW c(in);
+		// case 1 find fields, the first one wins
+		ASSERT_TRUE(c.type() == JSON::OBJECT);
+		JSON::CursorW media = c.find_field(L"media");
+		ASSERT_TRUE(media.valid() && media.type() == JSON::OBJECT);
+		ASSERT_TRUE(media[L"bitrate"].type() == JSON::INTEGER);
+		ASSERT_TRUE(media[L"bitrate"].i() == 262144);
+		ASSERT_TRUE(media[L"ratio"].type() == JSON::FLOAT);
+		ASSERT_TRUE(media[L"ratio"].f() == 1.5);
+		ASSERT_TRUE(media[L"live"].b() == false);
+		ASSERT_TRUE(media[L"copyright"].is_null());
+		ASSERT_TRUE(c[L"ex"].type() == JSON::ARRAY);
+		// case 2 missing fields are chained
+		ASSERT_FALSE(c[L"none"].valid());
+		ASSERT_FALSE(c[L"none"][L"bitrate"].valid());
+		ASSERT_FALSE(c[L"skip"][L"x"][L"c"].valid());
+		ASSERT_FALSE(JSON::CursorW(L"{ }")[L"a"].valid());
+		ASSERT_FALSE(JSON::CursorW(L" ")[L"a"].valid());
+		// case 3 string views
+		const wchar_t* s = NULL;
+		size_t len = 0;
+		ASSERT_TRUE(media[L"title"].view(s, len));
+		ASSERT_TRUE(s == in.data() + in.find(L"Javaone") && len == 7);
+		ASSERT_FALSE(media[L"esc"].view(s, len));
+		ASSERT_TRUE(wstring(s, len) == L"a\\tb");
+		ASSERT_TRUE(media[L"esc"].s() == L"a\tb");
+		// slashes and non-ASCII chars are not escapes
+		const wstring plain(L"{\"uri\":\"http://a.com/x\",\"name\":\"caf\u00e9\"}");
+		JSON::CursorW u(plain);
+		ASSERT_TRUE(u[L"uri"].view(s, len) && wstring(s, len) == L"http://a.com/x");
+		ASSERT_TRUE(u[L"name"].view(s, len) && s == plain.data() + plain.find(L"caf"));
+		ASSERT_TRUE(c[L"skip"][L"b"].s() == L"\\");
+		// case 4 iterate array
+		JSON::CursorW e = media[L"persons"].begin();
+		ASSERT_TRUE(e.s() == L"Bill");
+		e = e.next();
+		ASSERT_FALSE(e[L"x"].begin().valid());
+		e = e.next();
+		ASSERT_TRUE(e.i() == 3);
+		ASSERT_FALSE(e.next().valid());
+		ASSERT_FALSE(c[L"ex"].begin().valid());
+		// case 5 read subtree same as read
+		JSON::ValueW v, v2;
+		ASSERT_TRUE(media.read(v) == in.find(L",\"e\\u") - in.find(L"{\"bitrate"));
+		JSON::ReaderW::read(v2, in);
+		ASSERT_TRUE(v[L"bitrate"].i() == 262144 && v[L"persons"].a().size() == 3);
+		ASSERT_TRUE(c[L"skip"].read(v) > 0 && v == v2[L"skip"]);
+		ASSERT_TRUE(media[L"title"].read(v) == 9 && v.s() == L"Javaone");
+
+		// exception cases
+		// case 1 type mismatch
+		EXPECT_THROW(c.begin(), std::logic_error);
+		EXPECT_THROW(media[L"persons"][L"a"], std::logic_error);
+		EXPECT_THROW(media[L"bitrate"].f(), std::logic_error);
+		EXPECT_THROW(media[L"ratio"].i(), std::logic_error);
+		EXPECT_THROW(media[L"title"].i(), std::logic_error);
+		EXPECT_THROW(media[L"bitrate"].view(s, len), std::logic_error);
+		// case 2 invalid cursor
+		EXPECT_THROW(c[L"none"].i(), std::logic_error);
+		EXPECT_THROW(c[L"none"].begin(), std::logic_error);
+		// case 3 bad document on the way
+		const wchar_t* bad_cases[] = {L"{\"a\" 1}", L"{\"a\":1 \"media\":2}", L"{a:1}", L"{\"a\":1,}", L"{\"a\":[1,2}", L"{\"media\""};
+		for(size_t i = 0; i < sizeof(bad_cases) / sizeof(bad_cases[0]); ++i) {
+			EXPECT_THROW(JSON::CursorW(bad_cases[i]).find_field(L"media"), std::logic_error);
+		}
+		EXPECT_THROW(JSON::CursorW(L"[1 2]").begin().next(), std::logic_error);
+		EXPECT_THROW(JSON::CursorW(L"[1,").begin().next(), std::logic_error);
+		EXPECT_THROW(JSON::CursorW(L"{\"a\":tru}")[L"a"].b(), std::logic_error);
+	}
+	catch(std::exception &e) {
+		printf("Error : %s.", e.what());
+		ASSERT_TRUE(false);
+	}
+}
+
+TEST(ut_xpjsonW, read_lazy)
+{
+	try {
+		// normal cases
+		wstring in(L" {\"header\":{\"id\":1,\"tags\":[\"a\",\"b\"]},\"body\":[ {\"k\" : \"v\\n\"}, [1, 2.5, null] ],\"n\":3} ");
+		JSON::ValueW v, v2;
+		ASSERT_TRUE(JSON::ReaderW::read(v2, in) == in.length() - 1);
+		// case 1 nested values are raw spans, written verbatim
+		ASSERT_TRUE(v.read_lazy(in) == in.length() - 1);
+		ASSERT_TRUE(v[L"n"].i() == 3);
+		ASSERT_TRUE(v.o().find(L"body")->second.lazy());
+		wstring out;
+		v.write(out);
+		ASSERT_TRUE(out == L"{\"body\":[ {\"k\" : \"v\\n\"}, [1, 2.5, null] ],\"header\":{\"id\":1,\"tags\":[\"a\",\"b\"]},\"n\":3}");
+		// case 2 parsed level by level on first access
+		ASSERT_TRUE(v[L"header"][L"id"].i() == 1);
+		ASSERT_FALSE(v[L"header"].lazy());
+		ASSERT_TRUE(v[L"header"][L"tags"].lazy());
+		ASSERT_TRUE(v[L"header"][L"tags"][1].s() == L"b");
+		const JSON::ValueW& body = v[L"body"];
+		ASSERT_TRUE(body.a().size() == 2 && body.a()[0].lazy());
+		ASSERT_TRUE(body.a()[0].o().find(L"k")->second.s() == L"v\n");
+		ASSERT_TRUE(v == v2);
+		out.clear();
+		v.write(out);
+		wstring out2;
+		v2.write(out2);
+		ASSERT_TRUE(out == out2);
+		// case 3 copy shares span, deeper depth
+		ASSERT_TRUE(v.read_lazy(in.data(), in.length(), 2) == in.length() - 1);
+		ASSERT_FALSE(v[L"body"].lazy());
+		ASSERT_TRUE(v[L"body"][1].lazy());
+		JSON::ValueW c(v[L"body"][1]);
+		ASSERT_TRUE(c.lazy());
+		c = v[L"body"][0];
+		ASSERT_TRUE(c.lazy() && c[L"k"].s() == L"v\n");
+		ASSERT_TRUE(v[L"body"][0].lazy());
+		v[L"body"][1] = 1;
+		ASSERT_TRUE(v[L"body"][1].i() == 1);
+		v[L"body"][0].clear(JSON::OBJECT);
+		ASSERT_TRUE(!v[L"body"][0].lazy() && v[L"body"][0].o().empty());
+		// case 4 cow strings in spans
+		ASSERT_TRUE(v.read_lazy(in, 1, true) == in.length() - 1);
+		ASSERT_TRUE(v[L"header"][L"tags"][0].c_str() == in.data() + in.find(L"a\""));
+
+		// exception cases
+		// case 1 mismatched or unclosed brackets
+		const wchar_t* bad_cases[] = {L"{\"a\":[1}", L"{\"a\":{1]}", L"{\"a\":[[]", L"[[\"]\"]"};
+		for(size_t i = 0; i < sizeof(bad_cases) / sizeof(bad_cases[0]); ++i) {
+			EXPECT_THROW(v.read_lazy(bad_cases[i]), std::logic_error);
+		}
+		// case 2 malformed span throws on access
+		in = L"{\"a\":[1 2]}";
+		ASSERT_TRUE(v.read_lazy(in) == 11);
+		EXPECT_THROW(v[L"a"][0], std::logic_error);
+		// kept raw, same error again and written verbatim
+		ASSERT_TRUE(v[L"a"].lazy());
+		EXPECT_THROW(v[L"a"].a(), std::logic_error);
+		out.clear();
+		v.write(out);
+		ASSERT_TRUE(out == L"{\"a\":[1 2]}");
+	}
+	catch(std::exception &e) {
+		printf("Error : %s.", e.what());
+		ASSERT_TRUE(false);
+	}
+}
+
+TEST(ut_xpjsonW, read_projected)
+{
+	try {
+		// normal cases
+		wstring in(L"{\"images\":[{\"height\":768,\"title\":\"Keynote\",\"width\":1024},{\"height\":240,\"width\":320},7],"
+				  L"\"media\":{\"bitrate\":262144,\"uri\":\"http:\\/\\/javaone.com\\/keynote.mpg\",\"persons\":[\"Bill\",\"Steve\"]},"
+				  L"\"a/b\":{\"~\":1},\"e\\u0078\":true,\"tail\":[1,2,3]}");
+		JSON::ValueW v, v2;
+		JSON::ReaderW::read(v2, in);
+		// case 1 selected paths only
+		JSON::FieldMaskW mask;
+		mask.add(L"/media/uri").add(L"/images/*/width").add(L"/a~1b/~0").add(L"/ex");
+		ASSERT_TRUE(JSON::ReaderW::read(v, in, mask) == in.length());
+		wstring out;
+		v.write(out);
+		// scalar 7 has no width
+		ASSERT_TRUE(out == L"{\"a\\/b\":{\"~\":1},\"ex\":true,\"images\":[{\"width\":1024},{\"width\":320}],\"media\":{\"uri\":\"http:\\/\\/javaone.com\\/keynote.mpg\"}}");
+		// case 2 whole subtree and index, elements before index are null
+		mask = JSON::FieldMaskW();
+		mask.add(L"/media/persons").add(L"/images/1/height").add(L"/tail/1").add(L"/none/x");
+		ASSERT_TRUE(v.read(in, mask) == in.length());
+		ASSERT_TRUE(v[L"media"][L"persons"] == v2[L"media"][L"persons"]);
+		ASSERT_TRUE(v[L"images"][0].type() == JSON::NIL);
+		ASSERT_TRUE(v[L"images"][1][L"height"].i() == 240 && v[L"images"][1].o().size() == 1);
+		ASSERT_TRUE(v[L"tail"].a().size() == 2 && v[L"tail"][1].i() == 2);
+		ASSERT_TRUE(v.o().size() == 3);
+		// case 3 whole document
+		mask = JSON::FieldMaskW();
+		mask.add(L"");
+		ASSERT_TRUE(v.read(in, mask) == in.length() && v == v2);
+		mask = JSON::FieldMaskW();
+		mask.add(L"/*");
+		ASSERT_TRUE(v.read(in, mask) == in.length() && v == v2);
+		// case 4 stop early
+		JSON::FieldMaskW early(true);
+		early.add(L"/images/0/width").add(L"/media/bitrate");
+		ASSERT_TRUE(v.read(in, early) == in.find(L",\"uri\""));
+		ASSERT_TRUE(v[L"media"][L"bitrate"].i() == 262144 && v[L"images"][0][L"width"].i() == 1024);
+		// not stopped early with L"*"
+		early.add(L"/tail/*");
+		ASSERT_TRUE(v.read(in, early) == in.length());
+		// case 5 skipped values are not validated
+		mask = JSON::FieldMaskW();
+		mask.add(L"/a");
+		ASSERT_TRUE(v.read(L"{\"b\":[1 2 x],\"a\":1}", mask) == 19 && v[L"a"].i() == 1);
+		// case 6 wildcard also matches where an exact key does, in any order of paths
+		wstring both(L"{\"media\":{\"uri\":\"u\",\"width\":640},\"images\":{\"width\":3}}");
+		JSON::FieldMaskW wild;
+		wild.add(L"/media/uri").add(L"/*/width");
+		ASSERT_TRUE(v.read(both, wild) == both.length());
+		out.clear();
+		v.write(out);
+		ASSERT_TRUE(out == L"{\"images\":{\"width\":3},\"media\":{\"uri\":\"u\",\"width\":640}}");
+		wild = JSON::FieldMaskW();
+		wild.add(L"/*/width").add(L"/media/uri");
+		ASSERT_TRUE(v.read(both, wild) == both.length());
+		out.clear();
+		v.write(out);
+		ASSERT_TRUE(out == L"{\"images\":{\"width\":3},\"media\":{\"uri\":\"u\",\"width\":640}}");
+		wild = JSON::FieldMaskW();
+		wild.add(L"/images/1/height").add(L"/images/*/width");
+		ASSERT_TRUE(v.read(in, wild) == in.length());
+		ASSERT_TRUE(v[L"images"][1][L"height"].i() == 240 && v[L"images"][1][L"width"].i() == 320 && v[L"images"][0].o().size() == 1);
+		// case 7 keys refer to in if cow, same as read
+		ASSERT_TRUE(v.read(in, wild, true) == in.length());
+		ASSERT_TRUE(v[L"images"][1].o().find(L"height")->first.data() == in.data() + in.find(L"height\":240"));
+		ASSERT_TRUE(v.read(in, wild) == in.length());
+		ASSERT_TRUE(v[L"images"][1].o().find(L"height")->first.data() != in.data() + in.find(L"height\":240"));
+		// case 8 selected subtree is as deep as __XPJSON_MAX_DEPTH__ from topmost
+		wstring deep(L"{\"a\":" + wstring(__XPJSON_MAX_DEPTH__ - 1, '[') + wstring(__XPJSON_MAX_DEPTH__ - 1, ']') + L"}");
+		ASSERT_TRUE(v.read(deep, mask) == deep.length());
+		deep.insert(5, 1, '[').insert(deep.length() - 1, 1, ']');
+		EXPECT_THROW(v.read(deep, mask), std::logic_error);
+
+		// exception cases
+		// case 1 bad paths
+		EXPECT_THROW(mask.add(L"a"), std::logic_error);
+		EXPECT_THROW(mask.add(L"/a~2"), std::logic_error);
+		EXPECT_THROW(mask.add(L"/a~"), std::logic_error);
+		// case 2 bad documents
+		const wchar_t* bad_cases[] = {L"", L"1", L"{\"a\" 1}", L"{\"a\":1 \"b\":2}", L"{\"b\":[1,2}", L"{\"a\":[1}", L"{\"a\":tru}", L"{\"b\":}", L"[\"a\""};
+		for(size_t i = 0; i < sizeof(bad_cases) / sizeof(bad_cases[0]); ++i) {
+			EXPECT_THROW(v.read(bad_cases[i], mask), std::logic_error);
+		}
+	}
+	catch(std::exception &e) {
+		printf("Error : %s.", e.what());
+		ASSERT_TRUE(false);
+	}
+}
+
+TEST(ut_xpjsonW, cursor_pointer)
+{
+	try {
+		// normal cases
+		wstring in(L"{\"tenant\":\"t1\",\"images\":[{\"width\":1024},{\"width\":320,\"ids\":[7,8]}],"
+				  L"\"a/b\":{\"m~n\":1,\"\":2},\"e\\u0078\":true,\"0\":\"zero\",\"x.y\":3}");
+		JSON::CursorW c(in);
+		// case 1 JSON pointer
+		ASSERT_TRUE(c.at(L"/tenant").s() == L"t1");
+		ASSERT_TRUE(c.at(L"/images/1/width").i() == 320);
+		ASSERT_TRUE(c.at(L"/images/1/ids/1").i() == 8);
+		ASSERT_TRUE(c.at(L"/a~1b/m~0n").i() == 1);
+		ASSERT_TRUE(c.at(L"/a~1b/").i() == 2);
+		ASSERT_TRUE(c.at(L"/ex").b());
+		ASSERT_TRUE(c.at(L"/0").s() == L"zero");
+		ASSERT_TRUE(c.at(L"").type() == JSON::OBJECT);
+		ASSERT_TRUE(c.at(wstring(L"/images")).at(L"/0/width").i() == 1024);
+		// case 2 path expression
+		ASSERT_TRUE(c.path(L"images[1].ids[0]").i() == 7);
+		ASSERT_TRUE(c.path(L"a/b.m~n").i() == 1);
+		ASSERT_TRUE(c.path(L"images").path(L"[0].width").i() == 1024);
+		ASSERT_TRUE(JSON::CursorW(L"[[1,2],{\"k\":[3]}]").path(L"[1].k[0]").i() == 3);
+		// case 3 missing
+		const wchar_t* missing[] = {L"/none", L"/images/2", L"/images/-", L"/images/01", L"/images/x", L"/tenant/x", L"/images/0/width/0", L"/none/x/y"};
+		for(size_t i = 0; i < sizeof(missing) / sizeof(missing[0]); ++i) {
+			ASSERT_FALSE(c.at(missing[i]).valid());
+		}
+		ASSERT_FALSE(c.path(L"images[2].width").valid());
+		ASSERT_FALSE(c.path(L"tenant[0]").valid());
+		ASSERT_FALSE(c.path(L"x.y").valid());
+		// case 4 raw text
+		const wchar_t* s;
+		size_t len;
+		c.at(L"/images/1").raw(s, len);
+		ASSERT_TRUE(wstring(s, len) == L"{\"width\":320,\"ids\":[7,8]}");
+		c.at(L"/tenant").raw(s, len);
+		ASSERT_TRUE(wstring(s, len) == L"\"t1\"");
+		c.at(L"/images/1/width").raw(s, len);
+		ASSERT_TRUE(wstring(s, len) == L"320");
+
+		// exception cases
+		// case 1 bad pointers and paths
+		EXPECT_THROW(c.at(L"tenant"), std::logic_error);
+		EXPECT_THROW(c.at(L"/a~2b"), std::logic_error);
+		EXPECT_THROW(c.at(L"/none/a~"), std::logic_error);
+		const wchar_t* bad_paths[] = {L"images[", L"images[x]", L"images[01]", L"images.", L".images", L"images..width", L"images[0]width"};
+		for(size_t i = 0; i < sizeof(bad_paths) / sizeof(bad_paths[0]); ++i) {
+			EXPECT_THROW(c.path(bad_paths[i]), std::logic_error);
+		}
+		EXPECT_THROW(JSON::CursorW(L"").at(L"").raw(s, len), std::logic_error);
+		// case 2 bad documents on the way
+		EXPECT_THROW(JSON::CursorW(L"{\"a\" 1}").at(L"/a"), std::logic_error);
+		EXPECT_THROW(JSON::CursorW(L"[1 2]").at(L"/1"), std::logic_error);
+	}
+	catch(std::exception &e) {
+		printf("Error : %s.", e.what());
+		ASSERT_TRUE(false);
+	}
+}
+
+TEST(ut_xpjsonW, read_lines)
+{
+	try {
+		// normal cases
+		// case 1 blank lines skipped, bad lines resynced at next newline
+		wstring in(L"{\"a\":1}\n\n  [2, 3]  \r\n{\"a\":\n{\"b\":\"x\"} 7\n\t\n[]\n{\"c\":tru}\n\"s\"\n{\"d\":[4]}");
+		vector<JSON::ValueW> out;
+		vector<size_t> bad;
+		ASSERT_TRUE(JSON::ReaderW::read_lines(out, in, &bad, 1) == 8 && out.size() == 8);
+		ASSERT_TRUE(out[0][L"a"].i() == 1);
+		ASSERT_TRUE(out[1][1].i() == 3);
+		ASSERT_TRUE(out[4].type() == JSON::ARRAY && out[4].a().empty());
+		ASSERT_TRUE(out[7][L"d"][0].i() == 4);
+		ASSERT_TRUE(bad.size() == 4 && bad[0] == 2 && bad[1] == 3 && bad[2] == 5 && bad[3] == 6);
+		for(size_t i = 0; i < bad.size(); ++i) {
+			ASSERT_TRUE(out[bad[i]].type() == JSON::NIL);
+		}
+		// case 2 empty input
+		ASSERT_TRUE(JSON::ReaderW::read_lines(out, wstring(L"\n \n")) == 0 && out.empty());
+		ASSERT_TRUE(JSON::ReaderW::read_lines(out, wstring()) == 0 && out.empty());
+		// case 3 threads keep input order
+		wstring big;
+		for(int i = 0; i < 6000; ++i) {
+			wchar_t line[64];
+			swprintf(line, 64, i % 97 ? L"{\"id\":%d,\"tags\":[\"t\",\"u\"]}\n" : L"{\"id\":%d,\n", i);
+			big += line;
+		}
+		for(unsigned threads = 0; threads <= 4; ++threads) {
+			bad.clear();
+			ASSERT_TRUE(JSON::ReaderW::read_lines(out, big, &bad, threads, threads % 2) == 6000);
+			ASSERT_TRUE(bad.size() == 62);
+			for(size_t i = 0; i < out.size(); ++i) {
+				if(i % 97) ASSERT_TRUE(out[i][L"id"].i() == (int64_t)i && out[i][L"tags"][1].s() == L"u");
+				else ASSERT_TRUE(out[i].type() == JSON::NIL && bad[i / 97] == i);
+			}
+		}
+		// case 4 SAX, handler stops the line only
+		sax_log_handlerW h(2);
+		bad.clear();
+		ASSERT_TRUE(JSON::ReaderW::parse_lines(h, L"[1, 5]\n\n{\"a\":2}\n{\"a\"\n[3] x\n[null]", &bad) == 5);
+		ASSERT_TRUE(h.log == L"[,i:1,{,k:a,i:2,},{,k:a,[,i:3,],[,null,],");
+		ASSERT_TRUE(bad.size() == 2 && bad[0] == 2 && bad[1] == 3);
+	}
+	catch(std::exception &e) {
+		printf("Error : %s.", e.what());
+		ASSERT_TRUE(false);
+	}
+}
+
+TEST(ut_xpjsonW, read_parallel)
+{
+	try {
+		// normal cases
+		// case 1 same as read, about 200KB for 3 threads
+		wstring in(L" [");
+		for(int i = 0; i < 2400; ++i) {
+			wchar_t elem[128];
+			swprintf(elem, 128, L"%ls{\"id\":%d,\"s\":\"a,]\\\"[\",\"f\":%d.5,\"a\":[[],{}]}, \"x\\u4e2d\", -%d, true, null, [[%d]]", i ? L",\n" : L"", i, i, i, i);
+			in += elem;
+		}
+		in += L" ] ";
+		JSON::ValueW v, v2;
+		const size_t ret = v2.read(in);
+		for(unsigned threads = 0; threads <= 5; ++threads) {
+			ASSERT_TRUE(v.read_parallel(in, threads, threads % 2) == ret);
+			ASSERT_TRUE(v == v2 && v.a().size() == 14400);
+		}
+		// case 2 small or other documents
+		ASSERT_TRUE(JSON::ReaderW::read_parallel(v, wstring(L"[]"), 4) == 2 && v.a().empty());
+		ASSERT_TRUE(JSON::ReaderW::read_parallel(v, wstring(L" [1, 2]"), 4) == 7 && v[1].i() == 2);
+		ASSERT_TRUE(v.read_parallel(wstring(L"{\"a\":[1]}"), 4) == 9 && v[L"a"][0].i() == 1);
+		// case 3 depth limit of elements is the same
+		wstring deep(in.substr(0, in.length() - 3) + L",");
+		deep.append(__XPJSON_MAX_DEPTH__ - 1, L'[');
+		deep.append(__XPJSON_MAX_DEPTH__ - 1, L']');
+		deep += L"]";
+		ASSERT_TRUE(v.read_parallel(deep, 4) == deep.length() && v.a().size() == 14401);
+
+		// exception cases
+		// case 1 bad elements at the end or the beginning
+		const wchar_t* bad_cases[] = {L"", L"1 2", L"truex", L"1.5e", L"{\"a\" 1}", L"[}", L"\"a", L"tru", L"[1,]", L":"};
+		for(size_t i = 0; i < sizeof(bad_cases) / sizeof(bad_cases[0]); ++i) {
+			wstring bad(in.substr(0, in.length() - 3) + L"," + bad_cases[i] + L"]");
+			EXPECT_THROW(v.read(bad), std::logic_error);
+			EXPECT_THROW(v.read_parallel(bad, 4), std::logic_error);
+			bad = L"[" + wstring(bad_cases[i]) + L"," + in.substr(2);
+			EXPECT_THROW(v.read(bad), std::logic_error);
+			EXPECT_THROW(v.read_parallel(bad, 4), std::logic_error);
+		}
+		// case 2 not closed
+		EXPECT_THROW(v.read_parallel(in.substr(0, in.length() - 3), 4), std::logic_error);
+		// case 3 too deep
+		deep = in.substr(0, in.length() - 3) + L",";
+		deep.append(__XPJSON_MAX_DEPTH__, L'[');
+		deep.append(__XPJSON_MAX_DEPTH__, L']');
+		deep += L"]";
+		EXPECT_THROW(v.read(deep), std::logic_error);
+		EXPECT_THROW(v.read_parallel(deep, 4), std::logic_error);
+	}
+	catch(std::exception &e) {
+		printf("Error : %s.", e.what());
+		ASSERT_TRUE(false);
+	}
+}
+
+TEST(ut_xpjsonW, read_insitu)
+{
+	try {
+		// normal cases
+		// case 1 escaped strings refer to input too
+		wstring in(L"{\"a\":\"x\\ty\\\"z\\/\",\"b\":[\"plain\",\"\\u4e2d\\ud83d\\ude00\\n\",\"\\\\\"],\"k\\u0065y\":\"\\u0041BCDEFGHIJKLMNOPQRSTUVWXYZ\"}");
+		const wstring copy(in);
+		JSON::ValueW v, v2;
+		v2.read(copy);
+		ASSERT_TRUE(v.read_insitu(in) == in.length());
+		ASSERT_TRUE(v == v2);
+		const wchar_t* begin = in.data();
+		const wchar_t* end = begin + in.length();
+		// s() of non-const value copies cow string, so check pointers first
+		ASSERT_TRUE(v[L"a"].c_str() >= begin && v[L"a"].c_str() < end && v[L"a"].s() == L"x\ty\"z/");
+		ASSERT_TRUE(v[L"b"][1].c_str() >= begin && v[L"b"][1].c_str() < end && v[L"b"][1].s() == wstring(L"\x4e2d") + (wchar_t)0x1f600 + L"\n");
+		ASSERT_TRUE(v[L"b"][2].c_str() >= begin && v[L"b"][2].c_str() < end && v[L"b"][2].s() == L"\\");
+		ASSERT_TRUE(v[L"b"][0].c_str() >= begin && v[L"b"][0].c_str() < end);
+		ASSERT_TRUE(v[L"key"].s() == L"ABCDEFGHIJKLMNOPQRSTUVWXYZ");
+		// case 2 written escaped again
+		wstring out, out2;
+		v.write(out);
+		v2.write(out2);
+		ASSERT_TRUE(out == out2);
+		// case 3 raw buffer
+		wchar_t buf[] = L"[\"\\n\", 1]";
+		ASSERT_TRUE(JSON::ReaderW::read_insitu(v, buf, sizeof(buf) / sizeof(buf[0]) - 1) == sizeof(buf) / sizeof(buf[0]) - 1);
+		ASSERT_TRUE(v[0].c_str() == buf + 2 && v[0].s() == L"\n" && v[1].i() == 1);
+
+		// exception cases
+		const wchar_t* bad_cases[] = {L"", L"[\"\\x\"]", L"[\"\\u12\"]", L"[\"\\ud800\"]", L"[\"a\\\"]", L"{\"a\":\"\\q\"}"};
+		for(size_t i = 0; i < sizeof(bad_cases) / sizeof(bad_cases[0]); ++i) {
+			wstring bad(bad_cases[i]);
+			EXPECT_THROW(v.read_insitu(bad), std::logic_error);
+		}
+	}
+	catch(std::exception &e) {
+		printf("Error : %s.", e.what());
+		ASSERT_TRUE(false);
+	}
+}
+
+TEST(ut_xpjsonW, cow_keys)
+{
+	try {
+		// normal cases
+		// case 1 keys refer to input with cow, escaped ones are copied
+		const wstring in(L"{\"media\":{\"a_long_key_over_sso\":1,\"k\\u0065y\":2},\"b\":[{\"c\":true}]}");
+		JSON::ValueW v, v2;
+		ASSERT_TRUE(v.read(in, true) == in.length());
+		v2.read(in);
+		ASSERT_TRUE(v == v2);
+		const wchar_t* begin = in.data();
+		const wchar_t* end = begin + in.length();
+		JSON::ObjectW::const_iterator it = v[L"media"].o().find(L"a_long_key_over_sso");
+		ASSERT_TRUE(it != v[L"media"].o().end() && it->first.cow() && it->first.data() >= begin && it->first.data() < end);
+		it = v[L"media"].o().find(wstring(L"key"));
+		ASSERT_TRUE(it != v[L"media"].o().end() && !it->first.cow() && it->first == L"key" && it->second.i() == 2);
+		ASSERT_TRUE(v[L"b"][0].o().begin()->first.cow() && v[L"b"][0].o().count(L"c") == 1);
+		it = v2[L"media"].o().find(L"a_long_key_over_sso");
+		ASSERT_TRUE(!it->first.cow() && (it->first.data() < begin || it->first.data() >= end));
+		// case 2 works like STD string
+		const wstring key = v.o().begin()->first;
+		ASSERT_TRUE(key == L"b" && v.o().begin()->first == key && v.o().begin()->first != L"media");
+		ASSERT_TRUE(JSON::KeyW(L"ab") < JSON::KeyW(L"b") && JSON::KeyW(L"a") < JSON::KeyW(L"ab") && JSON::KeyW(wstring(L"a\0b", 3)).length() == 3);
+		// case 3 copy keeps cow keys, new keys are owned
+		JSON::ValueW v3(v);
+		ASSERT_TRUE(v3[L"media"].o().find(L"a_long_key_over_sso")->first.cow());
+		v3[L"media"][L"new"] = 3;
+		ASSERT_TRUE(!v3[L"media"].o().find(L"new")->first.cow() && v3[L"media"].o().size() == 3);
+		wstring out, out2;
+		v.write(out);
+		v2.write(out2);
+		ASSERT_TRUE(out == out2);
+		// case 4 duplicate key keeps the first key and the last value
+		ASSERT_TRUE(v.read(L"{\"a\":1,\"\\u0061\":2}", true) && v.o().size() == 1 && v[L"a"].i() == 2);
+		// case 5 in-situ and incremental reads, key split by chunks is copied
+		wstring buf(L"{\"k\\u0065y\":1,\"plain\":2}");
+		ASSERT_TRUE(v.read_insitu(buf) == buf.length());
+		ASSERT_TRUE(v.o().find(L"key")->first.cow() && v.o().find(L"key")->first.data() == buf.data() + 2);
+		JSON::IncrementalReaderW r(v, true);
+		ASSERT_TRUE(r.feed(in.data(), 15) == JSON::IncrementalReaderW::NEED_MORE);
+		ASSERT_TRUE(r.feed(in.data() + 15, in.length() - 15) == JSON::IncrementalReaderW::DONE);
+		ASSERT_TRUE(v == v2 && !v[L"media"].o().begin()->first.cow() && v.o().find(L"b")->first.cow());
+	}
+	catch(std::exception &e) {
+		printf("Error : %s.", e.what());
+		ASSERT_TRUE(false);
+	}
+}
+
+TEST(ut_xpjsonW, read_file)
+{
+	const char* path = "ut_xpjsonW_read_file.json";
+	try {
+		// normal cases
+		// case 1 document refers to the mapping
+		const wstring in(L" {\"media\":{\"title\":\"Javaone Keynote\",\"uri\":\"http:\\/\\/javaone.com\\/keynote.mpg\",\"width\":640},\"persons\":[\"Bill Gates\",\"Steve Jobs\"]}\n");
+		FILE* fp = fopen(path, "wb");
+		ASSERT_TRUE(fp && fwrite(in.data(), sizeof(wchar_t), in.length(), fp) == in.length());
+		fclose(fp);
+		JSON::ValueW v2;
+		const size_t ret = v2.read(in);
+		JSON::DocumentW doc;
+		ASSERT_TRUE(JSON::ReaderW::read_file(doc, path) == ret && doc == v2);
+		ASSERT_TRUE(doc.o().begin()->first.cow() && doc[L"media"][L"uri"].s() == L"http://javaone.com/keynote.mpg");
+		// case 2 value is copied
+		JSON::ValueW v;
+		ASSERT_TRUE(JSON::ReaderW::read_file(v, path) == ret && v == v2 && !v.o().begin()->first.cow());
+		// case 3 read again and close
+		fp = fopen(path, "wb");
+		ASSERT_TRUE(fp && fwrite(L"[1,2]", sizeof(wchar_t), 5, fp) == 5);
+		fclose(fp);
+		ASSERT_TRUE(doc.read_file(path) == 5 && doc.a().size() == 2 && doc[1].i() == 2);
+		doc.close();
+		ASSERT_TRUE(doc.type() == JSON::NIL);
+
+		// exception cases
+		// case 1 bad content, document is closed
+		const wchar_t* bad_cases[] = {L"", L"[1,", L"{\"a\":tru}", L" 1"};
+		for(size_t i = 0; i < sizeof(bad_cases) / sizeof(bad_cases[0]); ++i) {
+			fp = fopen(path, "wb");
+			ASSERT_TRUE(fp);
+			fwrite(bad_cases[i], sizeof(wchar_t), wcslen(bad_cases[i]), fp);
+			fclose(fp);
+			EXPECT_THROW(doc.read_file(path), std::logic_error);
+			ASSERT_TRUE(doc.type() == JSON::NIL);
+			EXPECT_THROW(JSON::ReaderW::read_file(v, path), std::logic_error);
+		}
+		// case 2 not a file
+		remove(path);
+		EXPECT_THROW(doc.read_file(path), std::logic_error);
+		EXPECT_THROW(JSON::ReaderW::read_file(v, "."), std::logic_error);
+	}
+	catch(std::exception &e) {
+		remove(path);
+		printf("Error : %s.", e.what());
+		ASSERT_TRUE(false);
+	}
+}
+
+TEST(ut_xpjsonW, read_stream)
+{
+	try {
+		// normal cases
+		// case 1 strings, numbers and literals split by blocks of any size
+		wstring in(L" {\"k\\u0065y\":[\"x\\ty\\ud83d\\ude00\\\\\",-12.5e-1,true,null,false,\"");
+		in.append(300, L'z');
+		in += L"\"],\"a\":{\"b\":[[],{}],\"\":12345678901234567890}} ";
+		JSON::ValueW v, v2;
+		const size_t ret = v2.read(in);
+		const size_t blocks[] = {1, 2, 3, 7, 64, 0x10000};
+		for(size_t i = 0; i < sizeof(blocks) / sizeof(blocks[0]); ++i) {
+			wistringstream is(in);
+			ASSERT_TRUE(JSON::ReaderW::read_stream(v, is, blocks[i]) == ret && v == v2);
+		}
+		// case 2 FILE*
+		FILE* fp = tmpfile();
+		ASSERT_TRUE(fp && fwrite(in.data(), sizeof(wchar_t), in.length(), fp) == in.length());
+		rewind(fp);
+		ASSERT_TRUE(JSON::ReaderW::read_stream(v, fp, 5) == ret && v == v2);
+		fclose(fp);
+		// case 3 next document follows in the next block
+		wistringstream is(L"[1]\n{\"a\":2}");
+		ASSERT_TRUE(JSON::ReaderW::read_stream(v, is, 4) == 3 && v[0].i() == 1);
+		ASSERT_TRUE(JSON::ReaderW::read_stream(v, is, 4) == 7 && v[L"a"].i() == 2);
+
+		// exception cases
+		const wchar_t* bad_cases[] = {L"", L"  ", L"[1,", L"[\"a", L"{\"a\":tru}", L"1", L"[1}"};
+		for(size_t i = 0; i < sizeof(bad_cases) / sizeof(bad_cases[0]); ++i) {
+			wistringstream bad(bad_cases[i]);
+			EXPECT_THROW(JSON::ReaderW::read_stream(v, bad, 2), std::logic_error);
+		}
+	}
+	catch(std::exception &e) {
+		printf("Error : %s.", e.what());
+		ASSERT_TRUE(false);
+	}
+}
+
+struct sax_stop_handlerW
+{
+	bool on_null() {return true;}
+	bool on_boolean(bool) {return true;}
+	bool on_int(int64_t i) {return i != 2;}
+	bool on_double(double) {return true;}
+	bool on_string(const wchar_t*, size_t) {return true;}
+	bool on_key(const wchar_t*, size_t) {return true;}
+	bool on_object_begin() {return true;}
+	bool on_object_end() {return true;}
+	bool on_array_begin() {return true;}
+	bool on_array_end() {return true;}
+};
+
+TEST(ut_xpjsonW, try_read)
+{
+	try {
+		// normal cases
+		// case 1 same as read
+		wstring in(L" {\"k\\u0065y\":[\"x\\ty\",-12.5e-1,true,null,false],\"a\":{}} ");
+		JSON::ValueW v, v2;
+		JSON::ReadResultW r = v.try_read(in);
+		ASSERT_TRUE(r.ok() && r.error == JSON::ERROR_NONE && r.offset == v2.read(in) && v == v2 && r.message().empty());
+		r = JSON::ReaderW::try_read(v, in.data(), in.length(), true);
+		ASSERT_TRUE(r.ok() && r.offset == in.length() - 1 && v == v2);
+		// case 2 SAX, stopped by handler is not an error
+		sax_stop_handlerW h;
+		r = JSON::ReaderW::try_parse(h, L"[1,2,3]", 7);
+		ASSERT_TRUE(r.ok() && r.offset == 4);
+
+		// error cases, and where they are found
+		struct {const wchar_t* in; JSON::Error error; size_t offset;} bad_cases[] = {
+			{L"  ", JSON::ERROR_END, 2},
+			{L"[1,", JSON::ERROR_END, 3},
+			{L"{\"a", JSON::ERROR_END, 3},
+			{L"[\"a", JSON::ERROR_END, 3},
+			{L"1", JSON::ERROR_SYNTAX, 0},
+			{L"[1}", JSON::ERROR_SYNTAX, 2},
+			{L"{\"a\" 1}", JSON::ERROR_SYNTAX, 5},
+			{L"[1,tru]", JSON::ERROR_SYNTAX, 3},
+			{L"[\"a\\x\"]", JSON::ERROR_STRING, 4},
+			{L"{\"\\ud800\":1}", JSON::ERROR_STRING, 3},
+			{L"[-]", JSON::ERROR_NUMBER, 2},
+			{L"[1.e5]", JSON::ERROR_NUMBER, 3},
+			{L"[01]", JSON::ERROR_NUMBER, 2},
+		};
+		for(size_t i = 0; i < sizeof(bad_cases) / sizeof(bad_cases[0]); ++i) {
+			in = bad_cases[i].in;
+			r = v.try_read(in);
+			EXPECT_TRUE(!r.ok() && r.error == bad_cases[i].error && r.offset == bad_cases[i].offset) << in;
+			EXPECT_TRUE(r.message().find(JSON::get_error_name(r.error)) != string::npos);
+			EXPECT_THROW(v.read(in), std::logic_error);
+			r = JSON::ReaderW::try_parse(h, in.data(), in.length());
+			EXPECT_TRUE(!r.ok() && r.error == bad_cases[i].error && r.offset == bad_cases[i].offset) << in;
+		}
+		// nested too deep
+		in = wstring(__XPJSON_MAX_DEPTH__ + 1, L'[') + wstring(__XPJSON_MAX_DEPTH__ + 1, L']');
+		r = v.try_read(in);
+		ASSERT_TRUE(r.error == JSON::ERROR_DEPTH && r.offset == __XPJSON_MAX_DEPTH__);
+		ASSERT_TRUE(r.message().find("Too deep") != string::npos);
+	}
+	catch(std::exception &e) {
+		printf("Error : %s.", e.what());
+		ASSERT_TRUE(false);
+	}
+}
+
+TEST(ut_xpjsonW, validate)
+{
+	try {
+		// normal cases
+		// case 1 same as read
+		wstring in(L" {\"k\\u0065y\":[\"x\\ty\\ud83d\\ude00\",-12.5e-1,true,null,false,[{}]],\"a\":{\"b\":0}} ");
+		JSON::ValueW v;
+		size_t depth = 0;
+		JSON::ReadResultW r = JSON::ReaderW::validate(in, &depth);
+		ASSERT_TRUE(r.ok() && r.offset == v.read(in) && depth == 4);
+		// case 2 same errors as try_read
+		const wchar_t* bad_cases[] = {L"", L"[1,", L"{\"a\":1", L"[\"a\\", L"1", L"[1}", L"{\"a\" 1}", L"[1,tru]", L"[\"\\x\"]", L"[\"\\u12\"]", L"[-]", L"[1.]", L"[1e+]", L"[01]", L"[1,]", L"{\"a\":1,}"};
+		for(size_t i = 0; i < sizeof(bad_cases) / sizeof(bad_cases[0]); ++i) {
+			in = bad_cases[i];
+			r = JSON::ReaderW::validate(in);
+			JSON::ReadResultW r2 = v.try_read(in);
+			EXPECT_TRUE(r.error == r2.error && r.offset == r2.offset) << in;
+#if !__XPJSON_SUPPORT_DANGLING_COMMA__
+			EXPECT_FALSE(r.ok()) << in;
+#endif
+		}
+		// case 3 depth limit
+		in = wstring(__XPJSON_MAX_DEPTH__, L'[') + wstring(__XPJSON_MAX_DEPTH__, L']');
+		ASSERT_TRUE(JSON::ReaderW::validate(in, &depth).ok() && depth == __XPJSON_MAX_DEPTH__);
+		in = L"[" + in + L"]";
+		r = JSON::ReaderW::validate(in);
+		ASSERT_TRUE(r.error == JSON::ERROR_DEPTH && r.offset == __XPJSON_MAX_DEPTH__);
+	}
+	catch(std::exception &e) {
+		printf("Error : %s.", e.what());
+		ASSERT_TRUE(false);
+	}
+}
+
+TEST(ut_xpjsonW, read_limits)
+{
+	try {
+		// normal cases
+		// case 1 usage counted within budget
+		wstring in(L"{\"a\":[1,\"xy\",{}],\"b\":\"0123456789abcdefghij\"}");
+		JSON::ValueW v, v2;
+		JSON::ReadLimits limits(8, 16, 64 * sizeof(wchar_t), 1024 * 1024);
+		JSON::ReadResultW r = v.try_read(in.data(), in.size(), limits);
+		v2.read(in);
+		ASSERT_TRUE(r.ok() && r.offset == in.size() && v == v2);
+		ASSERT_TRUE(limits.exceeded == JSON::LIMIT_NONE && limits.nodes == 6 && limits.string_bytes == 24 * sizeof(wchar_t) && limits.alloc_bytes > 0);
+		// case 2 zero means unlimited, usage reset on every read
+		JSON::ReadLimits unlimited;
+		ASSERT_TRUE(v.read(in.data(), in.size(), unlimited) == in.size() && unlimited.nodes == 6);
+		ASSERT_TRUE(v.read(in.data(), in.size(), unlimited) == in.size() && unlimited.nodes == 6);
+		// case 3 max depth
+		in = L"[[[[1]]]]";
+		limits = JSON::ReadLimits(3);
+		r = v.try_read(in.data(), in.size(), limits);
+		ASSERT_TRUE(r.error == JSON::ERROR_DEPTH && r.offset == 3 && limits.exceeded == JSON::LIMIT_DEPTH);
+		limits = JSON::ReadLimits(4);
+		ASSERT_TRUE(v.try_read(in.data(), in.size(), limits).ok() && limits.exceeded == JSON::LIMIT_NONE);
+		// case 4 max nodes, stops fast at the first node over
+		in = L"{\"a\":1,\"b\":2,\"c\":3,\"d\":4}";
+		limits = JSON::ReadLimits(0, 3);
+		r = v.try_read(in.data(), in.size(), limits);
+		ASSERT_TRUE(r.error == JSON::ERROR_LIMIT && r.offset == in.find(L"\"c\"") + 2 && limits.exceeded == JSON::LIMIT_NODES && limits.nodes == 4);
+		// case 5 max string bytes, keys and values
+		in = L"[\"abc\",\"def\"]";
+		limits = JSON::ReadLimits(0, 0, 5 * sizeof(wchar_t));
+		r = v.try_read(in.data(), in.size(), limits);
+		ASSERT_TRUE(r.error == JSON::ERROR_LIMIT && limits.exceeded == JSON::LIMIT_STRING_BYTES && limits.string_bytes == 6 * sizeof(wchar_t));
+		in = L"{\"abcdef\":1}";
+		r = v.try_read(in.data(), in.size(), limits);
+		ASSERT_TRUE(r.error == JSON::ERROR_LIMIT && limits.exceeded == JSON::LIMIT_STRING_BYTES);
+		// case 6 max allocated bytes
+		in = L"[1";
+		for(int i = 0; i < 1000; ++i) in += L",1";
+		in += L"]";
+		limits = JSON::ReadLimits(0, 0, 0, 1024);
+		r = v.try_read(in.data(), in.size(), limits);
+		ASSERT_TRUE(r.error == JSON::ERROR_LIMIT && limits.exceeded == JSON::LIMIT_ALLOC_BYTES && limits.alloc_bytes > 1024 && r.offset < in.size() / 2);
+		// case 7 read throws with message
+		try {
+			v.read(in.data(), in.size(), limits);
+			ASSERT_TRUE(false);
+		}
+		catch(std::exception &e) {
+			ASSERT_TRUE(limits.exceeded == JSON::LIMIT_ALLOC_BYTES && string(e.what()).find("Limit exceeded") != string::npos);
+		}
+		// case 8 same as Reader
+		limits = JSON::ReadLimits(0, 10);
+		r = JSON::ReaderW::try_read(v, in.data(), in.size(), limits);
+		ASSERT_TRUE(r.error == JSON::ERROR_LIMIT && limits.exceeded == JSON::LIMIT_NODES);
+	}
+	catch(std::exception &e) {
+		printf("Error : %s.", e.what());
+		ASSERT_TRUE(false);
+	}
+}
+
+TEST(ut_xpjsonW, read_reuse)
+{
+	try {
+		// normal cases
+		// case 1 same shape, members, elements and strings are kept in place
+		wstring in(L"{\"id\":1,\"name\":\"a name longer than sso\",\"tags\":[\"x\",{\"k\":\"v\"}],\"obj\":{\"a\":null}}");
+		JSON::ValueW v, v2;
+		ASSERT_TRUE(v.read_reuse(in) == in.size());
+		v2.read(in);
+		ASSERT_TRUE(v == v2);
+		const JSON::ValueW* name = &v[L"name"];
+		const wchar_t* s = v[L"name"].c_str();
+		const JSON::ValueW* tag = &v[L"tags"][1];
+		in = L"{\"obj\":{\"a\":true},\"tags\":[\"y\",{\"k\":\"w\"}],\"name\":\"b name longer than sso\",\"id\":2}";
+		ASSERT_TRUE(JSON::ReaderW::read_reuse(v, in) == in.size());
+		v2.read(in);
+		ASSERT_TRUE(v == v2 && &v[L"name"] == name && v[L"name"].c_str() == s && &v[L"tags"][1] == tag);
+		// case 2 other shapes, missing members and elements erased, types changed
+		in = L"{\"id\":\"3\",\"tags\":[1],\"new\":[],\"obj\":[{}]}";
+		ASSERT_TRUE(v.read_reuse(in) == in.size());
+		v2.read(in);
+		ASSERT_TRUE(v == v2 && v.o().size() == 4 && v[L"tags"].a().size() == 1);
+		in = L" [1,[2,3],{\"a\":\"b\\n\"}] ";
+		ASSERT_TRUE(v.read_reuse(in) == in.size() - 1);
+		v2.read(in);
+		ASSERT_TRUE(v == v2);
+		// case 3 duplicate key overrides as read
+		in = L"{\"a\":[1,2],\"a\":[3]}";
+		v.read_reuse(in);
+		v2.read(in);
+		ASSERT_TRUE(v == v2);
+		// case 4 errors same as try_read, next read is whole
+		const wchar_t* bad_cases[] = {L"", L"[1,", L"{\"a\":1", L"[\"\\x\"]", L"{\"a\" 1}", L"[1}"};
+		for(size_t i = 0; i < sizeof(bad_cases) / sizeof(bad_cases[0]); ++i) {
+			in = bad_cases[i];
+			JSON::ReadResultW r = v.try_read_reuse(in);
+			JSON::ReadResultW r2 = v2.try_read(in);
+			EXPECT_TRUE(!r.ok() && r.error == r2.error && r.offset == r2.offset) << in;
+		}
+		in = L"{\"a\":[1,2]}";
+		ASSERT_TRUE(JSON::ReaderW::try_read_reuse(v, in.data(), in.size()).ok());
+		v2.read(in);
+		ASSERT_TRUE(v == v2);
+	}
+	catch(std::exception &e) {
+		printf("Error : %s.", e.what());
+		ASSERT_TRUE(false);
+	}
+}
@@ -12,10 +12,14 @@
 #include <cstdlib>
 #include <string>
 #include <cstring>
+#include <cwchar>
 #include <deque>
+#include <vector>
 #include <map>
 #include <cmath>
 #include <cfloat>
+#include <climits>
+#include <clocale>
 #include <stdexcept>
 #include <algorithm>
 
@@ -24,6 +28,37 @@
 #	define __XPJSON_SUPPORT_DANGLING_COMMA__ 0
 #endif
 
+// max nesting depth of objects and arrays, deeper documents are rejected by reader
+#ifndef __XPJSON_MAX_DEPTH__
+#	define __XPJSON_MAX_DEPTH__ 1024
+#endif
+
+// use SIMD intrinsics for scanning : 0 - scalar only, 1 - SSE2, 2 - AVX2
+#ifndef __XPJSON_SUPPORT_SIMD__
+#	if defined(__AVX2__)
+#		define __XPJSON_SUPPORT_SIMD__ 2
+#	elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#		define __XPJSON_SUPPORT_SIMD__ 1
+#	else
+#		define __XPJSON_SUPPORT_SIMD__ 0
+#	endif
+#endif
+
+#if __XPJSON_SUPPORT_SIMD__ >= 2
+#	include <immintrin.h>
+#elif __XPJSON_SUPPORT_SIMD__ >= 1
+#	include <emmintrin.h>
+#endif
+
+// byte order, SWAR(several chars packed in a word) scanning is only used on little endian
+#ifndef __XPJSON_LITTLE_ENDIAN__
+#	if (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) || defined(_MSC_VER)
+#		define __XPJSON_LITTLE_ENDIAN__ 1
+#	else
+#		define __XPJSON_LITTLE_ENDIAN__ 0
+#	endif
+#endif
+
 #if defined(__clang__)
 #	ifndef __has_extension
 #		define __has_extension __has_feature
@@ -31,14 +66,61 @@
 #	if __has_extension(__cxx_rvalue_references__)
 #		define __XPJSON_SUPPORT_MOVE__
 #	endif
+#	if __has_extension(__cxx_deleted_functions__)
+#		define __XPJSON_SUPPORT_DELETE__
+#	endif
 #elif defined(__GNUC__)
 #	if defined(_GXX_EXPERIMENTAL_CXX0X__) || __cplusplus >= 201103L
 #		if (__GNUC__ * 10000 + __GNUC_MINOR__ * 100) >= 40600
 #			define __XPJSON_SUPPORT_MOVE__
+#			define __XPJSON_SUPPORT_DELETE__
 #		endif
 #	endif
 #elif _MSC_VER >= 1600
 #	define __XPJSON_SUPPORT_MOVE__
+#	if _MSC_VER >= 1800
+#		define __XPJSON_SUPPORT_DELETE__
+#	endif
+#endif
+
+// Threads for batch reading, e.g. ReaderT::read_lines, define to 0 to read in calling thread only.
+#ifndef __XPJSON_SUPPORT_THREAD__
+#	if __cplusplus >= 201103L || (defined(_MSC_VER) && _MSC_VER >= 1700)
+#		define __XPJSON_SUPPORT_THREAD__ 1
+#	else
+#		define __XPJSON_SUPPORT_THREAD__ 0
+#	endif
+#endif
+
+#if __XPJSON_SUPPORT_THREAD__
+#	include <thread>
+#	include <exception>
+#endif
+
+// map files by mmap for ReaderT::read_file, define to 0 to read them into memory instead.
+#ifndef __XPJSON_SUPPORT_MMAP__
+#	ifdef _WIN32
+#		define __XPJSON_SUPPORT_MMAP__ 0
+#	else
+#		define __XPJSON_SUPPORT_MMAP__ 1
+#	endif
+#endif
+
+#if __XPJSON_SUPPORT_MMAP__
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <fcntl.h>
+#	include <unistd.h>
+#endif
+
+// throw exceptions on errors, 0 for -fno-exceptions : errors of try_read, try_parse, read_lines and parse_lines
+// are still returned, others print the message and abort
+#ifndef __XPJSON_SUPPORT_EXCEPTIONS__
+#	if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+#		define __XPJSON_SUPPORT_EXCEPTIONS__ 1
+#	else
+#		define __XPJSON_SUPPORT_EXCEPTIONS__ 0
+#	endif
 #endif
 
 #ifdef _WIN32
@@ -54,8 +136,14 @@
 
 #	define PRId64       "I64d"
 #	define LPRId64 		L"I64d"
+
+#	ifndef __XPJSON_NO_IOVEC__
+	// same layout as POSIX, define __XPJSON_NO_IOVEC__ if already defined elsewhere
+	struct iovec {void* iov_base; size_t iov_len;};
+#	endif
 #else
 #	include <inttypes.h>
+#	include <sys/uio.h>
 #	define LPRId64 		L"lld"
 #endif
 
@@ -64,6 +152,7 @@
 #	pragma warning(disable:4800)
 // disable deprecated interface warnings
 #	pragma warning(disable:4996)
+#	include <intrin.h>
 #	define XPJSON_LIKELY(x)         (x)
 #	define XPJSON_UNLIKELY(x)       (x)
 #else
@@ -77,15 +166,24 @@
 #	define JSON_TSTRING(type)			std::basic_string<type>
 #endif
 
+#if __XPJSON_SUPPORT_EXCEPTIONS__
+#	define JSON_THROW(e)	throw e
+#else
+#	define JSON_THROW(e)	{fprintf(stderr, "%s\n", (e).what()); abort();}
+#endif
+
 #define JSON_ASSERT_CHECK(expression, exception_type, what)	\
-	if(XPJSON_UNLIKELY(!(expression))) {throw exception_type(what);}
+	if(XPJSON_UNLIKELY(!(expression))) {JSON_THROW(exception_type(what));}
 #define JSON_ASSERT_CHECK1(expression, fmt, arg1)		\
-	if(XPJSON_UNLIKELY(!(expression))) {char what[0x100] = {0}; sprintf(what, fmt"(line:%d)", arg1, __LINE__); throw std::logic_error(what);}
+	if(XPJSON_UNLIKELY(!(expression))) {char what[0x100] = {0}; sprintf(what, fmt"(line:%d)", arg1, __LINE__); JSON_THROW(std::logic_error(what));}
 #define JSON_ASSERT_CHECK2(expression, fmt, arg1, arg2)	\
-	if(XPJSON_UNLIKELY(!(expression))) {char what[0x100] = {0}; sprintf(what, fmt"(line:%d)", arg1, arg2, __LINE__); throw std::logic_error(what);}
+	if(XPJSON_UNLIKELY(!(expression))) {char what[0x100] = {0}; sprintf(what, fmt"(line:%d)", arg1, arg2, __LINE__); JSON_THROW(std::logic_error(what));}
 #define JSON_CHECK_TYPE(type, except) JSON_ASSERT_CHECK2(type == except, "Type error: except(%s), actual(%s).", get_type_name(except), get_type_name(type))
-#define JSON_PARSE_CHECK(expression)  JSON_ASSERT_CHECK2(expression, "Parse error: in=%.50s pos=%zu.", detail::get_cstr(in, len).c_str (), pos)
-#define JSON_DECODE_CHECK(expression) JSON_ASSERT_CHECK1(expression, "Decode error: in=%.50s.", detail::get_cstr(in, len).c_str ())
+// only 50 chars are printed, so only convert them
+#define JSON_PARSE_CHECK(expression)  JSON_ASSERT_CHECK2(expression, "Parse error: in=%.50s pos=%zu.", detail::get_cstr(in, len < 50 ? len : 50).c_str (), pos)
+// parsers reporting errors by err: record error and return 0, or throw it if err is NULL
+#define JSON_READ_CHECK(expression, error)	\
+	if(XPJSON_UNLIKELY(!(expression))) {return detail::read_fail(err, error, in, len, pos, __LINE__);}
 
 #ifdef __XPJSON_SUPPORT_MOVE__
 #	define JSON_MOVE(statement)		std::move(statement)
@@ -103,6 +201,52 @@ typedef enum ESCAPE_TYPE {
 
 namespace JSON
 {
+	/** Error of reading, see ValueT::try_read. */
+	enum Error
+	{
+		ERROR_NONE,    // Succeeded
+		ERROR_END,     // Document not finished
+		ERROR_SYNTAX,  // Unexpected character
+		ERROR_STRING,  // Bad escape in string
+		ERROR_NUMBER,  // Bad number
+		ERROR_DEPTH,   // Nested deeper than __XPJSON_MAX_DEPTH__, or max_depth of ReadLimits
+		ERROR_LIMIT    // Other budget of ReadLimits exceeded
+	};
+
+	inline const char* get_error_name(int error);
+
+	/** Budget of ReadLimits exceeded. */
+	enum Limit
+	{
+		LIMIT_NONE,
+		LIMIT_DEPTH,
+		LIMIT_NODES,
+		LIMIT_STRING_BYTES,
+		LIMIT_ALLOC_BYTES
+	};
+
+	/**
+		Budgets of one read against hostile input, 0 for unlimited. Read stops as soon as one is exceeded,
+		by at most one value, and exceeded tells which. Usage is counted from 0 by every read.
+	*/
+	struct ReadLimits
+	{
+		ReadLimits(size_t depth = 0, size_t nodes = 0, size_t string_bytes = 0, size_t alloc_bytes = 0)
+			: max_depth(depth), max_nodes(nodes), max_string_bytes(string_bytes), max_alloc_bytes(alloc_bytes)
+			, nodes(0), string_bytes(0), alloc_bytes(0), exceeded(LIMIT_NONE) {}
+
+		size_t max_depth;        // nesting depth, topmost is 1, __XPJSON_MAX_DEPTH__ at most
+		size_t max_nodes;        // values, topmost included
+		size_t max_string_bytes; // of strings and keys as in input
+		size_t max_alloc_bytes;  // heap bytes of containers, elements, members and strings, estimated
+
+		// usage of last read, till where it stopped if failed
+		size_t nodes;
+		size_t string_bytes;
+		size_t alloc_bytes;
+		Limit exceeded;
+	};
+
 	namespace detail
 	{
 		// type traits
@@ -155,17 +299,79 @@ namespace JSON
 		template<> inline JSON_TSTRING(char) get_cstr<wchar_t>(const wchar_t* str, size_t len)
 		{
 			JSON_TSTRING(char) out;
-			out.resize(len * sizeof(wchar_t));
+			out.resize(len * MB_CUR_MAX);
 			size_t l = 0;
-			while(len--) l += wctomb(&out[l], *str++);
+			while(len--) {
+				const int n = wctomb(&out[l], *str++);
+				// not convertible under current locale
+				if(n > 0) l += n; else out[l++] = '?';
+			}
 			out.resize(l);
 			return JSON_MOVE(out);
 		}
 
+		/* Error reported by parser instead of thrown, at is where it is found. */
+		template<class char_t>
+		struct read_error
+		{
+			Error code;
+			const char_t* at;
+			int line;
+		};
+
+		/* Message of error found at in[pos], 50 chars from there are printed. */
+		template<class char_t>
+		JSON_TSTRING(char) error_message(Error code, const char_t* in, size_t len, size_t pos, int line)
+		{
+			char what[0x100] = {0};
+			sprintf(what, "Parse error: %s, pos=%lu near=%.50s.(line:%d)", get_error_name(code), (unsigned long)pos,
+				get_cstr(in + pos, std::min(len - pos, (size_t)50)).c_str(), line);
+			return what;
+		}
+
+		/* Add usage to limits, false if a budget is exceeded, which is recorded. */
+		inline bool charge(ReadLimits& l, size_t nodes, size_t string_bytes, size_t alloc_bytes)
+		{
+			l.nodes += nodes;
+			l.string_bytes += string_bytes;
+			l.alloc_bytes += alloc_bytes;
+			if(l.max_nodes && l.nodes > l.max_nodes) l.exceeded = LIMIT_NODES;
+			else if(l.max_string_bytes && l.string_bytes > l.max_string_bytes) l.exceeded = LIMIT_STRING_BYTES;
+			else if(l.max_alloc_bytes && l.alloc_bytes > l.max_alloc_bytes) l.exceeded = LIMIT_ALLOC_BYTES;
+			else return true;
+			return false;
+		}
+
+		/* Error of nesting too deep, recorded into limits if any. */
+		inline Error depth_error(ReadLimits* limits)
+		{
+			if(limits) limits->exceeded = LIMIT_DEPTH;
+			return ERROR_DEPTH;
+		}
+
+		/* Record error at in[pos] into err and return 0, or throw it if err is NULL. */
+		template<class char_t>
+		size_t read_fail(read_error<char_t>* err, Error code, const char_t* in, size_t len, size_t pos, int line)
+		{
+			if(XPJSON_LIKELY(err != NULL)) {
+				err->code = code;
+				err->at = in + std::min(pos, len);
+				err->line = line;
+				return 0;
+			}
+			JSON_THROW(std::logic_error(error_message(code, in, len, std::min(pos, len), line)));
+			return 0;
+		}
+
 		template<class char_t> size_t tcslen(const char_t* str);
 		template<> inline size_t tcslen<char>(const char* str) {return strlen(str);}
 		template<> inline size_t tcslen<wchar_t>(const wchar_t* str) {return wcslen(str);}
 
+		// memchr is vectorized by libc
+		template<class char_t> const char_t* find_newline(const char_t* s, size_t n);
+		template<> inline const char* find_newline<char>(const char* s, size_t n) {return (const char*)memchr(s, '\n', n);}
+		template<> inline const wchar_t* find_newline<wchar_t>(const wchar_t* s, size_t n) {return wmemchr(s, L'\n', n);}
+
 		template<class char_t> int tcsncmp(const char_t* t, const char_t* s, size_t n);
 		template<> inline int tcsncmp<char>(const char* t, const char* s, size_t n) {return strncmp(t, s, n);}
 		template<> inline int tcsncmp<wchar_t>(const wchar_t* t, const wchar_t* s, size_t n) {return wcsncmp(t, s, n);}
@@ -290,113 +496,1307 @@ template<> inline void to_string<type, char_t>(type v, JSON_TSTRING(char_t)& out
 			}
 		}
 
-		inline int hex_to_int(int ch)
+		// value of hex digit, -1 if ch is not
+		inline int hex_value(int ch)
 		{
-			if('0' <= ch && ch <= '9') return (ch - '0');
-			else if('a' <= ch && ch <= 'f') return (ch - 'a' + 10);
-			else if('A' <= ch && ch <= 'F') return (ch - 'A' + 10);
-			JSON_ASSERT_CHECK1(false, "Decode error: invalid character=0x%x.", ch);
+			static const signed char hex_table[256] = {
+				-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+				-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+				-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+				 0,  1,  2,  3,  4,  5,  6,  7,  8,  9, -1, -1, -1, -1, -1, -1,
+				-1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+				-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+				-1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+				-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+				-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+				-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+				-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+				-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+				-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+				-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+				-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+				-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+			};
+			return (unsigned(ch) < 0x100) ? hex_table[ch] : -1;
 		}
 
+		/* Value of 4 hex digits, -1 if invalid. */
 		template<class char_t>
-		inline unsigned short hex_to_ushort(const char_t* in, size_t len)
+		inline int hex_to_ushort(const char_t* in, size_t len)
 		{
-			JSON_DECODE_CHECK(len >= 4);
-			unsigned char highByte = (hex_to_int(in[0]) << 4) | hex_to_int(in[1]);
-			unsigned char lowByte = (hex_to_int(in[2]) << 4) | hex_to_int(in[3]);
-			return (highByte << 8) | lowByte;
+			if(XPJSON_UNLIKELY(len < 4)) return -1;
+			const int h0 = hex_value(in[0]), h1 = hex_value(in[1]), h2 = hex_value(in[2]), h3 = hex_value(in[3]);
+			// only check once for all valid
+			if(XPJSON_UNLIKELY((h0 | h1 | h2 | h3) < 0)) return -1;
+			return (h0 << 12) | (h1 << 8) | (h2 << 4) | h3;
 		}
 
-		template<class char_t> void decode_unicode_append(unsigned int ui, JSON_TSTRING(char_t)& out);
-		template<> inline void decode_unicode_append<wchar_t>(unsigned int ui, JSON_TSTRING(wchar_t)& out) {out += ui;}
-		template<> inline void decode_unicode_append<char>(unsigned int ui, JSON_TSTRING(char)& out)
+		/* Chars of code point written to buf, 6 at most. */
+		template<class char_t> int unicode_to_chars(unsigned int ui, char_t* buf);
+		template<> inline int unicode_to_chars<wchar_t>(unsigned int ui, wchar_t* buf) {buf[0] = ui; return 1;}
+		template<> inline int unicode_to_chars<char>(unsigned int ui, char* buf)
 		{
-			const size_t len = out.length();
 			if(ui <= 0x0000007F) {
-				out.resize(len + 1);
-				out[len] = (ui & 0x7F);
-			}
-			else if(ui >= 0x00000080 && ui <= 0x000007FF) {
-				out.resize(len + 2);
-				out[len + 1] = (ui & 0x3F)        | 0x80;
-				out[len    ] = ((ui >> 6) & 0x1F) | 0xC0;
-			}
-			else if(ui >= 0x00000800 && ui <= 0x0000FFFF) {
-				out.resize(len + 3);
-				out[len + 2] = (ui & 0x3F)         | 0x80;
-				out[len + 1] = ((ui >>  6) & 0x3F) | 0x80;
-				out[len    ] = ((ui >> 12) & 0x0F) | 0xE0;
-			}
-			else if(ui >= 0x00010000 && ui <= 0x001FFFFF) {
-				out.resize(len + 4);
-				out[len + 3] = (ui & 0x3F)         | 0x80;
-				out[len + 2] = ((ui >>  6) & 0x3F) | 0x80;
-				out[len + 1] = ((ui >> 12) & 0x3F) | 0x80;
-				out[len    ] = ((ui >> 18) & 0x07) | 0xF0;
-			}
-			else if(ui >= 0x00200000 && ui <= 0x03FFFFFF) {
-				out.resize(len + 5);
-				out[len + 4] = (ui & 0x3F)         | 0x80;
-				out[len + 3] = ((ui >>  6) & 0x3F) | 0x80;
-				out[len + 2] = ((ui >> 12) & 0x3F) | 0x80;
-				out[len + 1] = ((ui >> 18) & 0x3F) | 0x80;
-				out[len    ] = ((ui >> 24) & 0x03) | 0xF8;
-			}
-			else if(ui >= 0x04000000 && ui <= 0x7FFFFFFF) {
-				out.resize(len + 6);
-				out[len + 5] = (ui & 0x3F)         | 0x80;
-				out[len + 4] = ((ui >>  6) & 0x3F) | 0x80;
-				out[len + 3] = ((ui >> 12) & 0x3F) | 0x80;
-				out[len + 2] = ((ui >> 18) & 0x3F) | 0x80;
-				out[len + 1] = ((ui >> 24) & 0x3F) | 0x80;
-				out[len    ] = ((ui >> 30) & 0x01) | 0xFC;
+				buf[0] = static_cast<char>(ui);
+				return 1;
 			}
+			static const unsigned char lead[7] = {0x00, 0x00, 0xC0, 0xE0, 0xF0, 0xF8, 0xFC};
+			int n;
+			if(ui <= 0x000007FF)      n = 2;
+			else if(ui <= 0x0000FFFF) n = 3;
+			else if(ui <= 0x001FFFFF) n = 4;
+			else if(ui <= 0x03FFFFFF) n = 5;
+			else if(ui <= 0x7FFFFFFF) n = 6;
+			else return 0;
+			// fill trailing bytes backward
+			for(int i = n - 1; i > 0; --i, ui >>= 6) buf[i] = static_cast<char>((ui & 0x3F) | 0x80);
+			buf[0] = static_cast<char>(ui | lead[n]);
+			return n;
 		}
 
-		template<class char_t>
-		inline size_t decode_unicode(const char_t* in, size_t len, JSON_TSTRING(char_t)& out)
+		/* Decode hex digits after \\u, return count of them, 0 if invalid. */
+		template<class char_t, class out_t>
+		inline size_t decode_unicode(const char_t* in, size_t len, out_t& out)
 		{
-			unsigned int ui = hex_to_ushort(in, len);
+			const int hi = hex_to_ushort(in, len);
+			if(XPJSON_UNLIKELY(hi < 0)) return 0;
+			unsigned int ui = hi;
+			size_t ret = 4;
 			if(ui >= 0xD800 && ui < 0xDC00) {
-				JSON_DECODE_CHECK(len >= 6 && in[4] == '\\' && in[5] == 'u');
+				const int lo = (len >= 6 && in[4] == '\\' && in[5] == 'u') ? hex_to_ushort(in + 6, len - 6) : -1;
+				if(XPJSON_UNLIKELY(lo < 0)) return 0;
 				ui = (ui & 0x3FF) << 10;
-				ui += (hex_to_ushort(in + 6, len - 6) & 0x3FF) + 0x10000;
-				decode_unicode_append<char_t>(ui, out);
-				return 10;
+				ui += (lo & 0x3FF) + 0x10000;
+				ret = 10;
 			}
-			decode_unicode_append<char_t>(ui, out);
-			return 4;
+			// append at once
+			char_t buf[6];
+			out.append(buf, unicode_to_chars(ui, buf));
+			return ret;
 		}
 
+		/* Output of decode into the decoded buffer itself, decoded string is never longer. */
 		template<class char_t>
-		inline void decode(const char_t* in, size_t len, JSON_TSTRING(char_t)& out)
+		struct insitu_buffer
+		{
+			char_t* p;
+			size_t n;
+			insitu_buffer(char_t* s) : p(s), n(0) {}
+			inline size_t length() const {return n;}
+			inline void reserve(size_t) {}
+			inline void append(const char_t* s, size_t l) {if(p + n != s) memmove(p + n, s, l * sizeof(char_t)); n += l;}
+			inline insitu_buffer& operator+=(char_t ch) {p[n++] = ch; return *this;}
+		};
+
+		/* Decode escaped string, appended to out, a tstring or insitu_buffer. false if bad escape, see read_fail. */
+		template<class char_t, class out_t>
+		inline bool decode(const char_t* in, size_t len, out_t& out, read_error<char_t>* err = NULL)
 		{
-			for(size_t pos = 0; pos < len; ++pos) {
+			// decoded string is never longer than the encoded one
+			out.reserve(out.length() + len);
+			size_t pos = 0;
+			while(pos < len) {
+				if(in[pos] != '\\') {
+					// copy the run before next backslash at once
+					const char_t* esc = std::char_traits<char_t>::find(in + pos + 1, len - pos - 1, '\\');
+					const size_t end = esc ? esc - in : len;
+					out.append(in + pos, end - pos);
+					if((pos = end) == len) break;
+				}
+				JSON_READ_CHECK(pos + 1 < len, ERROR_STRING);
+				++pos;
 				switch(in[pos]) {
-					case '\\':
-						JSON_PARSE_CHECK(pos + 1 < len);
-						++pos;
-						switch(in[pos]) {
-							case '\"': out += '\"'; break;
-							case '\\': out += '\\'; break;
-							case '/':  out += '/';  break;
-							case 'b':  out += '\b'; break;
-							case 'f':  out += '\f'; break;
-							case 'n':  out += '\n'; break;
-							case 'r':  out += '\r'; break;
-							case 't':  out += '\t'; break;
-							case 'u':  pos += decode_unicode<char_t>(in + pos + 1, len - pos - 1, out); break;
-							default: JSON_PARSE_CHECK(false);
-						}
+					case '\"': out += '\"'; break;
+					case '\\': out += '\\'; break;
+					case '/':  out += '/';  break;
+					case 'b':  out += '\b'; break;
+					case 'f':  out += '\f'; break;
+					case 'n':  out += '\n'; break;
+					case 'r':  out += '\r'; break;
+					case 't':  out += '\t'; break;
+					case 'u': {
+						const size_t n = decode_unicode(in + pos + 1, len - pos - 1, out);
+						JSON_READ_CHECK(n, ERROR_STRING);
+						pos += n;
 						break;
-					default: out += in[pos]; break;
+					}
+					default: JSON_READ_CHECK(false, ERROR_STRING);
 				}
+				++pos;
 			}
+			return true;
 		}
 
 		template<class char_t> bool check_need_conv(char_t ch);
 		template<> inline bool check_need_conv<char>(char ch) {return ch < 0x20 || ch == '\\' || ch == '\"' || ch == '/';}
 		template<> inline bool check_need_conv<wchar_t>(wchar_t ch) {return ch < 0x20 || ch > 0x7F || ch == '\\' || ch == '\"' || ch == '/';}
+
+		// count trailing zero bits, x MUST NOT be zero
+		inline int ctz64(uint64_t x)
+		{
+#if defined(_MSC_VER) && defined(_WIN64)
+			unsigned long r;
+			_BitScanForward64(&r, x);
+			return (int)r;
+#elif defined(_MSC_VER)
+			unsigned long r;
+			if(_BitScanForward(&r, (unsigned long)x)) return (int)r;
+			_BitScanForward(&r, (unsigned long)(x >> 32));
+			return (int)r + 32;
+#else
+			return __builtin_ctzll(x);
+#endif
+		}
+
+#if __XPJSON_SUPPORT_SIMD__ >= 1
+		// bitmask of 16 chars need conversion, the same as check_need_conv<char>
+		inline unsigned need_conv_mask(const char* in)
+		{
+			const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+#if CHAR_MIN < 0
+			const __m128i ctrl = _mm_cmplt_epi8(v, _mm_set1_epi8(0x20));
+#else
+			const __m128i ctrl = _mm_cmpeq_epi8(_mm_min_epu8(v, _mm_set1_epi8(0x1F)), v);
+#endif
+			return unsigned(_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\"')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\\'))),
+														   _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('/')), ctrl))));
+		}
+		// bitmask of 16 chars are quote or backslash
+		inline unsigned quote_or_backslash_mask(const char* in)
+		{
+			const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+			return unsigned(_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\"')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\\')))));
+		}
+#endif
+#if __XPJSON_SUPPORT_SIMD__ >= 2
+		inline unsigned need_conv_mask32(const char* in)
+		{
+			const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in));
+#if CHAR_MIN < 0
+			const __m256i ctrl = _mm256_cmpgt_epi8(_mm256_set1_epi8(0x20), v);
+#else
+			const __m256i ctrl = _mm256_cmpeq_epi8(_mm256_min_epu8(v, _mm256_set1_epi8(0x1F)), v);
+#endif
+			return unsigned(_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\"')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\'))),
+																 _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('/')), ctrl))));
+		}
+		inline unsigned quote_or_backslash_mask32(const char* in)
+		{
+			const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in));
+			return unsigned(_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\"')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\')))));
+		}
+#endif
+
+		// skip characters needn't conversion, return offset of first one needs(quote included) or len
+		template<class char_t>
+		inline size_t skip_plain(const char_t* in, size_t pos, size_t len)
+		{
+			while(pos < len && !check_need_conv<char_t>(in[pos])) ++pos;
+			return pos;
+		}
+
+		// return offset of first quote or backslash, or len if none
+		template<class char_t>
+		inline size_t find_quote_or_backslash(const char_t* in, size_t pos, size_t len)
+		{
+			while(pos < len && in[pos] != '\"' && in[pos] != '\\') ++pos;
+			return pos;
+		}
+
+#if __XPJSON_SUPPORT_SIMD__ >= 1
+		template<> inline size_t skip_plain<char>(const char* in, size_t pos, size_t len)
+		{
+			unsigned mask;
+#if __XPJSON_SUPPORT_SIMD__ >= 2
+			for(; pos + 32 <= len; pos += 32) {
+				if((mask = need_conv_mask32(in + pos))) return pos + ctz64(mask);
+			}
+#endif
+			for(; pos + 16 <= len; pos += 16) {
+				if((mask = need_conv_mask(in + pos))) return pos + ctz64(mask);
+			}
+			while(pos < len && !check_need_conv<char>(in[pos])) ++pos;
+			return pos;
+		}
+
+		template<> inline size_t find_quote_or_backslash<char>(const char* in, size_t pos, size_t len)
+		{
+			unsigned mask;
+#if __XPJSON_SUPPORT_SIMD__ >= 2
+			for(; pos + 32 <= len; pos += 32) {
+				if((mask = quote_or_backslash_mask32(in + pos))) return pos + ctz64(mask);
+			}
+#endif
+			for(; pos + 16 <= len; pos += 16) {
+				if((mask = quote_or_backslash_mask(in + pos))) return pos + ctz64(mask);
+			}
+			while(pos < len && in[pos] != '\"' && in[pos] != '\\') ++pos;
+			return pos;
+		}
+#endif
+
+		// JSON whitespace: space, \t, \n, \r
+		template<class char_t>
+		inline bool is_space(char_t ch)
+		{
+			return static_cast<uint64_t>(ch) <= ' ' && ((0x100002600ULL >> ch) & 1);
+		}
+
+		// skip whitespaces, return offset of first non-whitespace or len
+		template<class char_t>
+		inline size_t skip_ws(const char_t* in, size_t pos, size_t len)
+		{
+			while(pos < len && is_space(in[pos])) ++pos;
+			return pos;
+		}
+
+#if __XPJSON_SUPPORT_SIMD__ >= 1
+		// bitmask of 16 chars are not whitespace
+		inline unsigned non_ws_mask(const char* in)
+		{
+			const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+			const __m128i ws = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\n'))),
+											_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\r')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\t'))));
+			return unsigned(_mm_movemask_epi8(ws)) ^ 0xFFFF;
+		}
+
+		template<> inline size_t skip_ws<char>(const char* in, size_t pos, size_t len)
+		{
+			// most values are not preceded by whitespace
+			if(pos < len && !is_space(in[pos])) return pos;
+			unsigned mask;
+			for(; pos + 16 <= len; pos += 16) {
+				if((mask = non_ws_mask(in + pos))) return pos + ctz64(mask);
+			}
+			while(pos < len && is_space(in[pos])) ++pos;
+			return pos;
+		}
+#elif __XPJSON_LITTLE_ENDIAN__
+		// 0x80 in each byte of x which is zero, no false positive
+		inline uint64_t zero_bytes(uint64_t x)
+		{
+			const uint64_t lo7 = 0x7F7F7F7F7F7F7F7FULL;
+			return ~(((x & lo7) + lo7) | x | lo7);
+		}
+
+		template<> inline size_t skip_ws<char>(const char* in, size_t pos, size_t len)
+		{
+			// most values are not preceded by whitespace
+			if(pos < len && !is_space(in[pos])) return pos;
+			const uint64_t ones = 0x0101010101010101ULL;
+			uint64_t x, mask;
+			for(; pos + 8 <= len; pos += 8) {
+				memcpy(&x, in + pos, 8);
+				mask = ~(zero_bytes(x ^ (ones * ' ')) | zero_bytes(x ^ (ones * '\n')) |
+						 zero_bytes(x ^ (ones * '\r')) | zero_bytes(x ^ (ones * '\t'))) & (ones << 7);
+				if(mask) return pos + (ctz64(mask) >> 3);
+			}
+			while(pos < len && is_space(in[pos])) ++pos;
+			return pos;
+		}
+#endif
+
+		// count leading zero bits, x MUST NOT be zero
+		inline int clz64(uint64_t x)
+		{
+#if defined(_MSC_VER) && defined(_WIN64)
+			unsigned long r;
+			_BitScanReverse64(&r, x);
+			return 63 - (int)r;
+#elif defined(_MSC_VER)
+			unsigned long r;
+			if(_BitScanReverse(&r, (unsigned long)(x >> 32))) return 31 - (int)r;
+			_BitScanReverse(&r, (unsigned long)x);
+			return 63 - (int)r;
+#else
+			return __builtin_clzll(x);
+#endif
+		}
+
+		// 64x64 bits multiplication, return low 64 bits of the product
+		inline uint64_t umul128(uint64_t a, uint64_t b, uint64_t& hi)
+		{
+#if defined(__SIZEOF_INT128__)
+			__extension__ typedef unsigned __int128 uint128;
+			const uint128 r = uint128(a) * b;
+			hi = uint64_t(r >> 64);
+			return uint64_t(r);
+#elif defined(_MSC_VER) && defined(_M_X64)
+			return _umul128(a, b, &hi);
+#else
+			const uint64_t ll = (a & 0xFFFFFFFF) * (b & 0xFFFFFFFF), lh = (a & 0xFFFFFFFF) * (b >> 32);
+			const uint64_t hl = (a >> 32) * (b & 0xFFFFFFFF), hh = (a >> 32) * (b >> 32);
+			const uint64_t mid = (ll >> 32) + (lh & 0xFFFFFFFF) + (hl & 0xFFFFFFFF);
+			hi = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+			return (mid << 32) | (ll & 0xFFFFFFFF);
+#endif
+		}
+
+		// accumulate decimal digits in [pos, end) to i, return offset of the first non-digit or end
+		template<class char_t>
+		inline size_t parse_digits(const char_t* in, size_t pos, size_t end, uint64_t& i)
+		{
+			while(pos < end && unsigned(in[pos] - '0') < 10) i = i * 10 + (in[pos++] - '0');
+			return pos;
+		}
+
+#if __XPJSON_LITTLE_ENDIAN__
+		// value of 8 digits packed in v, in[0] in the lowest byte
+		inline uint32_t swar_8digits(uint64_t v)
+		{
+			v -= 0x3030303030303030ULL;
+			v = v * 10 + (v >> 8);  // pairs of digits
+			return uint32_t(((v & 0x000000FF000000FFULL) * 0x000F424000000064ULL +               // 100 + (1000000 << 32)
+							((v >> 16) & 0x000000FF000000FFULL) * 0x0000271000000001ULL) >> 32); // 1 + (10000 << 32)
+		}
+
+		template<> inline size_t parse_digits<char>(const char* in, size_t pos, size_t end, uint64_t& i)
+		{
+			uint64_t v;
+			for(; pos + 8 <= end; pos += 8) {
+				memcpy(&v, in + pos, 8);
+				// any byte out of '0'~'9' sets its highest bit
+				if(((v + 0x4646464646464646ULL) | (v - 0x3030303030303030ULL)) & 0x8080808080808080ULL) break;
+				i = i * 100000000 + swar_8digits(v);
+			}
+			while(pos < end && unsigned(in[pos] - '0') < 10) i = i * 10 + (in[pos++] - '0');
+			return pos;
+		}
+#endif
+
+		// 5^q truncated to 128 bits with the highest bit set, q in [-342, 308]
+		inline const uint64_t* pow5_128(int q)
+		{
+			static const uint64_t table[] = {
+				0xeef453d6923bd65aULL, 0x113faa2906a13b3fULL,
+				0x9558b4661b6565f8ULL, 0x4ac7ca59a424c507ULL,
+				0xbaaee17fa23ebf76ULL, 0x5d79bcf00d2df649ULL,
+				0xe95a99df8ace6f53ULL, 0xf4d82c2c107973dcULL,
+				0x91d8a02bb6c10594ULL, 0x79071b9b8a4be869ULL,
+				0xb64ec836a47146f9ULL, 0x9748e2826cdee284ULL,
+				0xe3e27a444d8d98b7ULL, 0xfd1b1b2308169b25ULL,
+				0x8e6d8c6ab0787f72ULL, 0xfe30f0f5e50e20f7ULL,
+				0xb208ef855c969f4fULL, 0xbdbd2d335e51a935ULL,
+				0xde8b2b66b3bc4723ULL, 0xad2c788035e61382ULL,
+				0x8b16fb203055ac76ULL, 0x4c3bcb5021afcc31ULL,
+				0xaddcb9e83c6b1793ULL, 0xdf4abe242a1bbf3dULL,
+				0xd953e8624b85dd78ULL, 0xd71d6dad34a2af0dULL,
+				0x87d4713d6f33aa6bULL, 0x8672648c40e5ad68ULL,
+				0xa9c98d8ccb009506ULL, 0x680efdaf511f18c2ULL,
+				0xd43bf0effdc0ba48ULL, 0x0212bd1b2566def2ULL,
+				0x84a57695fe98746dULL, 0x014bb630f7604b57ULL,
+				0xa5ced43b7e3e9188ULL, 0x419ea3bd35385e2dULL,
+				0xcf42894a5dce35eaULL, 0x52064cac828675b9ULL,
+				0x818995ce7aa0e1b2ULL, 0x7343efebd1940993ULL,
+				0xa1ebfb4219491a1fULL, 0x1014ebe6c5f90bf8ULL,
+				0xca66fa129f9b60a6ULL, 0xd41a26e077774ef6ULL,
+				0xfd00b897478238d0ULL, 0x8920b098955522b4ULL,
+				0x9e20735e8cb16382ULL, 0x55b46e5f5d5535b0ULL,
+				0xc5a890362fddbc62ULL, 0xeb2189f734aa831dULL,
+				0xf712b443bbd52b7bULL, 0xa5e9ec7501d523e4ULL,
+				0x9a6bb0aa55653b2dULL, 0x47b233c92125366eULL,
+				0xc1069cd4eabe89f8ULL, 0x999ec0bb696e840aULL,
+				0xf148440a256e2c76ULL, 0xc00670ea43ca250dULL,
+				0x96cd2a865764dbcaULL, 0x380406926a5e5728ULL,
+				0xbc807527ed3e12bcULL, 0xc605083704f5ecf2ULL,
+				0xeba09271e88d976bULL, 0xf7864a44c633682eULL,
+				0x93445b8731587ea3ULL, 0x7ab3ee6afbe0211dULL,
+				0xb8157268fdae9e4cULL, 0x5960ea05bad82964ULL,
+				0xe61acf033d1a45dfULL, 0x6fb92487298e33bdULL,
+				0x8fd0c16206306babULL, 0xa5d3b6d479f8e056ULL,
+				0xb3c4f1ba87bc8696ULL, 0x8f48a4899877186cULL,
+				0xe0b62e2929aba83cULL, 0x331acdabfe94de87ULL,
+				0x8c71dcd9ba0b4925ULL, 0x9ff0c08b7f1d0b14ULL,
+				0xaf8e5410288e1b6fULL, 0x07ecf0ae5ee44dd9ULL,
+				0xdb71e91432b1a24aULL, 0xc9e82cd9f69d6150ULL,
+				0x892731ac9faf056eULL, 0xbe311c083a225cd2ULL,
+				0xab70fe17c79ac6caULL, 0x6dbd630a48aaf406ULL,
+				0xd64d3d9db981787dULL, 0x092cbbccdad5b108ULL,
+				0x85f0468293f0eb4eULL, 0x25bbf56008c58ea5ULL,
+				0xa76c582338ed2621ULL, 0xaf2af2b80af6f24eULL,
+				0xd1476e2c07286faaULL, 0x1af5af660db4aee1ULL,
+				0x82cca4db847945caULL, 0x50d98d9fc890ed4dULL,
+				0xa37fce126597973cULL, 0xe50ff107bab528a0ULL,
+				0xcc5fc196fefd7d0cULL, 0x1e53ed49a96272c8ULL,
+				0xff77b1fcbebcdc4fULL, 0x25e8e89c13bb0f7aULL,
+				0x9faacf3df73609b1ULL, 0x77b191618c54e9acULL,
+				0xc795830d75038c1dULL, 0xd59df5b9ef6a2417ULL,
+				0xf97ae3d0d2446f25ULL, 0x4b0573286b44ad1dULL,
+				0x9becce62836ac577ULL, 0x4ee367f9430aec32ULL,
+				0xc2e801fb244576d5ULL, 0x229c41f793cda73fULL,
+				0xf3a20279ed56d48aULL, 0x6b43527578c1110fULL,
+				0x9845418c345644d6ULL, 0x830a13896b78aaa9ULL,
+				0xbe5691ef416bd60cULL, 0x23cc986bc656d553ULL,
+				0xedec366b11c6cb8fULL, 0x2cbfbe86b7ec8aa8ULL,
+				0x94b3a202eb1c3f39ULL, 0x7bf7d71432f3d6a9ULL,
+				0xb9e08a83a5e34f07ULL, 0xdaf5ccd93fb0cc53ULL,
+				0xe858ad248f5c22c9ULL, 0xd1b3400f8f9cff68ULL,
+				0x91376c36d99995beULL, 0x23100809b9c21fa1ULL,
+				0xb58547448ffffb2dULL, 0xabd40a0c2832a78aULL,
+				0xe2e69915b3fff9f9ULL, 0x16c90c8f323f516cULL,
+				0x8dd01fad907ffc3bULL, 0xae3da7d97f6792e3ULL,
+				0xb1442798f49ffb4aULL, 0x99cd11cfdf41779cULL,
+				0xdd95317f31c7fa1dULL, 0x40405643d711d583ULL,
+				0x8a7d3eef7f1cfc52ULL, 0x482835ea666b2572ULL,
+				0xad1c8eab5ee43b66ULL, 0xda3243650005eecfULL,
+				0xd863b256369d4a40ULL, 0x90bed43e40076a82ULL,
+				0x873e4f75e2224e68ULL, 0x5a7744a6e804a291ULL,
+				0xa90de3535aaae202ULL, 0x711515d0a205cb36ULL,
+				0xd3515c2831559a83ULL, 0x0d5a5b44ca873e03ULL,
+				0x8412d9991ed58091ULL, 0xe858790afe9486c2ULL,
+				0xa5178fff668ae0b6ULL, 0x626e974dbe39a872ULL,
+				0xce5d73ff402d98e3ULL, 0xfb0a3d212dc8128fULL,
+				0x80fa687f881c7f8eULL, 0x7ce66634bc9d0b99ULL,
+				0xa139029f6a239f72ULL, 0x1c1fffc1ebc44e80ULL,
+				0xc987434744ac874eULL, 0xa327ffb266b56220ULL,
+				0xfbe9141915d7a922ULL, 0x4bf1ff9f0062baa8ULL,
+				0x9d71ac8fada6c9b5ULL, 0x6f773fc3603db4a9ULL,
+				0xc4ce17b399107c22ULL, 0xcb550fb4384d21d3ULL,
+				0xf6019da07f549b2bULL, 0x7e2a53a146606a48ULL,
+				0x99c102844f94e0fbULL, 0x2eda7444cbfc426dULL,
+				0xc0314325637a1939ULL, 0xfa911155fefb5308ULL,
+				0xf03d93eebc589f88ULL, 0x793555ab7eba27caULL,
+				0x96267c7535b763b5ULL, 0x4bc1558b2f3458deULL,
+				0xbbb01b9283253ca2ULL, 0x9eb1aaedfb016f16ULL,
+				0xea9c227723ee8bcbULL, 0x465e15a979c1cadcULL,
+				0x92a1958a7675175fULL, 0x0bfacd89ec191ec9ULL,
+				0xb749faed14125d36ULL, 0xcef980ec671f667bULL,
+				0xe51c79a85916f484ULL, 0x82b7e12780e7401aULL,
+				0x8f31cc0937ae58d2ULL, 0xd1b2ecb8b0908810ULL,
+				0xb2fe3f0b8599ef07ULL, 0x861fa7e6dcb4aa15ULL,
+				0xdfbdcece67006ac9ULL, 0x67a791e093e1d49aULL,
+				0x8bd6a141006042bdULL, 0xe0c8bb2c5c6d24e0ULL,
+				0xaecc49914078536dULL, 0x58fae9f773886e18ULL,
+				0xda7f5bf590966848ULL, 0xaf39a475506a899eULL,
+				0x888f99797a5e012dULL, 0x6d8406c952429603ULL,
+				0xaab37fd7d8f58178ULL, 0xc8e5087ba6d33b83ULL,
+				0xd5605fcdcf32e1d6ULL, 0xfb1e4a9a90880a64ULL,
+				0x855c3be0a17fcd26ULL, 0x5cf2eea09a55067fULL,
+				0xa6b34ad8c9dfc06fULL, 0xf42faa48c0ea481eULL,
+				0xd0601d8efc57b08bULL, 0xf13b94daf124da26ULL,
+				0x823c12795db6ce57ULL, 0x76c53d08d6b70858ULL,
+				0xa2cb1717b52481edULL, 0x54768c4b0c64ca6eULL,
+				0xcb7ddcdda26da268ULL, 0xa9942f5dcf7dfd09ULL,
+				0xfe5d54150b090b02ULL, 0xd3f93b35435d7c4cULL,
+				0x9efa548d26e5a6e1ULL, 0xc47bc5014a1a6dafULL,
+				0xc6b8e9b0709f109aULL, 0x359ab6419ca1091bULL,
+				0xf867241c8cc6d4c0ULL, 0xc30163d203c94b62ULL,
+				0x9b407691d7fc44f8ULL, 0x79e0de63425dcf1dULL,
+				0xc21094364dfb5636ULL, 0x985915fc12f542e4ULL,
+				0xf294b943e17a2bc4ULL, 0x3e6f5b7b17b2939dULL,
+				0x979cf3ca6cec5b5aULL, 0xa705992ceecf9c42ULL,
+				0xbd8430bd08277231ULL, 0x50c6ff782a838353ULL,
+				0xece53cec4a314ebdULL, 0xa4f8bf5635246428ULL,
+				0x940f4613ae5ed136ULL, 0x871b7795e136be99ULL,
+				0xb913179899f68584ULL, 0x28e2557b59846e3fULL,
+				0xe757dd7ec07426e5ULL, 0x331aeada2fe589cfULL,
+				0x9096ea6f3848984fULL, 0x3ff0d2c85def7621ULL,
+				0xb4bca50b065abe63ULL, 0x0fed077a756b53a9ULL,
+				0xe1ebce4dc7f16dfbULL, 0xd3e8495912c62894ULL,
+				0x8d3360f09cf6e4bdULL, 0x64712dd7abbbd95cULL,
+				0xb080392cc4349decULL, 0xbd8d794d96aacfb3ULL,
+				0xdca04777f541c567ULL, 0xecf0d7a0fc5583a0ULL,
+				0x89e42caaf9491b60ULL, 0xf41686c49db57244ULL,
+				0xac5d37d5b79b6239ULL, 0x311c2875c522ced5ULL,
+				0xd77485cb25823ac7ULL, 0x7d633293366b828bULL,
+				0x86a8d39ef77164bcULL, 0xae5dff9c02033197ULL,
+				0xa8530886b54dbdebULL, 0xd9f57f830283fdfcULL,
+				0xd267caa862a12d66ULL, 0xd072df63c324fd7bULL,
+				0x8380dea93da4bc60ULL, 0x4247cb9e59f71e6dULL,
+				0xa46116538d0deb78ULL, 0x52d9be85f074e608ULL,
+				0xcd795be870516656ULL, 0x67902e276c921f8bULL,
+				0x806bd9714632dff6ULL, 0x00ba1cd8a3db53b6ULL,
+				0xa086cfcd97bf97f3ULL, 0x80e8a40eccd228a4ULL,
+				0xc8a883c0fdaf7df0ULL, 0x6122cd128006b2cdULL,
+				0xfad2a4b13d1b5d6cULL, 0x796b805720085f81ULL,
+				0x9cc3a6eec6311a63ULL, 0xcbe3303674053bb0ULL,
+				0xc3f490aa77bd60fcULL, 0xbedbfc4411068a9cULL,
+				0xf4f1b4d515acb93bULL, 0xee92fb5515482d44ULL,
+				0x991711052d8bf3c5ULL, 0x751bdd152d4d1c4aULL,
+				0xbf5cd54678eef0b6ULL, 0xd262d45a78a0635dULL,
+				0xef340a98172aace4ULL, 0x86fb897116c87c34ULL,
+				0x9580869f0e7aac0eULL, 0xd45d35e6ae3d4da0ULL,
+				0xbae0a846d2195712ULL, 0x8974836059cca109ULL,
+				0xe998d258869facd7ULL, 0x2bd1a438703fc94bULL,
+				0x91ff83775423cc06ULL, 0x7b6306a34627ddcfULL,
+				0xb67f6455292cbf08ULL, 0x1a3bc84c17b1d542ULL,
+				0xe41f3d6a7377eecaULL, 0x20caba5f1d9e4a93ULL,
+				0x8e938662882af53eULL, 0x547eb47b7282ee9cULL,
+				0xb23867fb2a35b28dULL, 0xe99e619a4f23aa43ULL,
+				0xdec681f9f4c31f31ULL, 0x6405fa00e2ec94d4ULL,
+				0x8b3c113c38f9f37eULL, 0xde83bc408dd3dd04ULL,
+				0xae0b158b4738705eULL, 0x9624ab50b148d445ULL,
+				0xd98ddaee19068c76ULL, 0x3badd624dd9b0957ULL,
+				0x87f8a8d4cfa417c9ULL, 0xe54ca5d70a80e5d6ULL,
+				0xa9f6d30a038d1dbcULL, 0x5e9fcf4ccd211f4cULL,
+				0xd47487cc8470652bULL, 0x7647c3200069671fULL,
+				0x84c8d4dfd2c63f3bULL, 0x29ecd9f40041e073ULL,
+				0xa5fb0a17c777cf09ULL, 0xf468107100525890ULL,
+				0xcf79cc9db955c2ccULL, 0x7182148d4066eeb4ULL,
+				0x81ac1fe293d599bfULL, 0xc6f14cd848405530ULL,
+				0xa21727db38cb002fULL, 0xb8ada00e5a506a7cULL,
+				0xca9cf1d206fdc03bULL, 0xa6d90811f0e4851cULL,
+				0xfd442e4688bd304aULL, 0x908f4a166d1da663ULL,
+				0x9e4a9cec15763e2eULL, 0x9a598e4e043287feULL,
+				0xc5dd44271ad3cdbaULL, 0x40eff1e1853f29fdULL,
+				0xf7549530e188c128ULL, 0xd12bee59e68ef47cULL,
+				0x9a94dd3e8cf578b9ULL, 0x82bb74f8301958ceULL,
+				0xc13a148e3032d6e7ULL, 0xe36a52363c1faf01ULL,
+				0xf18899b1bc3f8ca1ULL, 0xdc44e6c3cb279ac1ULL,
+				0x96f5600f15a7b7e5ULL, 0x29ab103a5ef8c0b9ULL,
+				0xbcb2b812db11a5deULL, 0x7415d448f6b6f0e7ULL,
+				0xebdf661791d60f56ULL, 0x111b495b3464ad21ULL,
+				0x936b9fcebb25c995ULL, 0xcab10dd900beec34ULL,
+				0xb84687c269ef3bfbULL, 0x3d5d514f40eea742ULL,
+				0xe65829b3046b0afaULL, 0x0cb4a5a3112a5112ULL,
+				0x8ff71a0fe2c2e6dcULL, 0x47f0e785eaba72abULL,
+				0xb3f4e093db73a093ULL, 0x59ed216765690f56ULL,
+				0xe0f218b8d25088b8ULL, 0x306869c13ec3532cULL,
+				0x8c974f7383725573ULL, 0x1e414218c73a13fbULL,
+				0xafbd2350644eeacfULL, 0xe5d1929ef90898faULL,
+				0xdbac6c247d62a583ULL, 0xdf45f746b74abf39ULL,
+				0x894bc396ce5da772ULL, 0x6b8bba8c328eb783ULL,
+				0xab9eb47c81f5114fULL, 0x066ea92f3f326564ULL,
+				0xd686619ba27255a2ULL, 0xc80a537b0efefebdULL,
+				0x8613fd0145877585ULL, 0xbd06742ce95f5f36ULL,
+				0xa798fc4196e952e7ULL, 0x2c48113823b73704ULL,
+				0xd17f3b51fca3a7a0ULL, 0xf75a15862ca504c5ULL,
+				0x82ef85133de648c4ULL, 0x9a984d73dbe722fbULL,
+				0xa3ab66580d5fdaf5ULL, 0xc13e60d0d2e0ebbaULL,
+				0xcc963fee10b7d1b3ULL, 0x318df905079926a8ULL,
+				0xffbbcfe994e5c61fULL, 0xfdf17746497f7052ULL,
+				0x9fd561f1fd0f9bd3ULL, 0xfeb6ea8bedefa633ULL,
+				0xc7caba6e7c5382c8ULL, 0xfe64a52ee96b8fc0ULL,
+				0xf9bd690a1b68637bULL, 0x3dfdce7aa3c673b0ULL,
+				0x9c1661a651213e2dULL, 0x06bea10ca65c084eULL,
+				0xc31bfa0fe5698db8ULL, 0x486e494fcff30a62ULL,
+				0xf3e2f893dec3f126ULL, 0x5a89dba3c3efccfaULL,
+				0x986ddb5c6b3a76b7ULL, 0xf89629465a75e01cULL,
+				0xbe89523386091465ULL, 0xf6bbb397f1135823ULL,
+				0xee2ba6c0678b597fULL, 0x746aa07ded582e2cULL,
+				0x94db483840b717efULL, 0xa8c2a44eb4571cdcULL,
+				0xba121a4650e4ddebULL, 0x92f34d62616ce413ULL,
+				0xe896a0d7e51e1566ULL, 0x77b020baf9c81d17ULL,
+				0x915e2486ef32cd60ULL, 0x0ace1474dc1d122eULL,
+				0xb5b5ada8aaff80b8ULL, 0x0d819992132456baULL,
+				0xe3231912d5bf60e6ULL, 0x10e1fff697ed6c69ULL,
+				0x8df5efabc5979c8fULL, 0xca8d3ffa1ef463c1ULL,
+				0xb1736b96b6fd83b3ULL, 0xbd308ff8a6b17cb2ULL,
+				0xddd0467c64bce4a0ULL, 0xac7cb3f6d05ddbdeULL,
+				0x8aa22c0dbef60ee4ULL, 0x6bcdf07a423aa96bULL,
+				0xad4ab7112eb3929dULL, 0x86c16c98d2c953c6ULL,
+				0xd89d64d57a607744ULL, 0xe871c7bf077ba8b7ULL,
+				0x87625f056c7c4a8bULL, 0x11471cd764ad4972ULL,
+				0xa93af6c6c79b5d2dULL, 0xd598e40d3dd89bcfULL,
+				0xd389b47879823479ULL, 0x4aff1d108d4ec2c3ULL,
+				0x843610cb4bf160cbULL, 0xcedf722a585139baULL,
+				0xa54394fe1eedb8feULL, 0xc2974eb4ee658828ULL,
+				0xce947a3da6a9273eULL, 0x733d226229feea32ULL,
+				0x811ccc668829b887ULL, 0x0806357d5a3f525fULL,
+				0xa163ff802a3426a8ULL, 0xca07c2dcb0cf26f7ULL,
+				0xc9bcff6034c13052ULL, 0xfc89b393dd02f0b5ULL,
+				0xfc2c3f3841f17c67ULL, 0xbbac2078d443ace2ULL,
+				0x9d9ba7832936edc0ULL, 0xd54b944b84aa4c0dULL,
+				0xc5029163f384a931ULL, 0x0a9e795e65d4df11ULL,
+				0xf64335bcf065d37dULL, 0x4d4617b5ff4a16d5ULL,
+				0x99ea0196163fa42eULL, 0x504bced1bf8e4e45ULL,
+				0xc06481fb9bcf8d39ULL, 0xe45ec2862f71e1d6ULL,
+				0xf07da27a82c37088ULL, 0x5d767327bb4e5a4cULL,
+				0x964e858c91ba2655ULL, 0x3a6a07f8d510f86fULL,
+				0xbbe226efb628afeaULL, 0x890489f70a55368bULL,
+				0xeadab0aba3b2dbe5ULL, 0x2b45ac74ccea842eULL,
+				0x92c8ae6b464fc96fULL, 0x3b0b8bc90012929dULL,
+				0xb77ada0617e3bbcbULL, 0x09ce6ebb40173744ULL,
+				0xe55990879ddcaabdULL, 0xcc420a6a101d0515ULL,
+				0x8f57fa54c2a9eab6ULL, 0x9fa946824a12232dULL,
+				0xb32df8e9f3546564ULL, 0x47939822dc96abf9ULL,
+				0xdff9772470297ebdULL, 0x59787e2b93bc56f7ULL,
+				0x8bfbea76c619ef36ULL, 0x57eb4edb3c55b65aULL,
+				0xaefae51477a06b03ULL, 0xede622920b6b23f1ULL,
+				0xdab99e59958885c4ULL, 0xe95fab368e45ecedULL,
+				0x88b402f7fd75539bULL, 0x11dbcb0218ebb414ULL,
+				0xaae103b5fcd2a881ULL, 0xd652bdc29f26a119ULL,
+				0xd59944a37c0752a2ULL, 0x4be76d3346f0495fULL,
+				0x857fcae62d8493a5ULL, 0x6f70a4400c562ddbULL,
+				0xa6dfbd9fb8e5b88eULL, 0xcb4ccd500f6bb952ULL,
+				0xd097ad07a71f26b2ULL, 0x7e2000a41346a7a7ULL,
+				0x825ecc24c873782fULL, 0x8ed400668c0c28c8ULL,
+				0xa2f67f2dfa90563bULL, 0x728900802f0f32faULL,
+				0xcbb41ef979346bcaULL, 0x4f2b40a03ad2ffb9ULL,
+				0xfea126b7d78186bcULL, 0xe2f610c84987bfa8ULL,
+				0x9f24b832e6b0f436ULL, 0x0dd9ca7d2df4d7c9ULL,
+				0xc6ede63fa05d3143ULL, 0x91503d1c79720dbbULL,
+				0xf8a95fcf88747d94ULL, 0x75a44c6397ce912aULL,
+				0x9b69dbe1b548ce7cULL, 0xc986afbe3ee11abaULL,
+				0xc24452da229b021bULL, 0xfbe85badce996168ULL,
+				0xf2d56790ab41c2a2ULL, 0xfae27299423fb9c3ULL,
+				0x97c560ba6b0919a5ULL, 0xdccd879fc967d41aULL,
+				0xbdb6b8e905cb600fULL, 0x5400e987bbc1c920ULL,
+				0xed246723473e3813ULL, 0x290123e9aab23b68ULL,
+				0x9436c0760c86e30bULL, 0xf9a0b6720aaf6521ULL,
+				0xb94470938fa89bceULL, 0xf808e40e8d5b3e69ULL,
+				0xe7958cb87392c2c2ULL, 0xb60b1d1230b20e04ULL,
+				0x90bd77f3483bb9b9ULL, 0xb1c6f22b5e6f48c2ULL,
+				0xb4ecd5f01a4aa828ULL, 0x1e38aeb6360b1af3ULL,
+				0xe2280b6c20dd5232ULL, 0x25c6da63c38de1b0ULL,
+				0x8d590723948a535fULL, 0x579c487e5a38ad0eULL,
+				0xb0af48ec79ace837ULL, 0x2d835a9df0c6d851ULL,
+				0xdcdb1b2798182244ULL, 0xf8e431456cf88e65ULL,
+				0x8a08f0f8bf0f156bULL, 0x1b8e9ecb641b58ffULL,
+				0xac8b2d36eed2dac5ULL, 0xe272467e3d222f3fULL,
+				0xd7adf884aa879177ULL, 0x5b0ed81dcc6abb0fULL,
+				0x86ccbb52ea94baeaULL, 0x98e947129fc2b4e9ULL,
+				0xa87fea27a539e9a5ULL, 0x3f2398d747b36224ULL,
+				0xd29fe4b18e88640eULL, 0x8eec7f0d19a03aadULL,
+				0x83a3eeeef9153e89ULL, 0x1953cf68300424acULL,
+				0xa48ceaaab75a8e2bULL, 0x5fa8c3423c052dd7ULL,
+				0xcdb02555653131b6ULL, 0x3792f412cb06794dULL,
+				0x808e17555f3ebf11ULL, 0xe2bbd88bbee40bd0ULL,
+				0xa0b19d2ab70e6ed6ULL, 0x5b6aceaeae9d0ec4ULL,
+				0xc8de047564d20a8bULL, 0xf245825a5a445275ULL,
+				0xfb158592be068d2eULL, 0xeed6e2f0f0d56712ULL,
+				0x9ced737bb6c4183dULL, 0x55464dd69685606bULL,
+				0xc428d05aa4751e4cULL, 0xaa97e14c3c26b886ULL,
+				0xf53304714d9265dfULL, 0xd53dd99f4b3066a8ULL,
+				0x993fe2c6d07b7fabULL, 0xe546a8038efe4029ULL,
+				0xbf8fdb78849a5f96ULL, 0xde98520472bdd033ULL,
+				0xef73d256a5c0f77cULL, 0x963e66858f6d4440ULL,
+				0x95a8637627989aadULL, 0xdde7001379a44aa8ULL,
+				0xbb127c53b17ec159ULL, 0x5560c018580d5d52ULL,
+				0xe9d71b689dde71afULL, 0xaab8f01e6e10b4a6ULL,
+				0x9226712162ab070dULL, 0xcab3961304ca70e8ULL,
+				0xb6b00d69bb55c8d1ULL, 0x3d607b97c5fd0d22ULL,
+				0xe45c10c42a2b3b05ULL, 0x8cb89a7db77c506aULL,
+				0x8eb98a7a9a5b04e3ULL, 0x77f3608e92adb242ULL,
+				0xb267ed1940f1c61cULL, 0x55f038b237591ed3ULL,
+				0xdf01e85f912e37a3ULL, 0x6b6c46dec52f6688ULL,
+				0x8b61313bbabce2c6ULL, 0x2323ac4b3b3da015ULL,
+				0xae397d8aa96c1b77ULL, 0xabec975e0a0d081aULL,
+				0xd9c7dced53c72255ULL, 0x96e7bd358c904a21ULL,
+				0x881cea14545c7575ULL, 0x7e50d64177da2e54ULL,
+				0xaa242499697392d2ULL, 0xdde50bd1d5d0b9e9ULL,
+				0xd4ad2dbfc3d07787ULL, 0x955e4ec64b44e864ULL,
+				0x84ec3c97da624ab4ULL, 0xbd5af13bef0b113eULL,
+				0xa6274bbdd0fadd61ULL, 0xecb1ad8aeacdd58eULL,
+				0xcfb11ead453994baULL, 0x67de18eda5814af2ULL,
+				0x81ceb32c4b43fcf4ULL, 0x80eacf948770ced7ULL,
+				0xa2425ff75e14fc31ULL, 0xa1258379a94d028dULL,
+				0xcad2f7f5359a3b3eULL, 0x096ee45813a04330ULL,
+				0xfd87b5f28300ca0dULL, 0x8bca9d6e188853fcULL,
+				0x9e74d1b791e07e48ULL, 0x775ea264cf55347eULL,
+				0xc612062576589ddaULL, 0x95364afe032a819eULL,
+				0xf79687aed3eec551ULL, 0x3a83ddbd83f52205ULL,
+				0x9abe14cd44753b52ULL, 0xc4926a9672793543ULL,
+				0xc16d9a0095928a27ULL, 0x75b7053c0f178294ULL,
+				0xf1c90080baf72cb1ULL, 0x5324c68b12dd6339ULL,
+				0x971da05074da7beeULL, 0xd3f6fc16ebca5e04ULL,
+				0xbce5086492111aeaULL, 0x88f4bb1ca6bcf585ULL,
+				0xec1e4a7db69561a5ULL, 0x2b31e9e3d06c32e6ULL,
+				0x9392ee8e921d5d07ULL, 0x3aff322e62439fd0ULL,
+				0xb877aa3236a4b449ULL, 0x09befeb9fad487c3ULL,
+				0xe69594bec44de15bULL, 0x4c2ebe687989a9b4ULL,
+				0x901d7cf73ab0acd9ULL, 0x0f9d37014bf60a11ULL,
+				0xb424dc35095cd80fULL, 0x538484c19ef38c95ULL,
+				0xe12e13424bb40e13ULL, 0x2865a5f206b06fbaULL,
+				0x8cbccc096f5088cbULL, 0xf93f87b7442e45d4ULL,
+				0xafebff0bcb24aafeULL, 0xf78f69a51539d749ULL,
+				0xdbe6fecebdedd5beULL, 0xb573440e5a884d1cULL,
+				0x89705f4136b4a597ULL, 0x31680a88f8953031ULL,
+				0xabcc77118461cefcULL, 0xfdc20d2b36ba7c3eULL,
+				0xd6bf94d5e57a42bcULL, 0x3d32907604691b4dULL,
+				0x8637bd05af6c69b5ULL, 0xa63f9a49c2c1b110ULL,
+				0xa7c5ac471b478423ULL, 0x0fcf80dc33721d54ULL,
+				0xd1b71758e219652bULL, 0xd3c36113404ea4a9ULL,
+				0x83126e978d4fdf3bULL, 0x645a1cac083126eaULL,
+				0xa3d70a3d70a3d70aULL, 0x3d70a3d70a3d70a4ULL,
+				0xccccccccccccccccULL, 0xcccccccccccccccdULL,
+				0x8000000000000000ULL, 0x0000000000000000ULL,
+				0xa000000000000000ULL, 0x0000000000000000ULL,
+				0xc800000000000000ULL, 0x0000000000000000ULL,
+				0xfa00000000000000ULL, 0x0000000000000000ULL,
+				0x9c40000000000000ULL, 0x0000000000000000ULL,
+				0xc350000000000000ULL, 0x0000000000000000ULL,
+				0xf424000000000000ULL, 0x0000000000000000ULL,
+				0x9896800000000000ULL, 0x0000000000000000ULL,
+				0xbebc200000000000ULL, 0x0000000000000000ULL,
+				0xee6b280000000000ULL, 0x0000000000000000ULL,
+				0x9502f90000000000ULL, 0x0000000000000000ULL,
+				0xba43b74000000000ULL, 0x0000000000000000ULL,
+				0xe8d4a51000000000ULL, 0x0000000000000000ULL,
+				0x9184e72a00000000ULL, 0x0000000000000000ULL,
+				0xb5e620f480000000ULL, 0x0000000000000000ULL,
+				0xe35fa931a0000000ULL, 0x0000000000000000ULL,
+				0x8e1bc9bf04000000ULL, 0x0000000000000000ULL,
+				0xb1a2bc2ec5000000ULL, 0x0000000000000000ULL,
+				0xde0b6b3a76400000ULL, 0x0000000000000000ULL,
+				0x8ac7230489e80000ULL, 0x0000000000000000ULL,
+				0xad78ebc5ac620000ULL, 0x0000000000000000ULL,
+				0xd8d726b7177a8000ULL, 0x0000000000000000ULL,
+				0x878678326eac9000ULL, 0x0000000000000000ULL,
+				0xa968163f0a57b400ULL, 0x0000000000000000ULL,
+				0xd3c21bcecceda100ULL, 0x0000000000000000ULL,
+				0x84595161401484a0ULL, 0x0000000000000000ULL,
+				0xa56fa5b99019a5c8ULL, 0x0000000000000000ULL,
+				0xcecb8f27f4200f3aULL, 0x0000000000000000ULL,
+				0x813f3978f8940984ULL, 0x4000000000000000ULL,
+				0xa18f07d736b90be5ULL, 0x5000000000000000ULL,
+				0xc9f2c9cd04674edeULL, 0xa400000000000000ULL,
+				0xfc6f7c4045812296ULL, 0x4d00000000000000ULL,
+				0x9dc5ada82b70b59dULL, 0xf020000000000000ULL,
+				0xc5371912364ce305ULL, 0x6c28000000000000ULL,
+				0xf684df56c3e01bc6ULL, 0xc732000000000000ULL,
+				0x9a130b963a6c115cULL, 0x3c7f400000000000ULL,
+				0xc097ce7bc90715b3ULL, 0x4b9f100000000000ULL,
+				0xf0bdc21abb48db20ULL, 0x1e86d40000000000ULL,
+				0x96769950b50d88f4ULL, 0x1314448000000000ULL,
+				0xbc143fa4e250eb31ULL, 0x17d955a000000000ULL,
+				0xeb194f8e1ae525fdULL, 0x5dcfab0800000000ULL,
+				0x92efd1b8d0cf37beULL, 0x5aa1cae500000000ULL,
+				0xb7abc627050305adULL, 0xf14a3d9e40000000ULL,
+				0xe596b7b0c643c719ULL, 0x6d9ccd05d0000000ULL,
+				0x8f7e32ce7bea5c6fULL, 0xe4820023a2000000ULL,
+				0xb35dbf821ae4f38bULL, 0xdda2802c8a800000ULL,
+				0xe0352f62a19e306eULL, 0xd50b2037ad200000ULL,
+				0x8c213d9da502de45ULL, 0x4526f422cc340000ULL,
+				0xaf298d050e4395d6ULL, 0x9670b12b7f410000ULL,
+				0xdaf3f04651d47b4cULL, 0x3c0cdd765f114000ULL,
+				0x88d8762bf324cd0fULL, 0xa5880a69fb6ac800ULL,
+				0xab0e93b6efee0053ULL, 0x8eea0d047a457a00ULL,
+				0xd5d238a4abe98068ULL, 0x72a4904598d6d880ULL,
+				0x85a36366eb71f041ULL, 0x47a6da2b7f864750ULL,
+				0xa70c3c40a64e6c51ULL, 0x999090b65f67d924ULL,
+				0xd0cf4b50cfe20765ULL, 0xfff4b4e3f741cf6dULL,
+				0x82818f1281ed449fULL, 0xbff8f10e7a8921a4ULL,
+				0xa321f2d7226895c7ULL, 0xaff72d52192b6a0dULL,
+				0xcbea6f8ceb02bb39ULL, 0x9bf4f8a69f764490ULL,
+				0xfee50b7025c36a08ULL, 0x02f236d04753d5b4ULL,
+				0x9f4f2726179a2245ULL, 0x01d762422c946590ULL,
+				0xc722f0ef9d80aad6ULL, 0x424d3ad2b7b97ef5ULL,
+				0xf8ebad2b84e0d58bULL, 0xd2e0898765a7deb2ULL,
+				0x9b934c3b330c8577ULL, 0x63cc55f49f88eb2fULL,
+				0xc2781f49ffcfa6d5ULL, 0x3cbf6b71c76b25fbULL,
+				0xf316271c7fc3908aULL, 0x8bef464e3945ef7aULL,
+				0x97edd871cfda3a56ULL, 0x97758bf0e3cbb5acULL,
+				0xbde94e8e43d0c8ecULL, 0x3d52eeed1cbea317ULL,
+				0xed63a231d4c4fb27ULL, 0x4ca7aaa863ee4bddULL,
+				0x945e455f24fb1cf8ULL, 0x8fe8caa93e74ef6aULL,
+				0xb975d6b6ee39e436ULL, 0xb3e2fd538e122b44ULL,
+				0xe7d34c64a9c85d44ULL, 0x60dbbca87196b616ULL,
+				0x90e40fbeea1d3a4aULL, 0xbc8955e946fe31cdULL,
+				0xb51d13aea4a488ddULL, 0x6babab6398bdbe41ULL,
+				0xe264589a4dcdab14ULL, 0xc696963c7eed2dd1ULL,
+				0x8d7eb76070a08aecULL, 0xfc1e1de5cf543ca2ULL,
+				0xb0de65388cc8ada8ULL, 0x3b25a55f43294bcbULL,
+				0xdd15fe86affad912ULL, 0x49ef0eb713f39ebeULL,
+				0x8a2dbf142dfcc7abULL, 0x6e3569326c784337ULL,
+				0xacb92ed9397bf996ULL, 0x49c2c37f07965404ULL,
+				0xd7e77a8f87daf7fbULL, 0xdc33745ec97be906ULL,
+				0x86f0ac99b4e8dafdULL, 0x69a028bb3ded71a3ULL,
+				0xa8acd7c0222311bcULL, 0xc40832ea0d68ce0cULL,
+				0xd2d80db02aabd62bULL, 0xf50a3fa490c30190ULL,
+				0x83c7088e1aab65dbULL, 0x792667c6da79e0faULL,
+				0xa4b8cab1a1563f52ULL, 0x577001b891185938ULL,
+				0xcde6fd5e09abcf26ULL, 0xed4c0226b55e6f86ULL,
+				0x80b05e5ac60b6178ULL, 0x544f8158315b05b4ULL,
+				0xa0dc75f1778e39d6ULL, 0x696361ae3db1c721ULL,
+				0xc913936dd571c84cULL, 0x03bc3a19cd1e38e9ULL,
+				0xfb5878494ace3a5fULL, 0x04ab48a04065c723ULL,
+				0x9d174b2dcec0e47bULL, 0x62eb0d64283f9c76ULL,
+				0xc45d1df942711d9aULL, 0x3ba5d0bd324f8394ULL,
+				0xf5746577930d6500ULL, 0xca8f44ec7ee36479ULL,
+				0x9968bf6abbe85f20ULL, 0x7e998b13cf4e1ecbULL,
+				0xbfc2ef456ae276e8ULL, 0x9e3fedd8c321a67eULL,
+				0xefb3ab16c59b14a2ULL, 0xc5cfe94ef3ea101eULL,
+				0x95d04aee3b80ece5ULL, 0xbba1f1d158724a12ULL,
+				0xbb445da9ca61281fULL, 0x2a8a6e45ae8edc97ULL,
+				0xea1575143cf97226ULL, 0xf52d09d71a3293bdULL,
+				0x924d692ca61be758ULL, 0x593c2626705f9c56ULL,
+				0xb6e0c377cfa2e12eULL, 0x6f8b2fb00c77836cULL,
+				0xe498f455c38b997aULL, 0x0b6dfb9c0f956447ULL,
+				0x8edf98b59a373fecULL, 0x4724bd4189bd5eacULL,
+				0xb2977ee300c50fe7ULL, 0x58edec91ec2cb657ULL,
+				0xdf3d5e9bc0f653e1ULL, 0x2f2967b66737e3edULL,
+				0x8b865b215899f46cULL, 0xbd79e0d20082ee74ULL,
+				0xae67f1e9aec07187ULL, 0xecd8590680a3aa11ULL,
+				0xda01ee641a708de9ULL, 0xe80e6f4820cc9495ULL,
+				0x884134fe908658b2ULL, 0x3109058d147fdcddULL,
+				0xaa51823e34a7eedeULL, 0xbd4b46f0599fd415ULL,
+				0xd4e5e2cdc1d1ea96ULL, 0x6c9e18ac7007c91aULL,
+				0x850fadc09923329eULL, 0x03e2cf6bc604ddb0ULL,
+				0xa6539930bf6bff45ULL, 0x84db8346b786151cULL,
+				0xcfe87f7cef46ff16ULL, 0xe612641865679a63ULL,
+				0x81f14fae158c5f6eULL, 0x4fcb7e8f3f60c07eULL,
+				0xa26da3999aef7749ULL, 0xe3be5e330f38f09dULL,
+				0xcb090c8001ab551cULL, 0x5cadf5bfd3072cc5ULL,
+				0xfdcb4fa002162a63ULL, 0x73d9732fc7c8f7f6ULL,
+				0x9e9f11c4014dda7eULL, 0x2867e7fddcdd9afaULL,
+				0xc646d63501a1511dULL, 0xb281e1fd541501b8ULL,
+				0xf7d88bc24209a565ULL, 0x1f225a7ca91a4226ULL,
+				0x9ae757596946075fULL, 0x3375788de9b06958ULL,
+				0xc1a12d2fc3978937ULL, 0x0052d6b1641c83aeULL,
+				0xf209787bb47d6b84ULL, 0xc0678c5dbd23a49aULL,
+				0x9745eb4d50ce6332ULL, 0xf840b7ba963646e0ULL,
+				0xbd176620a501fbffULL, 0xb650e5a93bc3d898ULL,
+				0xec5d3fa8ce427affULL, 0xa3e51f138ab4cebeULL,
+				0x93ba47c980e98cdfULL, 0xc66f336c36b10137ULL,
+				0xb8a8d9bbe123f017ULL, 0xb80b0047445d4184ULL,
+				0xe6d3102ad96cec1dULL, 0xa60dc059157491e5ULL,
+				0x9043ea1ac7e41392ULL, 0x87c89837ad68db2fULL,
+				0xb454e4a179dd1877ULL, 0x29babe4598c311fbULL,
+				0xe16a1dc9d8545e94ULL, 0xf4296dd6fef3d67aULL,
+				0x8ce2529e2734bb1dULL, 0x1899e4a65f58660cULL,
+				0xb01ae745b101e9e4ULL, 0x5ec05dcff72e7f8fULL,
+				0xdc21a1171d42645dULL, 0x76707543f4fa1f73ULL,
+				0x899504ae72497ebaULL, 0x6a06494a791c53a8ULL,
+				0xabfa45da0edbde69ULL, 0x0487db9d17636892ULL,
+				0xd6f8d7509292d603ULL, 0x45a9d2845d3c42b6ULL,
+				0x865b86925b9bc5c2ULL, 0x0b8a2392ba45a9b2ULL,
+				0xa7f26836f282b732ULL, 0x8e6cac7768d7141eULL,
+				0xd1ef0244af2364ffULL, 0x3207d795430cd926ULL,
+				0x8335616aed761f1fULL, 0x7f44e6bd49e807b8ULL,
+				0xa402b9c5a8d3a6e7ULL, 0x5f16206c9c6209a6ULL,
+				0xcd036837130890a1ULL, 0x36dba887c37a8c0fULL,
+				0x802221226be55a64ULL, 0xc2494954da2c9789ULL,
+				0xa02aa96b06deb0fdULL, 0xf2db9baa10b7bd6cULL,
+				0xc83553c5c8965d3dULL, 0x6f92829494e5acc7ULL,
+				0xfa42a8b73abbf48cULL, 0xcb772339ba1f17f9ULL,
+				0x9c69a97284b578d7ULL, 0xff2a760414536efbULL,
+				0xc38413cf25e2d70dULL, 0xfef5138519684abaULL,
+				0xf46518c2ef5b8cd1ULL, 0x7eb258665fc25d69ULL,
+				0x98bf2f79d5993802ULL, 0xef2f773ffbd97a61ULL,
+				0xbeeefb584aff8603ULL, 0xaafb550ffacfd8faULL,
+				0xeeaaba2e5dbf6784ULL, 0x95ba2a53f983cf38ULL,
+				0x952ab45cfa97a0b2ULL, 0xdd945a747bf26183ULL,
+				0xba756174393d88dfULL, 0x94f971119aeef9e4ULL,
+				0xe912b9d1478ceb17ULL, 0x7a37cd5601aab85dULL,
+				0x91abb422ccb812eeULL, 0xac62e055c10ab33aULL,
+				0xb616a12b7fe617aaULL, 0x577b986b314d6009ULL,
+				0xe39c49765fdf9d94ULL, 0xed5a7e85fda0b80bULL,
+				0x8e41ade9fbebc27dULL, 0x14588f13be847307ULL,
+				0xb1d219647ae6b31cULL, 0x596eb2d8ae258fc8ULL,
+				0xde469fbd99a05fe3ULL, 0x6fca5f8ed9aef3bbULL,
+				0x8aec23d680043beeULL, 0x25de7bb9480d5854ULL,
+				0xada72ccc20054ae9ULL, 0xaf561aa79a10ae6aULL,
+				0xd910f7ff28069da4ULL, 0x1b2ba1518094da04ULL,
+				0x87aa9aff79042286ULL, 0x90fb44d2f05d0842ULL,
+				0xa99541bf57452b28ULL, 0x353a1607ac744a53ULL,
+				0xd3fa922f2d1675f2ULL, 0x42889b8997915ce8ULL,
+				0x847c9b5d7c2e09b7ULL, 0x69956135febada11ULL,
+				0xa59bc234db398c25ULL, 0x43fab9837e699095ULL,
+				0xcf02b2c21207ef2eULL, 0x94f967e45e03f4bbULL,
+				0x8161afb94b44f57dULL, 0x1d1be0eebac278f5ULL,
+				0xa1ba1ba79e1632dcULL, 0x6462d92a69731732ULL,
+				0xca28a291859bbf93ULL, 0x7d7b8f7503cfdcfeULL,
+				0xfcb2cb35e702af78ULL, 0x5cda735244c3d43eULL,
+				0x9defbf01b061adabULL, 0x3a0888136afa64a7ULL,
+				0xc56baec21c7a1916ULL, 0x088aaa1845b8fdd0ULL,
+				0xf6c69a72a3989f5bULL, 0x8aad549e57273d45ULL,
+				0x9a3c2087a63f6399ULL, 0x36ac54e2f678864bULL,
+				0xc0cb28a98fcf3c7fULL, 0x84576a1bb416a7ddULL,
+				0xf0fdf2d3f3c30b9fULL, 0x656d44a2a11c51d5ULL,
+				0x969eb7c47859e743ULL, 0x9f644ae5a4b1b325ULL,
+				0xbc4665b596706114ULL, 0x873d5d9f0dde1feeULL,
+				0xeb57ff22fc0c7959ULL, 0xa90cb506d155a7eaULL,
+				0x9316ff75dd87cbd8ULL, 0x09a7f12442d588f2ULL,
+				0xb7dcbf5354e9beceULL, 0x0c11ed6d538aeb2fULL,
+				0xe5d3ef282a242e81ULL, 0x8f1668c8a86da5faULL,
+				0x8fa475791a569d10ULL, 0xf96e017d694487bcULL,
+				0xb38d92d760ec4455ULL, 0x37c981dcc395a9acULL,
+				0xe070f78d3927556aULL, 0x85bbe253f47b1417ULL,
+				0x8c469ab843b89562ULL, 0x93956d7478ccec8eULL,
+				0xaf58416654a6babbULL, 0x387ac8d1970027b2ULL,
+				0xdb2e51bfe9d0696aULL, 0x06997b05fcc0319eULL,
+				0x88fcf317f22241e2ULL, 0x441fece3bdf81f03ULL,
+				0xab3c2fddeeaad25aULL, 0xd527e81cad7626c3ULL,
+				0xd60b3bd56a5586f1ULL, 0x8a71e223d8d3b074ULL,
+				0x85c7056562757456ULL, 0xf6872d5667844e49ULL,
+				0xa738c6bebb12d16cULL, 0xb428f8ac016561dbULL,
+				0xd106f86e69d785c7ULL, 0xe13336d701beba52ULL,
+				0x82a45b450226b39cULL, 0xecc0024661173473ULL,
+				0xa34d721642b06084ULL, 0x27f002d7f95d0190ULL,
+				0xcc20ce9bd35c78a5ULL, 0x31ec038df7b441f4ULL,
+				0xff290242c83396ceULL, 0x7e67047175a15271ULL,
+				0x9f79a169bd203e41ULL, 0x0f0062c6e984d386ULL,
+				0xc75809c42c684dd1ULL, 0x52c07b78a3e60868ULL,
+				0xf92e0c3537826145ULL, 0xa7709a56ccdf8a82ULL,
+				0x9bbcc7a142b17ccbULL, 0x88a66076400bb691ULL,
+				0xc2abf989935ddbfeULL, 0x6acff893d00ea435ULL,
+				0xf356f7ebf83552feULL, 0x0583f6b8c4124d43ULL,
+				0x98165af37b2153deULL, 0xc3727a337a8b704aULL,
+				0xbe1bf1b059e9a8d6ULL, 0x744f18c0592e4c5cULL,
+				0xeda2ee1c7064130cULL, 0x1162def06f79df73ULL,
+				0x9485d4d1c63e8be7ULL, 0x8addcb5645ac2ba8ULL,
+				0xb9a74a0637ce2ee1ULL, 0x6d953e2bd7173692ULL,
+				0xe8111c87c5c1ba99ULL, 0xc8fa8db6ccdd0437ULL,
+				0x910ab1d4db9914a0ULL, 0x1d9c9892400a22a2ULL,
+				0xb54d5e4a127f59c8ULL, 0x2503beb6d00cab4bULL,
+				0xe2a0b5dc971f303aULL, 0x2e44ae64840fd61dULL,
+				0x8da471a9de737e24ULL, 0x5ceaecfed289e5d2ULL,
+				0xb10d8e1456105dadULL, 0x7425a83e872c5f47ULL,
+				0xdd50f1996b947518ULL, 0xd12f124e28f77719ULL,
+				0x8a5296ffe33cc92fULL, 0x82bd6b70d99aaa6fULL,
+				0xace73cbfdc0bfb7bULL, 0x636cc64d1001550bULL,
+				0xd8210befd30efa5aULL, 0x3c47f7e05401aa4eULL,
+				0x8714a775e3e95c78ULL, 0x65acfaec34810a71ULL,
+				0xa8d9d1535ce3b396ULL, 0x7f1839a741a14d0dULL,
+				0xd31045a8341ca07cULL, 0x1ede48111209a050ULL,
+				0x83ea2b892091e44dULL, 0x934aed0aab460432ULL,
+				0xa4e4b66b68b65d60ULL, 0xf81da84d5617853fULL,
+				0xce1de40642e3f4b9ULL, 0x36251260ab9d668eULL,
+				0x80d2ae83e9ce78f3ULL, 0xc1d72b7c6b426019ULL,
+				0xa1075a24e4421730ULL, 0xb24cf65b8612f81fULL,
+				0xc94930ae1d529cfcULL, 0xdee033f26797b627ULL,
+				0xfb9b7cd9a4a7443cULL, 0x169840ef017da3b1ULL,
+				0x9d412e0806e88aa5ULL, 0x8e1f289560ee864eULL,
+				0xc491798a08a2ad4eULL, 0xf1a6f2bab92a27e2ULL,
+				0xf5b5d7ec8acb58a2ULL, 0xae10af696774b1dbULL,
+				0x9991a6f3d6bf1765ULL, 0xacca6da1e0a8ef29ULL,
+				0xbff610b0cc6edd3fULL, 0x17fd090a58d32af3ULL,
+				0xeff394dcff8a948eULL, 0xddfc4b4cef07f5b0ULL,
+				0x95f83d0a1fb69cd9ULL, 0x4abdaf101564f98eULL,
+				0xbb764c4ca7a4440fULL, 0x9d6d1ad41abe37f1ULL,
+				0xea53df5fd18d5513ULL, 0x84c86189216dc5edULL,
+				0x92746b9be2f8552cULL, 0x32fd3cf5b4e49bb4ULL,
+				0xb7118682dbb66a77ULL, 0x3fbc8c33221dc2a1ULL,
+				0xe4d5e82392a40515ULL, 0x0fabaf3feaa5334aULL,
+				0x8f05b1163ba6832dULL, 0x29cb4d87f2a7400eULL,
+				0xb2c71d5bca9023f8ULL, 0x743e20e9ef511012ULL,
+				0xdf78e4b2bd342cf6ULL, 0x914da9246b255416ULL,
+				0x8bab8eefb6409c1aULL, 0x1ad089b6c2f7548eULL,
+				0xae9672aba3d0c320ULL, 0xa184ac2473b529b1ULL,
+				0xda3c0f568cc4f3e8ULL, 0xc9e5d72d90a2741eULL,
+				0x8865899617fb1871ULL, 0x7e2fa67c7a658892ULL,
+				0xaa7eebfb9df9de8dULL, 0xddbb901b98feeab7ULL,
+				0xd51ea6fa85785631ULL, 0x552a74227f3ea565ULL,
+				0x8533285c936b35deULL, 0xd53a88958f87275fULL,
+				0xa67ff273b8460356ULL, 0x8a892abaf368f137ULL,
+				0xd01fef10a657842cULL, 0x2d2b7569b0432d85ULL,
+				0x8213f56a67f6b29bULL, 0x9c3b29620e29fc73ULL,
+				0xa298f2c501f45f42ULL, 0x8349f3ba91b47b8fULL,
+				0xcb3f2f7642717713ULL, 0x241c70a936219a73ULL,
+				0xfe0efb53d30dd4d7ULL, 0xed238cd383aa0110ULL,
+				0x9ec95d1463e8a506ULL, 0xf4363804324a40aaULL,
+				0xc67bb4597ce2ce48ULL, 0xb143c6053edcd0d5ULL,
+				0xf81aa16fdc1b81daULL, 0xdd94b7868e94050aULL,
+				0x9b10a4e5e9913128ULL, 0xca7cf2b4191c8326ULL,
+				0xc1d4ce1f63f57d72ULL, 0xfd1c2f611f63a3f0ULL,
+				0xf24a01a73cf2dccfULL, 0xbc633b39673c8cecULL,
+				0x976e41088617ca01ULL, 0xd5be0503e085d813ULL,
+				0xbd49d14aa79dbc82ULL, 0x4b2d8644d8a74e18ULL,
+				0xec9c459d51852ba2ULL, 0xddf8e7d60ed1219eULL,
+				0x93e1ab8252f33b45ULL, 0xcabb90e5c942b503ULL,
+				0xb8da1662e7b00a17ULL, 0x3d6a751f3b936243ULL,
+				0xe7109bfba19c0c9dULL, 0x0cc512670a783ad4ULL,
+				0x906a617d450187e2ULL, 0x27fb2b80668b24c5ULL,
+				0xb484f9dc9641e9daULL, 0xb1f9f660802dedf6ULL,
+				0xe1a63853bbd26451ULL, 0x5e7873f8a0396973ULL,
+				0x8d07e33455637eb2ULL, 0xdb0b487b6423e1e8ULL,
+				0xb049dc016abc5e5fULL, 0x91ce1a9a3d2cda62ULL,
+				0xdc5c5301c56b75f7ULL, 0x7641a140cc7810fbULL,
+				0x89b9b3e11b6329baULL, 0xa9e904c87fcb0a9dULL,
+				0xac2820d9623bf429ULL, 0x546345fa9fbdcd44ULL,
+				0xd732290fbacaf133ULL, 0xa97c177947ad4095ULL,
+				0x867f59a9d4bed6c0ULL, 0x49ed8eabcccc485dULL,
+				0xa81f301449ee8c70ULL, 0x5c68f256bfff5a74ULL,
+				0xd226fc195c6a2f8cULL, 0x73832eec6fff3111ULL,
+				0x83585d8fd9c25db7ULL, 0xc831fd53c5ff7eabULL,
+				0xa42e74f3d032f525ULL, 0xba3e7ca8b77f5e55ULL,
+				0xcd3a1230c43fb26fULL, 0x28ce1bd2e55f35ebULL,
+				0x80444b5e7aa7cf85ULL, 0x7980d163cf5b81b3ULL,
+				0xa0555e361951c366ULL, 0xd7e105bcc332621fULL,
+				0xc86ab5c39fa63440ULL, 0x8dd9472bf3fefaa7ULL,
+				0xfa856334878fc150ULL, 0xb14f98f6f0feb951ULL,
+				0x9c935e00d4b9d8d2ULL, 0x6ed1bf9a569f33d3ULL,
+				0xc3b8358109e84f07ULL, 0x0a862f80ec4700c8ULL,
+				0xf4a642e14c6262c8ULL, 0xcd27bb612758c0faULL,
+				0x98e7e9cccfbd7dbdULL, 0x8038d51cb897789cULL,
+				0xbf21e44003acdd2cULL, 0xe0470a63e6bd56c3ULL,
+				0xeeea5d5004981478ULL, 0x1858ccfce06cac74ULL,
+				0x95527a5202df0ccbULL, 0x0f37801e0c43ebc8ULL,
+				0xbaa718e68396cffdULL, 0xd30560258f54e6baULL,
+				0xe950df20247c83fdULL, 0x47c6b82ef32a2069ULL,
+				0x91d28b7416cdd27eULL, 0x4cdc331d57fa5441ULL,
+				0xb6472e511c81471dULL, 0xe0133fe4adf8e952ULL,
+				0xe3d8f9e563a198e5ULL, 0x58180fddd97723a6ULL,
+				0x8e679c2f5e44ff8fULL, 0x570f09eaa7ea7648ULL
+			};
+			return table + 2 * (q + 342);
+		}
+
+		// nearest double of w * 10^q by Eisel-Lemire algorithm, w MUST NOT be zero
+		inline double eisel_lemire(uint64_t w, int64_t q)
+		{
+			uint64_t bits;
+			if(q < -342) bits = 0;
+			else if(q > 308) bits = 0x7FF0000000000000ULL;
+			else {
+				const int lz = clz64(w);
+				w <<= lz;
+				const uint64_t* p = pow5_128(int(q));
+				uint64_t hi, hi2;
+				uint64_t lo = umul128(w, p[0], hi);
+				// 55 bits are needed, refine with the next 64 bits of 5^q if those below are all ones
+				if((hi & 0x1FF) == 0x1FF) {
+					umul128(w, p[1], hi2);
+					lo += hi2;
+					if(hi2 > lo) ++hi;
+				}
+				const int upperbit = int(hi >> 63);
+				const int shift = upperbit + 9;
+				register uint64_t m = hi >> shift;
+				register int power2 = int(((152170 + 65536) * q) >> 16) + 63 + upperbit - lz + 1023;
+				if(power2 <= 0) {
+					// subnormal
+					if(-power2 + 1 >= 64) bits = 0;
+					else {
+						m >>= -power2 + 1;
+						m += m & 1;
+						bits = m >> 1; // carries into exponent if rounded up to the smallest normal
+					}
+				}
+				else {
+					// exactly halfway, round to even
+					if(lo <= 1 && q >= -4 && q <= 23 && (m & 3) == 1 && (m << shift) == hi) m &= ~1ULL;
+					m += m & 1;
+					m >>= 1;
+					if(m >= (2ULL << 52)) {
+						m = 1ULL << 52;
+						++power2;
+					}
+					bits = (power2 >= 0x7FF) ? 0x7FF0000000000000ULL : (uint64_t(power2) << 52) | (m & ~(1ULL << 52));
+				}
+			}
+			double d;
+			memcpy(&d, &bits, sizeof(d));
+			return d;
+		}
+
+		/*
+			Nearest double of w * 10^q, w MUST NOT be zero.
+			truncated means there are nonzero digits dropped after w, return false if w and w + 1 round differently.
+		*/
+		inline bool to_double(uint64_t w, int64_t q, bool truncated, double& d)
+		{
+#if !(defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD != 0) && !(defined(__FLT_EVAL_METHOD__) && __FLT_EVAL_METHOD__ != 0)
+			// both w and 10^q are exact doubles, so is a single multiplication or division(Clinger's fast path)
+			static const double pow10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+										   1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+			if(!truncated && w <= (1ULL << 53) && q >= -22 && q <= 22) {
+				d = (q < 0) ? double(w) / pow10[-q] : double(w) * pow10[q];
+				return true;
+			}
+#endif
+			d = eisel_lemire(w, q);
+			return !truncated || d == eisel_lemire(w + 1, q);
+		}
+
+		// exact conversion for hard cases, in MUST be digits, point and exponent only
+		template<class char_t>
+		inline double strtod_c(const char_t* in, size_t len)
+		{
+			JSON_TSTRING(char) s(len, '\0');
+			size_t point = len;
+			for(size_t i = 0; i < len; ++i) {
+				if(in[i] == '.') point = i;
+				s[i] = char(in[i]);
+			}
+			// strtod follows LC_NUMERIC
+			if(point != len) s.replace(point, 1, localeconv()->decimal_point);
+			return strtod(s.c_str(), NULL);
+		}
+
+		/*
+			Scan string from pos(after the opening quote or an escaped char), e is set if any char needs conversion.
+			Return offset of the closing quote, len if not closed, or len + 1 if in ends with an unpaired backslash.
+		*/
+		template<class char_t>
+		inline size_t scan_string(const char_t* in, size_t pos, size_t len, bool& e)
+		{
+			if(!e) {
+				// jump to the first character needs conversion, which may be the closing quote
+				pos = skip_plain(in, pos, len);
+				if(pos >= len || in[pos] == '\"') return pos;
+				e = true;
+			}
+			// only quotes and backslashes matter from now on
+			while((pos = find_quote_or_backslash(in, pos, len)) < len && in[pos] == '\\') pos += 2;
+			return pos;
+		}
+
+		// chars may appear in number, true, false and null
+		template<class char_t>
+		inline bool is_scalar_char(char_t ch)
+		{
+			return unsigned(ch - '0') < 10 || unsigned((ch | 0x20) - 'a') < 26 || ch == '.' || ch == '-' || ch == '+';
+		}
+
+		// bitmaps of a 64-char block, bit N stands for in[N]
+		struct block_bitmap
+		{
+			uint64_t quote;
+			uint64_t backslash;
+			uint64_t op;        // {}[]:,
+		};
+
+		template<class char_t>
+		inline void classify_block(const char_t* in, block_bitmap& bm)
+		{
+			bm.quote = bm.backslash = bm.op = 0;
+			for(int i = 0; i < 64; ++i) {
+				switch(in[i]) {
+					case '\"': bm.quote |= 1ULL << i; break;
+					case '\\': bm.backslash |= 1ULL << i; break;
+					case '{': case '}': case '[': case ']': case ':': case ',':
+						bm.op |= 1ULL << i;
+						break;
+					default: break;
+				}
+			}
+		}
+
+#if __XPJSON_SUPPORT_SIMD__ >= 2
+		template<> inline void classify_block<char>(const char* in, block_bitmap& bm)
+		{
+			const __m256i quote = _mm256_set1_epi8('\"'), backslash = _mm256_set1_epi8('\\');
+			// '[' | 0x20 == '{' and ']' | 0x20 == '}'
+			const __m256i lower = _mm256_set1_epi8(0x20), lbrace = _mm256_set1_epi8('{'), rbrace = _mm256_set1_epi8('}');
+			const __m256i colon = _mm256_set1_epi8(':'), comma = _mm256_set1_epi8(',');
+			bm.quote = bm.backslash = bm.op = 0;
+			for(int i = 0; i < 64; i += 32) {
+				const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+				const __m256i l = _mm256_or_si256(v, lower);
+				const __m256i op = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(l, lbrace), _mm256_cmpeq_epi8(l, rbrace)),
+												   _mm256_or_si256(_mm256_cmpeq_epi8(v, colon), _mm256_cmpeq_epi8(v, comma)));
+				bm.quote     |= uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, quote)))) << i;
+				bm.backslash |= uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, backslash)))) << i;
+				bm.op        |= uint64_t(uint32_t(_mm256_movemask_epi8(op))) << i;
+			}
+		}
+#elif __XPJSON_SUPPORT_SIMD__ >= 1
+		template<> inline void classify_block<char>(const char* in, block_bitmap& bm)
+		{
+			const __m128i quote = _mm_set1_epi8('\"'), backslash = _mm_set1_epi8('\\');
+			// '[' | 0x20 == '{' and ']' | 0x20 == '}'
+			const __m128i lower = _mm_set1_epi8(0x20), lbrace = _mm_set1_epi8('{'), rbrace = _mm_set1_epi8('}');
+			const __m128i colon = _mm_set1_epi8(':'), comma = _mm_set1_epi8(',');
+			bm.quote = bm.backslash = bm.op = 0;
+			for(int i = 0; i < 64; i += 16) {
+				const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+				const __m128i l = _mm_or_si128(v, lower);
+				const __m128i op = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(l, lbrace), _mm_cmpeq_epi8(l, rbrace)),
+												_mm_or_si128(_mm_cmpeq_epi8(v, colon), _mm_cmpeq_epi8(v, comma)));
+				bm.quote     |= uint64_t(unsigned(_mm_movemask_epi8(_mm_cmpeq_epi8(v, quote)))) << i;
+				bm.backslash |= uint64_t(unsigned(_mm_movemask_epi8(_mm_cmpeq_epi8(v, backslash)))) << i;
+				bm.op        |= uint64_t(unsigned(_mm_movemask_epi8(op))) << i;
+			}
+		}
+#endif
+
+		// characters escaped by odd-length backslash sequences, carry the last one into next block
+		inline uint64_t find_escaped(uint64_t backslash, uint64_t& prev_escaped)
+		{
+			static const uint64_t even_bits = 0x5555555555555555ULL;
+			backslash &= ~prev_escaped;
+			const uint64_t follows_escape = (backslash << 1) | prev_escaped;
+			const uint64_t odd_starts = backslash & ~even_bits & ~follows_escape;
+			const uint64_t even_starts = odd_starts + backslash;
+			prev_escaped = even_starts < odd_starts; // overflow
+			return (even_bits ^ (even_starts << 1)) & follows_escape;
+		}
+
+		// bit N is set if odd count of bits in [0, N] are set
+		inline uint64_t prefix_xor(uint64_t x)
+		{
+			x ^= x << 1;
+			x ^= x << 2;
+			x ^= x << 4;
+			x ^= x << 8;
+			x ^= x << 16;
+			x ^= x << 32;
+			return x;
+		}
+
+		/* Return offset after the object/array begins at in[pos], or len if not closed.
+		   Only brackets outside strings are matched, contents are not validated. */
+		template<class char_t>
+		size_t skip_container(const char_t* in, size_t pos, size_t len)
+		{
+			block_bitmap bm;
+			uint64_t prev_escaped = 0, prev_in_string = 0;
+			size_t depth = 0;
+			for(size_t base = pos; base < len; base += 64) {
+				if(XPJSON_LIKELY(len - base >= 64)) classify_block(in + base, bm);
+				else {
+					char_t tail[64];
+					std::fill(tail + (len - base), tail + 64, char_t(' '));
+					std::copy(in + base, in + len, tail);
+					classify_block(tail, bm);
+				}
+				const uint64_t quote = bm.quote & ~find_escaped(bm.backslash, prev_escaped);
+				const uint64_t in_string = prefix_xor(quote) ^ prev_in_string;
+				prev_in_string = uint64_t(int64_t(in_string) >> 63);
+				for(uint64_t s = bm.op & ~in_string; s; s &= s - 1) {
+					const size_t i = base + ctz64(s);
+					switch(in[i]) {
+						case '{': case '[': ++depth; break;
+						case '}': case ']': if(!--depth) return i + 1; break;
+						default: break;
+					}
+				}
+			}
+			return len;
+		}
+
+		/* Return offset after the value begins at in[pos], or len if not finished, not validated. */
+		template<class char_t>
+		inline size_t skip_value(const char_t* in, size_t pos, size_t len)
+		{
+			bool e = false;
+			switch(in[pos]) {
+				case '\"': pos = scan_string(in, pos + 1, len, e); return pos < len ? pos + 1 : len;
+				case '{': case '[': return skip_container(in, pos, len);
+				default:
+					while(pos < len && is_scalar_char(in[pos])) ++pos;
+					return pos;
+			}
+		}
+
+		template<class T>
+		class parse_stack
+		{
+		public:
+			parse_stack(T bottom) : _p(_buf), _size(1), _cap(INLINE_SIZE) {_buf[0] = bottom;}
+			~parse_stack() {if(_p != _buf) delete[] _p;}
+			inline void reset(T bottom) {_size = 1; _p[0] = bottom;}
+			inline bool empty() const {return !_size;}
+			inline size_t size() const {return _size;}
+			inline T& back() {return _p[_size - 1];}
+			inline void pop_back() {--_size;}
+			inline void push_back(T v)
+			{
+				if(XPJSON_UNLIKELY(_size == _cap)) grow();
+				_p[_size++] = v;
+			}
+
+		private:
+			/* Only very deep documents spill to heap. */
+			void grow()
+			{
+				T* p = new T[_cap * 2];
+				std::copy(_p, _p + _size, p);
+				if(_p != _buf) delete[] _p;
+				_p = p;
+				_cap *= 2;
+			}
+			parse_stack(const parse_stack&);
+			parse_stack& operator=(const parse_stack&);
+
+			enum {INLINE_SIZE = 32};
+			T* _p;
+			size_t _size;
+			size_t _cap;
+			T _buf[INLINE_SIZE];
+		};
 	}
 
 	/** JSON type of a value. */
@@ -416,12 +1816,312 @@ template<> inline void to_string<type, char_t>(type v, JSON_TSTRING(char_t)& out
 	// Forward declaration
 	template<class char_t>
 	class ValueT;
-
-	/** A JSON object, i.e., a container whose keys are strings, this
-	is roughly equivalent to a Python dictionary, a PHP's associative
-	array, a Perl or a C++ map(depending on the implementation). */
 	template<class char_t>
-	class ObjectT : public std::map<JSON_TSTRING(char_t), ValueT<char_t> > {};
+	class IncrementalReaderT;
+	template<class char_t>
+	struct ReaderT;
+	template<class char_t>
+	class CursorT;
+	template<class char_t>
+	class FieldMaskT;
+	template<class char_t>
+	class ArrayT;
+	template<class char_t>
+	class KeyT;
+
+	namespace detail
+	{
+		/* Unescape reference token of JSON pointer(RFC 6901), ~0 to ~ and ~1 to /, false if bad escape. */
+		template<class char_t>
+		bool unescape_pointer(const char_t* s, size_t len, JSON_TSTRING(char_t)& out)
+		{
+			out.clear();
+			for(size_t i = 0; i < len; ++i) {
+				if(s[i] != '~') out += s[i];
+				else if(i + 1 < len && (s[i + 1] == '0' || s[i + 1] == '1')) out += (s[++i] == '0') ? '~' : '/';
+				else return false;
+			}
+			return true;
+		}
+
+		/* Array index of reference token, digits without leading zero, false if not. */
+		template<class char_t>
+		bool pointer_index(const char_t* token, size_t len, size_t& index)
+		{
+			if(!len || len > 18 || (token[0] == '0' && len > 1)) return false;
+			index = 0;
+			for(size_t i = 0; i < len; ++i) {
+				if(unsigned(token[i] - '0') >= 10) return false;
+				index = index * 10 + (token[i] - '0');
+			}
+			return true;
+		}
+
+		// node of FieldMaskT, children are indexes of nodes, 0 for none
+		template<class char_t>
+		struct mask_node
+		{
+			typedef std::map<KeyT<char_t>, size_t> key_map;
+			typedef std::map<size_t, size_t> index_map;
+			key_map keys;
+			index_map indexes;
+			size_t any;  // child of "*"
+			bool leaf;   // a path ends here
+			size_t id;   // of path without "*", -1 if with
+			mask_node() : any(0), leaf(false), id((size_t)-1) {}
+		};
+
+		// range of topmost array elements read by one thread of ValueT::read_parallel
+		template<class char_t>
+		struct elements_task
+		{
+			const char_t* in;
+			size_t len;
+			size_t begin; // of first element
+			size_t count;
+			typename ArrayT<char_t>::iterator out;
+			bool cow;
+#if __XPJSON_SUPPORT_THREAD__ && __XPJSON_SUPPORT_EXCEPTIONS__
+			std::exception_ptr error;
+#endif
+		};
+
+		// number in string value for type casting
+		template<class char_t>
+		struct string_number;
+
+		// object/array being read by ValueT::read with mask
+		template<class char_t>
+		struct mask_frame
+		{
+			ValueT<char_t>* v;
+			size_t node;
+			size_t index; // of next array element
+		};
+
+		/* Types of open objects/arrays by ReaderT::validate, a bit each, never allocates. */
+		class type_stack
+		{
+		public:
+			type_stack() : _size(0) {}
+			inline bool empty() const {return !_size;}
+			inline size_t size() const {return _size;}
+			inline unsigned char back() const {return (_bits[(_size - 1) >> 5] >> ((_size - 1) & 31)) & 1 ? OBJECT : ARRAY;}
+			inline void pop_back() {--_size;}
+			/* MUST NOT be deeper than __XPJSON_MAX_DEPTH__. */
+			inline void push_back(unsigned char type)
+			{
+				uint32_t& w = _bits[_size >> 5];
+				const uint32_t bit = 1u << (_size & 31);
+				// words are filled from their lowest bits
+				w = (_size & 31) ? (w & ~bit) : 0;
+				if(type == OBJECT) w |= bit;
+				++_size;
+			}
+
+		private:
+			uint32_t _bits[(__XPJSON_MAX_DEPTH__ + 31) / 32];
+			size_t _size;
+		};
+	}
+
+	/**
+		Compiled JSON pointer(RFC 6901) paths for projection read, e.g. "/media/uri", "/images/0/width".
+		Token "*" matches any key or index, paths matched by an exact key or index and by "*" are merged.
+		"" selects the whole document.
+		With stop_early, read returns as soon as every path is found(so the first of duplicate keys wins),
+		unless some path has "*".
+	*/
+	template<class char_t>
+	class FieldMaskT
+	{
+	public:
+		typedef JSON_TSTRING(char_t) tstring;
+
+		FieldMaskT(bool stop_early = false) : _nodes(1), _exact(0), _wildcard(false), _stop_early(stop_early) {}
+
+		/** Add a path, throws if it's not a valid JSON pointer. */
+		FieldMaskT& add(const char_t* path, size_t len);
+		inline FieldMaskT& add(const char_t* path) {return add(path, detail::tcslen(path));}
+		inline FieldMaskT& add(const tstring& path) {return add(path.data(), path.size());}
+
+	private:
+		friend class ValueT<char_t>;
+
+		/* Add tokens from i on under node n, "*" goes into exact children too, so they match both. */
+		void insert(size_t n, const std::vector<tstring>& tokens, size_t i, bool wildcard);
+		/* Deep copy of subtree of node n, return node of the copy. */
+		size_t copy(size_t n);
+
+		std::vector<detail::mask_node<char_t> > _nodes; // root first
+		size_t _exact;                                  // count of paths without "*"
+		bool _wildcard;
+		bool _stop_early;
+	};
+
+	typedef FieldMaskT<char>    FieldMask;
+	typedef FieldMaskT<wchar_t> FieldMaskW;
+
+	/** Key of object, works like STD string for lookup, compare and output.
+	Keys read with cow refer to input(escaped ones too if read in-situ), others are owned,
+	short ones are stored inside like sso. Cow keys are NOT NUL-terminated, so there is no
+	c_str(), use data() with length(), or str() for a copy. */
+	template<class char_t>
+	class KeyT
+	{
+	public:
+		typedef JSON_TSTRING(char_t) tstring;
+
+		KeyT() : _d(_sso_s), _len(0) {_sso_s[0] = 0;}
+		/** Owned copy of string. */
+		KeyT(const char_t* s) : _d(_sso_s), _len(0) {assign(s, detail::tcslen(s));}
+		KeyT(const char_t* s, size_t len) : _d(_sso_s), _len(0) {assign(s, len);}
+		KeyT(const tstring& s) : _d(_sso_s), _len(0) {assign(s.data(), s.size());}
+		/** Cow keys stay cow. */
+		KeyT(const KeyT<char_t>& k) : _d(_sso_s), _len(0)
+		{
+			if(k.cow()) {_d = k._d; _len = k._len; _cow = true;}
+			else assign(k._d, k._len);
+		}
+#ifdef __XPJSON_SUPPORT_MOVE__
+		KeyT(KeyT<char_t>&& k) : _d(_sso_s), _len(0)
+		{
+			if(k.sso()) assign(k._d, k._len);
+			else {_d = k._d; _len = k._len; _cow = k._cow; k._d = k._sso_s; k._len = 0; k._sso_s[0] = 0;}
+		}
+#endif
+		~KeyT() {if(!sso() && !_cow) delete[] _d;}
+
+		KeyT<char_t>& operator=(const KeyT<char_t>& k)
+		{
+			if(this != &k) {KeyT<char_t> t(k); swap(t);}
+			return *this;
+		}
+		void swap(KeyT<char_t>& k)
+		{
+			if(sso() || k.sso()) {
+				KeyT<char_t> t;
+				t.take(*this);
+				take(k);
+				k.take(t);
+			}
+			else {
+				std::swap(_d, k._d);
+				std::swap(_len, k._len);
+				std::swap(_cow, k._cow);
+			}
+		}
+
+		/** Key refers to s, which MUST outlive it. */
+		static KeyT<char_t> ref(const char_t* s, size_t len)
+		{
+			KeyT<char_t> k;
+			k._d = s;
+			k._len = len;
+			k._cow = true;
+			return k;
+		}
+
+		inline const char_t* data() const {return _d;}
+		inline size_t length() const {return _len;}
+		inline size_t size() const {return _len;}
+		inline bool empty() const {return !_len;}
+		inline const char_t* begin() const {return _d;}
+		inline const char_t* end() const {return _d + _len;}
+		inline const char_t& operator[](size_t pos) const {return _d[pos];}
+		inline bool cow() const {return !sso() && _cow;}
+		inline tstring str() const {return tstring(_d, _len);}
+		inline operator tstring() const {return tstring(_d, _len);}
+
+		inline int compare(const char_t* s, size_t len) const
+		{
+			const int r = std::char_traits<char_t>::compare(_d, s, _len < len ? _len : len);
+			return r ? r : (_len < len ? -1 : (_len > len ? 1 : 0));
+		}
+		inline int compare(const KeyT<char_t>& k) const {return compare(k._d, k._len);}
+		inline int compare(const tstring& s) const {return compare(s.data(), s.size());}
+
+	private:
+		inline bool sso() const {return _d == _sso_s;}
+		// owned copy, _d is not allocated yet
+		void assign(const char_t* s, size_t len)
+		{
+			char_t* d = (len < SSO_SIZE) ? _sso_s : new char_t[len + 1];
+			std::char_traits<char_t>::copy(d, s, len);
+			d[len] = 0;
+			_d = d;
+			_len = len;
+			if(!sso()) _cow = false;
+		}
+		// steal k, leave it empty, _d is not allocated
+		void take(KeyT<char_t>& k)
+		{
+			if(k.sso()) assign(k._d, k._len);
+			else {_d = k._d; _len = k._len; _cow = k._cow;}
+			k._d = k._sso_s;
+			k._len = 0;
+			k._sso_s[0] = 0;
+		}
+
+		enum {SSO_SIZE = 16 / sizeof(char_t)};
+		const char_t* _d;
+		size_t _len;
+		union {
+			char_t _sso_s[SSO_SIZE]; // NUL-terminated if _d is here
+			bool _cow;               // if not sso, _d refers to others
+		};
+	};
+
+	typedef KeyT<char>    Key;
+	typedef KeyT<wchar_t> KeyW;
+
+	template<class char_t> inline bool operator<(const KeyT<char_t>& lhs, const KeyT<char_t>& rhs) {return lhs.compare(rhs) < 0;}
+	template<class char_t> inline bool operator==(const KeyT<char_t>& lhs, const KeyT<char_t>& rhs) {return lhs.length() == rhs.length() && !lhs.compare(rhs);}
+	template<class char_t> inline bool operator==(const KeyT<char_t>& k, const char_t* s) {return !k.compare(s, detail::tcslen(s));}
+	template<class char_t> inline bool operator==(const KeyT<char_t>& k, const JSON_TSTRING(char_t)& s) {return !k.compare(s);}
+	template<class char_t> inline bool operator==(const char_t* s, const KeyT<char_t>& k) {return operator==(k, s);}
+	template<class char_t> inline bool operator==(const JSON_TSTRING(char_t)& s, const KeyT<char_t>& k) {return operator==(k, s);}
+	template<class char_t> inline bool operator!=(const KeyT<char_t>& lhs, const KeyT<char_t>& rhs) {return !operator==(lhs, rhs);}
+	template<class char_t> inline bool operator!=(const KeyT<char_t>& k, const char_t* s) {return !operator==(k, s);}
+	template<class char_t> inline bool operator!=(const KeyT<char_t>& k, const JSON_TSTRING(char_t)& s) {return !operator==(k, s);}
+	template<class char_t> inline bool operator!=(const char_t* s, const KeyT<char_t>& k) {return !operator==(k, s);}
+	template<class char_t> inline bool operator!=(const JSON_TSTRING(char_t)& s, const KeyT<char_t>& k) {return !operator==(k, s);}
+	template<class ostream_t, class char_t> inline ostream_t& operator<<(ostream_t& os, const KeyT<char_t>& k) {os.write(k.data(), k.length()); return os;}
+
+	/** A JSON object, i.e., a container whose keys are strings, this
+	is roughly equivalent to a Python dictionary, a PHP's associative
+	array, a Perl or a C++ map(depending on the implementation).
+	Lookup by char_t* or STD string doesn't copy the key. */
+	template<class char_t>
+	class ObjectT : public std::map<KeyT<char_t>, ValueT<char_t> >
+	{
+	public:
+		typedef std::map<KeyT<char_t>, ValueT<char_t> > base;
+		typedef JSON_TSTRING(char_t) tstring;
+		using base::find;
+		using base::count;
+		using base::operator[];
+
+		inline typename base::iterator find(const char_t* key) {return base::find(KeyT<char_t>::ref(key, detail::tcslen(key)));}
+		inline typename base::const_iterator find(const char_t* key) const {return base::find(KeyT<char_t>::ref(key, detail::tcslen(key)));}
+		inline typename base::iterator find(const tstring& key) {return base::find(KeyT<char_t>::ref(key.data(), key.size()));}
+		inline typename base::const_iterator find(const tstring& key) const {return base::find(KeyT<char_t>::ref(key.data(), key.size()));}
+		inline size_t count(const char_t* key) const {return base::count(KeyT<char_t>::ref(key, detail::tcslen(key)));}
+		inline size_t count(const tstring& key) const {return base::count(KeyT<char_t>::ref(key.data(), key.size()));}
+		/** Key is copied only if inserted. */
+		inline ValueT<char_t>& operator[](const char_t* key) {return at_key(key, detail::tcslen(key));}
+		inline ValueT<char_t>& operator[](const tstring& key) {return at_key(key.data(), key.size());}
+
+	private:
+		ValueT<char_t>& at_key(const char_t* key, size_t len)
+		{
+			const KeyT<char_t> k(KeyT<char_t>::ref(key, len));
+			typename base::iterator it = base::lower_bound(k);
+			if(it == base::end() || k < it->first)
+				it = base::insert(it, typename base::value_type(KeyT<char_t>(key, len), ValueT<char_t>()));
+			return it->second;
+		}
+	};
 
 	typedef ObjectT<char>    Object;
 	typedef ObjectT<wchar_t> ObjectW;
@@ -434,6 +2134,42 @@ template<> inline void to_string<type, char_t>(type v, JSON_TSTRING(char_t)& out
 	typedef ArrayT<char>    Array;
 	typedef ArrayT<wchar_t> ArrayW;
 
+	/** Result of ValueT::try_read, error and offset only, message is formatted on demand. */
+	template<class char_t>
+	class ReadResultT
+	{
+	public:
+		ReadResultT() : error(ERROR_NONE), offset(0), _in(NULL), _len(0), _line(0) {}
+
+		Error error;
+		/** char_t count parsed if succeeded, or where the error is found. */
+		size_t offset;
+
+		inline bool ok() const {return error == ERROR_NONE;}
+		/** Formatted like the exception thrown by read, input MUST be alive. */
+		JSON_TSTRING(char) message() const
+		{
+			return ok() ? JSON_TSTRING(char)() : detail::error_message(error, _in, _len, offset, _line);
+		}
+
+	private:
+		friend class ValueT<char_t>;
+		friend struct ReaderT<char_t>;
+
+		ReadResultT(size_t ret, const char_t* in, size_t len, const detail::read_error<char_t>& err)
+			: error(err.code), offset(ret), _in(in), _len(len), _line(err.line)
+		{
+			if(XPJSON_UNLIKELY(error != ERROR_NONE)) offset = err.at - in;
+		}
+
+		const char_t* _in;
+		size_t _len;
+		int _line; // of xpjson.hpp
+	};
+
+	typedef ReadResultT<char>    ReadResult;
+	typedef ReadResultT<wchar_t> ReadResultW;
+
 	/** A JSON value. Can have either type in ValueTypes. */
 	template<class char_t>
 	class ValueT
@@ -482,18 +2218,18 @@ template<> inline void to_string<type, char_t>(type v, JSON_TSTRING(char_t)& out
 		/** Constructor from STD string  */
 		ValueT(const tstring& s, int escape = AUTO_DETECT, bool cow = false) : _type(NIL) {assign(s.data(), s.size(), escape, cow);}
 		/** Constructor from pointer to Object. */
-		ValueT(const ObjectT<char_t>& o) : _type(OBJECT), _o(0) {_o = new ObjectT<char_t>(o);}
+		ValueT(const ObjectT<char_t>& o) : _type(OBJECT), _sso(false), _o(0) {_o = new ObjectT<char_t>(o);}
 		/** Constructor from pointer to Array. */
-		ValueT(const ArrayT<char_t>& a) : _type(ARRAY), _a(0) {_a = new ArrayT<char_t>(a);}
+		ValueT(const ArrayT<char_t>& a) : _type(ARRAY), _sso(false), _a(0) {_a = new ArrayT<char_t>(a);}
 #ifdef __XPJSON_SUPPORT_MOVE__
 		/** Move constructor. */
 		ValueT(ValueT<char_t>&& v) : _type(NIL) {assign(JSON_MOVE(v));}
 		/** Move constructor from STD string  */
 		ValueT(tstring&& s, int escape = AUTO_DETECT) : _type(NIL) {assign(JSON_MOVE(s), escape);}
 		/** Move constructor from pointer to Object. */
-		ValueT(ObjectT<char_t>&& o) : _type(OBJECT), _o(0) {_o = new ObjectT<char_t>(JSON_MOVE(o));}
+		ValueT(ObjectT<char_t>&& o) : _type(OBJECT), _sso(false), _o(0) {_o = new ObjectT<char_t>(JSON_MOVE(o));}
 		/** Move constructor from pointer to Array. */
-		ValueT(ArrayT<char_t>&& a) : _type(ARRAY), _a(0) {_a = new ArrayT<char_t>(JSON_MOVE(a));}
+		ValueT(ArrayT<char_t>&& a) : _type(ARRAY), _sso(false), _a(0) {_a = new ArrayT<char_t>(JSON_MOVE(a));}
 #endif
 
 		~ValueT() {clear();}
@@ -607,12 +2343,14 @@ template<> inline void to_string<type, char_t>(type v, JSON_TSTRING(char_t)& out
 		inline operator ObjectT<char_t>() const
 		{
 			JSON_CHECK_TYPE(_type, OBJECT);
+			expand();
 			return *_o;
 		}
 		/** Cast operator for Array */
 		inline operator ArrayT<char_t>() const
 		{
 			JSON_CHECK_TYPE(_type, ARRAY);
+			expand();
 			return *_a;
 		}
 
@@ -680,41 +2418,47 @@ template<> inline void to_string<type, char_t>(type v, JSON_TSTRING(char_t)& out
 		/** Fetch object reference */
 		inline ObjectT<char_t>& o()
 		{
-			if(_type == NIL) {_type = OBJECT; _o = new ObjectT<char_t>;}
+			if(_type == NIL) {_type = OBJECT; _sso = false; _o = new ObjectT<char_t>;}
 			JSON_CHECK_TYPE(_type, OBJECT);
+			expand();
 			return *_o;
 		}
 		/** Fetch object const-reference */
 		inline const ObjectT<char_t>& o() const
 		{
 			JSON_CHECK_TYPE(_type, OBJECT);
+			expand();
 			return *_o;
 		}
 		/** Fetch array reference */
 		inline ArrayT<char_t>& a()
 		{
-			if(_type == NIL) {_type = ARRAY; _a = new ArrayT<char_t>;}
+			if(_type == NIL) {_type = ARRAY; _sso = false; _a = new ArrayT<char_t>;}
 			JSON_CHECK_TYPE(_type, ARRAY);
+			expand();
 			return *_a;
 		}
 		/** Fetch array const-reference */
 		inline const ArrayT<char_t>& a() const
 		{
 			JSON_CHECK_TYPE(_type, ARRAY);
+			expand();
 			return *_a;
 		}
 		/** Support [] operator for object. */
 		inline ValueT<char_t>& operator[](const char_t* key)
 		{
-			if(_type == NIL) {_type = OBJECT; _o = new ObjectT<char_t>;}
+			if(_type == NIL) {_type = OBJECT; _sso = false; _o = new ObjectT<char_t>;}
 			JSON_CHECK_TYPE(_type, OBJECT);
+			expand();
 			return (*_o)[key];
 		}
 		/** Support [] operator for object. */
 		inline ValueT<char_t>& operator[](const tstring& key)
 		{
-			if(_type == NIL) {_type = OBJECT; _o = new ObjectT<char_t>;}
+			if(_type == NIL) {_type = OBJECT; _sso = false; _o = new ObjectT<char_t>;}
 			JSON_CHECK_TYPE(_type, OBJECT);
+			expand();
 			return (*_o)[key];
 		}
 		/** Support [] operator for array. */
@@ -722,9 +2466,10 @@ template<> inline void to_string<type, char_t>(type v, JSON_TSTRING(char_t)& out
 		inline typename detail::json_enable_if<detail::json_is_integral<T>::value, ValueT<char_t>&>::type
 		operator[](T pos)
 		{
-			if(_type == NIL) {_type = ARRAY; _a = new ArrayT<char_t>;}
+			if(_type == NIL) {_type = ARRAY; _sso = false; _a = new ArrayT<char_t>;}
 			JSON_ASSERT_CHECK(pos >= 0, std::underflow_error, "Array index underflow");
 			JSON_CHECK_TYPE(_type, ARRAY);
+			expand();
 			if (pos >= _a->size()) _a->resize(pos + 1);
 			return (*_a)[pos];
 		}
@@ -745,19 +2490,112 @@ template<> inline void to_string<type, char_t>(type v, JSON_TSTRING(char_t)& out
 
 		/**
 			Read object/array from stream.
+			With cow, strings and keys without escapes refer to in, which MUST outlive the value.
 			Return char_t count(offset) parsed.
 			If error occurred, throws an exception.
 		*/
-		size_t read(const char_t* in, size_t len, bool cow = false);
+		size_t read(const char_t* in, size_t len, bool cow = false) {return read(in, len, cow, 0);}
 		size_t read(const char_t* in, bool cow = false)
 		{
-			return read(in, detail::tcslen(in), cow);
+			return read(in, detail::tcslen(in), cow, 0);
 		}
 		size_t read(const tstring& in, bool cow = false)
 		{
-			return read(in.data(), in.size(), cow);
+			return read(in.data(), in.size(), cow, 0);
+		}
+
+		/**
+			Same as read, but errors are returned instead of thrown, works without exceptions(-fno-exceptions).
+			Nothing is formatted for an error, value is partially read then.
+		*/
+		ReadResultT<char_t> try_read(const char_t* in, size_t len, bool cow = false);
+		ReadResultT<char_t> try_read(const tstring& in, bool cow = false)
+		{
+			return try_read(in.data(), in.size(), cow);
+		}
+		/**
+			Same as read/try_read, but stops as soon as a budget of limits is exceeded, see ReadLimits.
+			Usage is counted into limits, ERROR_DEPTH or ERROR_LIMIT is reported if exceeded.
+		*/
+		size_t read(const char_t* in, size_t len, ReadLimits& limits, bool cow = false);
+		ReadResultT<char_t> try_read(const char_t* in, size_t len, ReadLimits& limits, bool cow = false);
+
+		/**
+			Read object/array from a writable buffer, strings are decoded in place if escaped, so all of them
+			refer to in like cow, keys too. in is modified, and MUST outlive the value.
+			Return char_t count(offset) parsed.
+			If error occurred, throws an exception, in may be partially decoded then.
+		*/
+		size_t read_insitu(char_t* in, size_t len) {return read(in, len, INSITU, 0);}
+		size_t read_insitu(tstring& in) {return in.empty() ? read(in.data(), 0, INSITU, 0) : read(&in[0], in.size(), INSITU, 0);}
+
+		/**
+			Read object/array into this value reusing what it holds, for messages of the same shape read one by one.
+			Members of existing keys and elements at existing indexes are overwritten in place, keeping their
+			map nodes, keys, containers and string capacity, others are erased, so nothing is allocated if the shape
+			is unchanged. Result is the same as read, keys are owned, and value MUST NOT refer to a freed input.
+			Return char_t count(offset) parsed.
+			If error occurred, throws an exception, value is partially read then.
+		*/
+		size_t read_reuse(const char_t* in, size_t len) {return read(in, len, false, 0, 1, NULL, NULL, true);}
+		size_t read_reuse(const tstring& in) {return read_reuse(in.data(), in.size());}
+		/** Same as read_reuse, but errors are returned instead of thrown like try_read. */
+		ReadResultT<char_t> try_read_reuse(const char_t* in, size_t len);
+		ReadResultT<char_t> try_read_reuse(const tstring& in) {return try_read_reuse(in.data(), in.size());}
+
+		/**
+			Read object/array lazily, nested objects/arrays at depth(topmost is 0) or deeper are kept
+			as raw spans of in, only brackets are matched. They are parsed level by level on first
+			access by o(), a() or [], and written verbatim if untouched.
+			in MUST outlive the value even if not cow, so temporary strings are not accepted.
+			Unparsed spans are validated only when accessed.
+			Spans are parsed by const accessors too, so a lazy value MUST NOT be shared by threads until expanded.
+			Return char_t count(offset) parsed.
+			If error occurred, throws an exception, so does accessing a malformed span, which is kept raw then.
+		*/
+		size_t read_lazy(const char_t* in, size_t len, size_t depth = 1, bool cow = false)
+		{
+			return read(in, len, cow, depth ? depth : 1);
+		}
+		size_t read_lazy(const char_t* in)
+		{
+			return read_lazy(in, detail::tcslen(in));
+		}
+		size_t read_lazy(const tstring& in, size_t depth = 1, bool cow = false)
+		{
+			return read_lazy(in.data(), in.size(), depth, cow);
+		}
+#if defined(__XPJSON_SUPPORT_MOVE__) && defined(__XPJSON_SUPPORT_DELETE__)
+		size_t read_lazy(tstring&& in, size_t depth = 1, bool cow = false) = delete;
+#endif
+		/**
+			Read a huge topmost array by threads(0 for hardware concurrency), result is the same as read.
+			Elements are located by bracket matching, split into even ranges and read into their places concurrently.
+			Other documents, or without thread support, are read by read.
+			Return char_t count(offset) parsed.
+			If error occurred, throws an exception.
+		*/
+		size_t read_parallel(const char_t* in, size_t len, unsigned threads = 0, bool cow = false);
+		size_t read_parallel(const tstring& in, unsigned threads = 0, bool cow = false)
+		{
+			return read_parallel(in.data(), in.size(), threads, cow);
+		}
+		/**
+			Read object/array projected by mask, only the selected paths are built, others are
+			skipped by bracket matching without validation or allocation(but escaped keys are decoded).
+			Array elements keep their indexes, elements not selected before them are null.
+			Return char_t count(offset) parsed, or offset after the last path if stopped early.
+			If error occurred, throws an exception.
+		*/
+		size_t read(const char_t* in, size_t len, const FieldMaskT<char_t>& mask, bool cow = false);
+		size_t read(const tstring& in, const FieldMaskT<char_t>& mask, bool cow = false)
+		{
+			return read(in.data(), in.size(), mask, cow);
 		}
 
+		/** True if it's an object/array not parsed yet. */
+		inline bool lazy() const {return (_type == OBJECT || _type == ARRAY) && _sso;}
+
 		const char_t* c_str() const
 		{
 			JSON_CHECK_TYPE(_type, STRING);
@@ -785,19 +2623,86 @@ template<> inline void to_string<type, char_t>(type v, JSON_TSTRING(char_t)& out
 			Return char_t count(offset) parsed.
 			If error occurred, throws an exception.
 		*/
-		size_t read_nil(const char_t* in, size_t len, bool cow = false);
-		size_t read_boolean(const char_t* in, size_t len, bool cow = false);
-		size_t read_number(const char_t* in, size_t len, bool cow = false);
+		size_t read_nil(const char_t* in, size_t len, bool cow = false)
+		{
+			register size_t pos = detail::skip_ws(in, 0, len);
+			return pos + parse_nil(in + pos, len - pos, cow);
+		}
+		size_t read_boolean(const char_t* in, size_t len, bool cow = false)
+		{
+			register size_t pos = detail::skip_ws(in, 0, len);
+			return pos + parse_boolean(in + pos, len - pos, cow);
+		}
+		size_t read_number(const char_t* in, size_t len, bool cow = false)
+		{
+			register size_t pos = detail::skip_ws(in, 0, len);
+			return pos + parse_number(in + pos, len - pos, cow);
+		}
 		/* NOTE: MUST with quotes.*/
-		size_t read_string(const char_t* in, size_t len, bool cow = false);
+		size_t read_string(const char_t* in, size_t len, bool cow = false)
+		{
+			register size_t pos = detail::skip_ws(in, 0, len);
+			return pos + parse_string(in + pos, len - pos, cow);
+		}
 
 	protected:
+		/* cow of read and parse_string, strings with escapes are decoded in place and refer to in too. */
+		enum {INSITU = 2};
+		/*
+			Containers at lazy_depth or deeper are kept raw, 0 for none. depth is of this value in document, for depth limit.
+			Parsers below with err record errors into it and return 0 instead of throwing, see detail::read_fail.
+		*/
+		size_t read(const char_t* in, size_t len, int cow, size_t lazy_depth, size_t depth = 1, detail::read_error<char_t>* err = NULL, ReadLimits* limits = NULL, bool reuse = false);
+		/* Start reading object/array into this value by read_reuse, members are unkept, elements are counted by _cow_len. */
+		void reuse_begin(unsigned char type);
+		/* Erase members not kept and elements not counted after object/array is read by read_reuse. */
+		void reuse_end();
+		/* Next element of array read by read_reuse, existing one or appended. */
+		inline ValueT<char_t>& reuse_element()
+		{
+			if(_cow_len == _a->size()) _a->push_back(JSON_MOVE(ValueT<char_t>()));
+			return (*_a)[_cow_len++];
+		}
+		/* Add usage of this value just read to limits, nodes and alloc of its place, n chars from input. */
+		bool charge_limits(ReadLimits& limits, size_t nodes, size_t alloc, size_t n = 0) const;
+		/* Estimated heap bytes of an object member, key of len is owned unless cow. */
+		static inline size_t member_bytes(size_t len, bool cow)
+		{
+			// tree node links and color, key is sso if short like KeyT
+			return sizeof(typename ObjectT<char_t>::value_type) + 4 * sizeof(void*) + ((cow || len < 16 / sizeof(char_t)) ? 0 : (len + 1) * sizeof(char_t));
+		}
+		/* Read elements of the range into their places, run by threads of read_parallel. */
+		static void read_elements(detail::elements_task<char_t>* t);
+		/* Keep object/array starting at in[0] as raw span. */
+		size_t parse_lazy(const char_t* in, size_t len, bool cow, detail::read_error<char_t>* err = NULL);
+		/* Parse raw span of a lazy object/array, one level at a time. */
+		inline void expand() const {if(XPJSON_UNLIKELY(_sso)) const_cast<ValueT<char_t>*>(this)->expand_raw();}
+		void expand_raw();
+		/* Same as read_xxx, but value MUST start at in[0], called by parser directly. */
+		size_t parse_nil(const char_t* in, size_t len, bool cow, detail::read_error<char_t>* err = NULL);
+		size_t parse_boolean(const char_t* in, size_t len, bool cow, detail::read_error<char_t>* err = NULL);
+		size_t parse_number(const char_t* in, size_t len, bool cow, detail::read_error<char_t>* err = NULL);
+		size_t parse_string(const char_t* in, size_t len, int cow, detail::read_error<char_t>* err = NULL);
+		/* Assign string content between quotes, decode it if e. false if bad escape. */
+		bool assign_raw(const char_t* s, size_t len, bool e, int cow, detail::read_error<char_t>* err = NULL);
+		/*
+			Value of key between quotes in object, decoded if e, the key refers to s if cow. Duplicate key overrides. NULL if bad escape.
+			With reuse, value of an existing key is kept as is.
+		*/
+		ValueT<char_t>* key_value(const char_t* s, size_t len, bool e, int cow, detail::read_error<char_t>* err = NULL, bool reuse = false);
+
+		friend class IncrementalReaderT<char_t>;
+		friend struct ReaderT<char_t>;
+		friend class CursorT<char_t>;
+		friend struct detail::string_number<char_t>;
+
 		unsigned char _type       : 3;
-		mutable bool _sso         : 1; // small-string-optimization
+		mutable bool _sso         : 1; // small-string-optimization, or raw span of lazy object/array
+		bool _kept                : 1; // member of object read by read_reuse, others are erased
 		union {
 			struct {     // not sso
 				mutable bool _cow : 1; // used for copy-on-write string
-				bool _e           : 1; // used for string, indicates needs to be escaped or encoded.
+				bool _e           : 1; // used for string, indicates needs to be escaped or encoded, cow of lazy object/array.
 				char              : 2; // reserved
 			};
 			unsigned int _sso_len : 4;
@@ -818,6 +2723,59 @@ template<> inline void to_string<type, char_t>(type v, JSON_TSTRING(char_t)& out
 	typedef ValueT<char>    Value;
 	typedef ValueT<wchar_t> ValueW;
 
+	namespace detail
+	{
+		/* Whole file mapped read-only, or read into memory if mmap is not supported. */
+		class mapped_file
+		{
+		public:
+			mapped_file() : _p(NULL), _size(0) {}
+			~mapped_file() {close();}
+			/* false if failed, previous file is closed. */
+			bool open(const char* path);
+			void close();
+			/* Sequential access pattern while parsing, normal after. */
+			void advise(bool sequential);
+			inline const void* data() const {return _p;}
+			inline size_t size() const {return _size;}
+
+		private:
+			mapped_file(const mapped_file&);
+			mapped_file& operator=(const mapped_file&);
+
+			void* _p;
+			size_t _size; // in bytes
+		};
+	}
+
+	/** A JSON value owning its input, strings and keys refer to it like cow, see ReaderT::read_file.
+	Not copyable, values copied out of it refer to the input too, they MUST NOT outlive it. */
+	template<class char_t>
+	class DocumentT : public ValueT<char_t>
+	{
+	public:
+		DocumentT() {}
+		~DocumentT() {this->clear();}
+
+		/**
+			Read object/array from file, the file is mapped and kept until next read_file or close.
+			Return char_t count(offset) parsed, file size should be multiple of sizeof(char_t).
+			If error occurred, throws an exception, then the document is closed.
+		*/
+		size_t read_file(const char* path);
+		/** Clear value and release the file. */
+		void close() {this->clear(); _file.close();}
+
+	private:
+		DocumentT(const DocumentT<char_t>&);
+		DocumentT<char_t>& operator=(const DocumentT<char_t>&);
+
+		detail::mapped_file _file;
+	};
+
+	typedef DocumentT<char>    Document;
+	typedef DocumentT<wchar_t> DocumentW;
+
 	template<class char_t>
 	struct WriterT
 	{
@@ -835,11 +2793,268 @@ template<> inline void to_string<type, char_t>(type v, JSON_TSTRING(char_t)& out
 		static inline size_t read(ValueT<char_t>& v, const char_t* in, size_t len, bool cow = false) {return v.read(in, len, cow);}
 		static inline size_t read(ValueT<char_t>& v, const char_t* in, bool cow = false) {return v.read(in, detail::tcslen(in), cow);}
 		static inline size_t read(ValueT<char_t>& v, const JSON_TSTRING(char_t)& in, bool cow = false) {return v.read(in.data(), in.size(), cow);}
+		static inline ReadResultT<char_t> try_read(ValueT<char_t>& v, const char_t* in, size_t len, bool cow = false) {return v.try_read(in, len, cow);}
+		static inline ReadResultT<char_t> try_read(ValueT<char_t>& v, const JSON_TSTRING(char_t)& in, bool cow = false) {return v.try_read(in.data(), in.size(), cow);}
+		static inline size_t read(ValueT<char_t>& v, const char_t* in, size_t len, ReadLimits& limits, bool cow = false) {return v.read(in, len, limits, cow);}
+		static inline ReadResultT<char_t> try_read(ValueT<char_t>& v, const char_t* in, size_t len, ReadLimits& limits, bool cow = false) {return v.try_read(in, len, limits, cow);}
+		static inline size_t read(ValueT<char_t>& v, const char_t* in, size_t len, const FieldMaskT<char_t>& mask, bool cow = false) {return v.read(in, len, mask, cow);}
+		static inline size_t read(ValueT<char_t>& v, const JSON_TSTRING(char_t)& in, const FieldMaskT<char_t>& mask, bool cow = false) {return v.read(in.data(), in.size(), mask, cow);}
+		static inline size_t read_insitu(ValueT<char_t>& v, char_t* in, size_t len) {return v.read_insitu(in, len);}
+		static inline size_t read_insitu(ValueT<char_t>& v, JSON_TSTRING(char_t)& in) {return v.read_insitu(in);}
+		static inline size_t read_reuse(ValueT<char_t>& v, const char_t* in, size_t len) {return v.read_reuse(in, len);}
+		static inline size_t read_reuse(ValueT<char_t>& v, const JSON_TSTRING(char_t)& in) {return v.read_reuse(in);}
+		static inline ReadResultT<char_t> try_read_reuse(ValueT<char_t>& v, const char_t* in, size_t len) {return v.try_read_reuse(in, len);}
+		static inline size_t read_lazy(ValueT<char_t>& v, const char_t* in, size_t len, size_t depth = 1, bool cow = false) {return v.read_lazy(in, len, depth, cow);}
+		static inline size_t read_lazy(ValueT<char_t>& v, const char_t* in) {return v.read_lazy(in, detail::tcslen(in));}
+		static inline size_t read_lazy(ValueT<char_t>& v, const JSON_TSTRING(char_t)& in, size_t depth = 1, bool cow = false) {return v.read_lazy(in.data(), in.size(), depth, cow);}
+#if defined(__XPJSON_SUPPORT_MOVE__) && defined(__XPJSON_SUPPORT_DELETE__)
+		static size_t read_lazy(ValueT<char_t>& v, JSON_TSTRING(char_t)&& in, size_t depth = 1, bool cow = false) = delete;
+#endif
+		static inline size_t read_parallel(ValueT<char_t>& v, const char_t* in, size_t len, unsigned threads = 0, bool cow = false) {return v.read_parallel(in, len, threads, cow);}
+		static inline size_t read_parallel(ValueT<char_t>& v, const JSON_TSTRING(char_t)& in, unsigned threads = 0, bool cow = false) {return v.read_parallel(in.data(), in.size(), threads, cow);}
+		/**
+			Read from scattered segments(iov_len in bytes) without joining them, e.g. ring buffers.
+			With cow, strings inside one segment refer to it, others are copied.
+			Return char count consumed from the segments.
+		*/
+		static size_t readv(ValueT<char_t>& v, const struct iovec* iov, int iovcnt, bool cow = false);
+		/**
+			Read object/array from stream of unknown size, e.g. pipe, by blocks of block char_t without reading it all.
+			Peak memory is the value plus one block, and a string or number split by blocks.
+			in is std::basic_istream<char_t> or alike(read and gcount), or FILE*(opened in binary mode).
+			Chars after the document in its last block are read from in and dropped.
+			Return char_t count consumed from in.
+		*/
+		template<class istream_t>
+		static size_t read_stream(ValueT<char_t>& v, istream_t& in, size_t block = 0x10000);
+		static size_t read_stream(ValueT<char_t>& v, FILE* fp, size_t block = 0x10000);
+		/**
+			Read object/array from file by mmap without copying it, strings and keys refer to the mapping
+			owned by doc. Read into value, strings are copied and the mapping is released after read.
+			Return char_t count(offset) parsed.
+		*/
+		static inline size_t read_file(DocumentT<char_t>& doc, const char* path) {return doc.read_file(path);}
+		static size_t read_file(ValueT<char_t>& v, const char* path);
+
+		/**
+			SAX style parse, drive handler by events instead of building a value, no allocation for DOM.
+			Handler should provide following methods, return false to stop parsing:
+				bool on_null();
+				bool on_boolean(bool b);
+				bool on_int(int64_t i);
+				bool on_double(double f);
+				bool on_string(const char_t* s, size_t len); // points into in, or a scratch buffer if decoded
+				bool on_key(const char_t* s, size_t len);    // same as on_string
+				bool on_object_begin();
+				bool on_object_end();
+				bool on_array_begin();
+				bool on_array_end();
+			Return char count consumed, or the position after the value where handler stopped.
+		*/
+		template<class handler_t>
+		static inline size_t parse(handler_t& handler, const char_t* in, size_t len) {return parse(handler, in, len, NULL);}
+		template<class handler_t>
+		static inline size_t parse(handler_t& handler, const char_t* in) {return parse(handler, in, detail::tcslen(in));}
+		template<class handler_t>
+		static inline size_t parse(handler_t& handler, const JSON_TSTRING(char_t)& in) {return parse(handler, in.data(), in.size());}
+		/** Same as parse, but errors are returned instead of thrown, see ValueT::try_read. */
+		template<class handler_t>
+		static ReadResultT<char_t> try_parse(handler_t& handler, const char_t* in, size_t len);
+
+		/**
+			Check object/array by the same grammar as read without building it, nothing is allocated,
+			strings are not decoded and numbers are not converted. depth is set to its max nesting depth.
+			Return ok and char_t count(offset) checked, or error and where it's found like try_read.
+		*/
+		static ReadResultT<char_t> validate(const char_t* in, size_t len, size_t* depth = NULL);
+		static inline ReadResultT<char_t> validate(const JSON_TSTRING(char_t)& in, size_t* depth = NULL) {return validate(in.data(), in.size(), depth);}
+
+		/**
+			Read NDJSON(JSON Lines), an object/array per line, blank lines are skipped.
+			Input is split at newlines and read by threads(0 for hardware concurrency), out keeps input order.
+			A malformed line is left NIL in out and its index is appended to bad, following lines are still read.
+			Return count of values.
+		*/
+		static size_t read_lines(std::vector<ValueT<char_t> >& out, const char_t* in, size_t len, std::vector<size_t>* bad = NULL, unsigned threads = 0, bool cow = false);
+		static inline size_t read_lines(std::vector<ValueT<char_t> >& out, const JSON_TSTRING(char_t)& in, std::vector<size_t>* bad = NULL, unsigned threads = 0, bool cow = false) {return read_lines(out, in.data(), in.size(), bad, threads, cow);}
+		/**
+			SAX parse of NDJSON in calling thread, handler is the same as parse, a callback returning false skips rest of the line.
+			A malformed line may have sent some events before its index is appended to bad.
+			Return count of lines, blank ones are not counted.
+		*/
+		template<class handler_t>
+		static size_t parse_lines(handler_t& handler, const char_t* in, size_t len, std::vector<size_t>* bad = NULL);
+		template<class handler_t>
+		static inline size_t parse_lines(handler_t& handler, const JSON_TSTRING(char_t)& in, std::vector<size_t>* bad = NULL) {return parse_lines(handler, in.data(), in.size(), bad);}
+
+	private:
+		/* Errors are recorded into err instead of thrown if not NULL, see detail::read_fail. */
+		template<class handler_t>
+		static size_t parse(handler_t& handler, const char_t* in, size_t len, detail::read_error<char_t>* err);
+		static size_t validate(const char_t* in, size_t len, size_t& depth, detail::read_error<char_t>* err);
 	};
 
 	typedef ReaderT<char>    Reader;
 	typedef ReaderT<wchar_t> ReaderW;
 
+	/**
+		On-demand cursor over a raw buffer, for reading a few fields out of large documents.
+		Only visited values are parsed, others are skipped by bracket matching without validation.
+		Buffer must outlive the cursor. A cursor of missing field or array end is invalid, and
+		find_field of it is invalid too, so lookups can be chained, e.g. c["media"]["width"].
+	*/
+	template<class char_t>
+	class CursorT
+	{
+	public:
+		typedef JSON_TSTRING(char_t) tstring;
+
+		CursorT(const char_t* in, size_t len) : _in(in), _len(len), _pos(detail::skip_ws(in, 0, len)) {}
+		CursorT(const char_t* in) : _in(in), _len(detail::tcslen(in)), _pos(detail::skip_ws(in, 0, _len)) {}
+		CursorT(const tstring& in) : _in(in.data()), _len(in.size()), _pos(detail::skip_ws(_in, 0, _len)) {}
+
+		/** False if field is not found or array end is reached. */
+		inline bool valid() const {return _pos < _len;}
+		/** Type of the value, number is parsed to tell INTEGER from FLOAT. */
+		Type type() const;
+
+		/** Value of the field in object, invalid if not found. Duplicate keys, the first one wins. */
+		inline CursorT find_field(const char_t* key) const {return find_field(key, detail::tcslen(key));}
+		inline CursorT find_field(const tstring& key) const {return find_field(key.data(), key.size());}
+		CursorT find_field(const char_t* key, size_t len) const;
+		inline CursorT operator[](const char_t* key) const {return find_field(key, detail::tcslen(key));}
+		inline CursorT operator[](const tstring& key) const {return find_field(key.data(), key.size());}
+
+		/**
+			Value at JSON pointer(RFC 6901) relative to this value, e.g. "/media/persons/0", "" for itself.
+			Invalid if not found or a step meets a scalar, throws if pointer is malformed.
+		*/
+		CursorT at(const char_t* pointer, size_t len) const;
+		inline CursorT at(const char_t* pointer) const {return at(pointer, detail::tcslen(pointer));}
+		inline CursorT at(const tstring& pointer) const {return at(pointer.data(), pointer.size());}
+		/**
+			Value at simple path, keys separated by '.' and array indexes in brackets, e.g. "media.persons[0]", "[1].id".
+			No escape, use at for keys having '.' or '['.
+		*/
+		CursorT path(const char_t* expr, size_t len) const;
+		inline CursorT path(const char_t* expr) const {return path(expr, detail::tcslen(expr));}
+		inline CursorT path(const tstring& expr) const {return path(expr.data(), expr.size());}
+
+		/** First element of array, invalid if empty. */
+		CursorT begin() const;
+		/** Next element, for cursor of an array element only, invalid if array end is reached. */
+		CursorT next() const;
+
+		/** Fetch scalar values, throw if type mismatches like ValueT does. */
+		inline bool is_null() const {return type() == NIL;}
+		inline bool b() const {ValueT<char_t> v; read_scalar(v); return v.b();}
+		inline int64_t i() const {ValueT<char_t> v; read_scalar(v); return v.i();}
+		inline double f() const {ValueT<char_t> v; read_scalar(v); return v.f();}
+		/** Fetch decoded string. */
+		inline tstring s() const {ValueT<char_t> v; read_scalar(v); return v.s();}
+		/**
+			View of string in buffer without quotes.
+			Return false if it contains escapes, s and len are the raw chars then, use s() to decode.
+		*/
+		bool view(const char_t*& s, size_t& len) const;
+		/** Raw text of the value in buffer, e.g. to forward it as is. */
+		void raw(const char_t*& s, size_t& len) const;
+
+		/** Parse the value into v, return char count consumed. */
+		size_t read(ValueT<char_t>& v, bool cow = false) const;
+
+	private:
+		CursorT(const char_t* in, size_t len, size_t pos) : _in(in), _len(len), _pos(pos) {}
+		size_t read_scalar(ValueT<char_t>& v, bool cow = false) const;
+		// invalid if not an object/array, unlike find_field/begin which throw
+		CursorT field(const char_t* key, size_t len) const;
+		CursorT element(size_t index) const;
+
+		const char_t* _in;
+		size_t _len;
+		size_t _pos; // first char of the value, _len if invalid
+	};
+
+	typedef CursorT<char>    Cursor;
+	typedef CursorT<wchar_t> CursorW;
+
+	/**
+		Incremental(push) reader for documents arriving chunk by chunk, e.g. from non-blocking sockets.
+		Parse state is kept between chunks, so every char is scanned once,
+		only a string or scalar split by chunk boundaries is buffered.
+	*/
+	template<class char_t>
+	class IncrementalReaderT
+	{
+	public:
+		enum Status {NEED_MORE, DONE};
+
+		/**
+			Read into v, which is cleared when topmost object/array begins.
+			Pass true to cow only if all chunks outlive v, strings inside one chunk refer to it.
+		*/
+		IncrementalReaderT(ValueT<char_t>& v, bool cow = false) : _pv(&v), _state(TOPMOST), _e(false), _escaped(false), _cow(cow), _used(0) {}
+
+		/**
+			Feed next chunk.
+			Return DONE when topmost object/array is closed, chars after it are left, see consumed.
+			Return NEED_MORE when all chars are consumed and document is not finished.
+			If error occurred, throws an exception, reset before reuse.
+		*/
+		Status feed(const char_t* in, size_t len)
+		{
+			_used = parse(in, len);
+			return _pv.empty() ? DONE : NEED_MORE;
+		}
+		Status feed(const JSON_TSTRING(char_t)& in) {return feed(in.data(), in.size());}
+
+		/** Char count consumed from the last chunk. */
+		size_t consumed() const {return _used;}
+		bool done() const {return _pv.empty();}
+
+		/** Start over to read next document into v. */
+		void reset(ValueT<char_t>& v)
+		{
+			_pv.reset(&v);
+			_state = TOPMOST;
+			_e = _escaped = false;
+			_used = 0;
+			_tok.clear();
+		}
+
+	private:
+		IncrementalReaderT(const IncrementalReaderT&);
+		IncrementalReaderT& operator=(const IncrementalReaderT&);
+
+		size_t parse(const char_t* in, size_t len);
+		size_t scan_string(const char_t* in, size_t pos, size_t len);
+
+		// same as ValueT::read, plus the ones may be split by chunks
+		enum {OBJECT_LBRACE,          /* { */
+			  OBJECT_PAIR_KEY_QUOTE,  /* {"," */
+			  OBJECT_PAIR_KEY,        /* "..." */
+			  OBJECT_PAIR_COLON,      /* "...": */
+			  OBJECT_PAIR_VALUE,      /* "...":"..." */
+			  OBJECT_COMMA,           /* {..., */
+			  ARRAY_LBRACKET,         /* [ */
+			  ARRAY_ELEM,             /* [...[...,... */
+			  ARRAY_COMMA,            /* [..., */
+			  STRING_VALUE,           /* "... */
+			  SCALAR_VALUE,           /* number, true, false, null */
+			  TOPMOST                 /* before topmost object/array */
+		};
+		detail::parse_stack<ValueT<char_t>*> _pv;
+		unsigned char _state;
+		bool _e;                      // string scanned so far needs conversion
+		bool _escaped;                // last chunk ends with an unpaired backslash
+		bool _cow;
+		size_t _used;
+		JSON_TSTRING(char_t) _tok;    // string or scalar split by chunks
+	};
+
+	typedef IncrementalReaderT<char>    IncrementalReader;
+	typedef IncrementalReaderT<wchar_t> IncrementalReaderW;
+
 	/* Compare functions */
 	template<class char_t> bool operator==(const ObjectT<char_t>& lhs, const ObjectT<char_t>& rhs);
 	template<class char_t> bool operator==(const ArrayT<char_t>& lhs, const ArrayT<char_t>& rhs);
@@ -854,7 +3069,7 @@ template<> inline void to_string<type, char_t>(type v, JSON_TSTRING(char_t)& out
 	template<class char_t, class T> inline typename detail::json_enable_if<detail::json_is_integral<T>::value, bool>::type
 	operator==(const ValueT<char_t>& v, T i) {return v.type() == INTEGER && i == v.i();}
 	template<class char_t, class T> inline typename detail::json_enable_if<detail::json_is_floating_point<T>::value, bool>::type
-	operator==(const ValueT<char_t>& v, T f) {return v.type() == FLOAT && fabs(f - v.f()) < JSON_EPSILON;}
+	operator==(const ValueT<char_t>& v, T f) {return v.type() == FLOAT && (f == v.f() || fabs(f - v.f()) < JSON_EPSILON);}
 	template<class char_t> inline bool operator==(const ValueT<char_t>& v, const JSON_TSTRING(char_t)& s) {return v.type() == STRING && !s.compare(0, s.length(), v.c_str(), v.length());}
 	template<class char_t> inline bool operator==(const ValueT<char_t>& v, const ObjectT<char_t>& o) {return v.type() == OBJECT && o == v.o();}
 	template<class char_t> inline bool operator==(const ValueT<char_t>& v, const ArrayT<char_t>& a) {return v.type() == ARRAY && a == v.a();}
@@ -906,6 +3121,20 @@ namespace JSON
 		return "Unknown";
 	}
 
+	const char* get_error_name(int error)
+	{
+		switch(error) {
+			case ERROR_NONE:   return "None";
+			case ERROR_END:    return "Unexpected end";
+			case ERROR_SYNTAX: return "Unexpected character";
+			case ERROR_STRING: return "Invalid escape";
+			case ERROR_NUMBER: return "Invalid number";
+			case ERROR_DEPTH:  return "Too deep";
+			case ERROR_LIMIT:  return "Limit exceeded";
+		}
+		return "Unknown";
+	}
+
 	template<class char_t>
 	ValueT<char_t>::ValueT(Type type)
 		: _type(type)
@@ -918,8 +3147,8 @@ namespace JSON
 				_sso = true;
 				_sso_len = 0;
 				break;
-			case OBJECT:  _o = new ObjectT<char_t>;  break;
-			case ARRAY:   _a = new ArrayT<char_t>;  break;
+			case OBJECT:  _sso = false; _o = new ObjectT<char_t>; break;
+			case ARRAY:   _sso = false; _a = new ArrayT<char_t>;  break;
 			default:      break;
 		}
 	}
@@ -939,8 +3168,17 @@ namespace JSON
 					_sso_len = 0;
 					assign(v.c_str(), v.length(), v._e, !v._sso && v._cow);
 					break;
-				case OBJECT:  _o = new ObjectT<char_t>(*v._o); break;
-				case ARRAY:   _a = new ArrayT<char_t>(*v._a); break;
+				case OBJECT:
+				case ARRAY:
+					// raw span is shared like cow string
+					if((_sso = v._sso)) {
+						_e = v._e;
+						_d = v._d;
+						_cow_len = v._cow_len;
+					}
+					else if(_type == OBJECT) _o = new ObjectT<char_t>(*v._o);
+					else _a = new ArrayT<char_t>(*v._a);
+					break;
 			}
 		}
 	}
@@ -950,13 +3188,7 @@ namespace JSON
 	{
 		clear(STRING);
 		if(escape == AUTO_DETECT) {
-			escape = DONT_ESCAPE;
-			size_t pos = 0;
-			while(pos < l) {
-				if((escape = detail::check_need_conv<char_t>(s[pos])))
-					break;
-				++pos;
-			}
+			escape = (detail::skip_plain(s, 0, l) < l) ? NEED_ESCAPE : DONT_ESCAPE;
 		}
 		if((_e = escape)) {
 			if(_sso || _cow) {
@@ -996,13 +3228,7 @@ namespace JSON
 	void ValueT<char_t>::assign(tstring&& s, int escape)
 	{
 		if(escape == AUTO_DETECT) {
-			escape = DONT_ESCAPE;
-			size_t pos = 0;
-			while(pos < s.length()) {
-				if((escape = detail::check_need_conv<char_t>(s[pos])))
-					break;
-				++pos;
-			}
+			escape = (detail::skip_plain(s.data(), 0, s.length()) < s.length()) ? NEED_ESCAPE : DONT_ESCAPE;
 		}
 		clear(STRING);
 		if(_sso || _cow) {
@@ -1018,6 +3244,16 @@ namespace JSON
 	void ValueT<char_t>::assign(const ValueT<char_t>& v)
 	{
 		if(this != &v) {
+			if(v.lazy()) {
+				// raw span is shared like cow string
+				clear();
+				_type = v._type;
+				_sso = true;
+				_e = v._e;
+				_d = v._d;
+				_cow_len = v._cow_len;
+				return;
+			}
 			clear(v._type);
 			switch(_type) {
 				case NIL:     _type = NIL; break;
@@ -1038,6 +3274,11 @@ namespace JSON
 	void ValueT<char_t>::assign(ValueT<char_t>&& v)
 	{
 		if(this != &v) {
+			if(v.lazy()) {
+				assign(static_cast<const ValueT<char_t>&>(v));
+				v.clear();
+				return;
+			}
 			clear(v._type);
 			switch(_type) {
 				case NIL:     _type = NIL; break;
@@ -1067,8 +3308,8 @@ namespace JSON
 		if(_type != type) {
 			switch(_type) {
 				case STRING: if(!_sso && !_cow) delete _s; break;
-				case OBJECT: delete _o; break;
-				case ARRAY:  delete _a; break;
+				case OBJECT: if(!_sso) delete _o; break;
+				case ARRAY:  if(!_sso) delete _a; break;
 				default: break;
 			}
 			switch(type) {
@@ -1076,8 +3317,8 @@ namespace JSON
 					_sso = true;
 					_sso_len = 0;
 					break;
-				case OBJECT: _o = new ObjectT<char_t>; break;
-				case ARRAY:  _a = new ArrayT<char_t>;  break;
+				case OBJECT: _sso = false; _o = new ObjectT<char_t>; break;
+				case ARRAY:  _sso = false; _a = new ArrayT<char_t>;  break;
 				default: break;
 			}
 			_type = type;
@@ -1085,8 +3326,8 @@ namespace JSON
 		else {
 			switch(_type) {
 				case STRING: if(!_sso && !_cow) _s->clear(); break;
-				case OBJECT: _o->clear(); break;
-				case ARRAY:  _a->clear(); break;
+				case OBJECT: if(_sso) {_sso = false; _o = new ObjectT<char_t>;} else _o->clear(); break;
+				case ARRAY:  if(_sso) {_sso = false; _a = new ArrayT<char_t>;}  else _a->clear(); break;
 				default: break;
 			}
 		}
@@ -1094,6 +3335,18 @@ namespace JSON
 
 	namespace detail
 	{
+		template<class char_t>
+		struct string_number
+		{
+			/* Same as read_number, but false if invalid instead of throwing. */
+			static bool read(ValueT<char_t>& out, const char_t* in, size_t len)
+			{
+				read_error<char_t> err;
+				register const size_t pos = skip_ws(in, 0, len);
+				return out.parse_number(in + pos, len - pos, false, &err) != 0;
+			}
+		};
+
 		namespace
 		{
 			template<class char_t, class T>
@@ -1110,14 +3363,10 @@ namespace JSON
 								return T(1);
 							else if(v.length() == 5 && v.c_str()[0] == 'f' && v.c_str()[1] == 'a' && v.c_str()[2] == 'l' && v.c_str()[3] == 's' && v.c_str()[4] == 'e')
 								return T(0);
-							try {
-								JSON::ValueT<char_t> vd;
-								vd.read_number(v.c_str(), v.length(), false);
+							JSON::ValueT<char_t> vd;
+							if(string_number<char_t>::read(vd, v.c_str(), v.length()))
 								return vd.template get<T>(value);
-							}
-							catch(std::exception& e) {
-								return T(value);
-							}
+							return T(value);
 						}
 					default: JSON_ASSERT_CHECK1(false, "Type-casting error: from (%s) type to arithmetic.", get_type_name(v.type()));
 				}
@@ -1151,6 +3400,7 @@ namespace JSON
 	T JSON::ValueT<char_t>::get(const tstring& key, const T& default_value) const
 	{
 		if(_type != OBJECT) return T(default_value);
+		expand();
 		typename ObjectT<char_t>::const_iterator it = _o->find(key);
 		if(it != _o->end()) return JSON_MOVE((detail::internal_type_casting <char_t, T>(it->second, default_value)));
 		return T(default_value);
@@ -1163,14 +3413,20 @@ namespace JSON
 			case NIL:     detail::to_string("null", out);break;
 			case INTEGER: detail::to_string(_i, out);        break;
 			case FLOAT:   detail::to_string(_f, out);        break;
-			case OBJECT:  WriterT<char_t>::write(*_o, out);  break;
-			case ARRAY:   WriterT<char_t>::write(*_a, out);  break;
+			case OBJECT:
+				if(_sso) out.append(_d, _cow_len);
+				else WriterT<char_t>::write(*_o, out);
+				break;
+			case ARRAY:
+				if(_sso) out.append(_d, _cow_len);
+				else WriterT<char_t>::write(*_a, out);
+				break;
 			case BOOLEAN:
 				detail::to_string(_b ? "true" : "false", out);
 				break;
 			case STRING:
 				out += '\"';
-				if(!_sso && !_cow && _e) detail::encode(_s->c_str(), _s->length(), out);
+				if(!_sso && _e) detail::encode(c_str(), length(), out);
 				else out.append(c_str(), length());
 				out += '\"';
 				break;
@@ -1195,131 +3451,141 @@ namespace JSON
 	}
 
 	template<class char_t>
-	size_t ValueT<char_t>::read_string(const char_t* in, size_t len, bool cow)
+	size_t ValueT<char_t>::parse_string(const char_t* in, size_t len, int cow, detail::read_error<char_t>* err)
 	{
-		register bool e = false;
+		bool e = false;
 		register size_t pos = 0;
 
-		while(pos < len && is_ws(in[pos])) ++pos;
-		JSON_PARSE_CHECK(pos < len && in[pos] == '\"');
-		register size_t start = ++pos;
-		while(pos < len) {
-			if(XPJSON_UNLIKELY(in[pos] == '\"')) {
-				if(e) {
-					clear(STRING);
-					if(_sso || _cow) {
-						_sso = _cow = false;
-						_s = new tstring;
-					}
-					detail::decode(in + start, pos - start, *_s);
-					_e = e;
-				}
-				else {
-					assign(in + start, pos - start, e, cow);
-				}
-				return pos + 1;
+		JSON_READ_CHECK(pos < len && in[pos] == '\"', ERROR_SYNTAX);
+		pos = detail::scan_string(in, pos + 1, len, e);
+		JSON_READ_CHECK(pos < len, ERROR_END);
+		if(XPJSON_UNLIKELY(!assign_raw(in + 1, pos - 1, e, cow, err))) return 0;
+		return pos + 1;
+	}
+
+	template<class char_t>
+	bool ValueT<char_t>::assign_raw(const char_t* s, size_t len, bool e, int cow, detail::read_error<char_t>* err)
+	{
+		if(e && cow == INSITU && len <= (unsigned)-1) {
+			clear(STRING);
+			if(!_sso && !_cow) delete _s;
+			// in is writable in this mode
+			detail::insitu_buffer<char_t> out(const_cast<char_t*>(s));
+			_sso = false;
+			_cow = true;
+			_e = true;
+			_d = s;
+			_cow_len = 0;
+			// empty string if failed
+			if(XPJSON_UNLIKELY(!detail::decode(s, len, out, err))) return false;
+			_cow_len = (unsigned int)out.length();
+		}
+		else if(e) {
+			clear(STRING);
+			if(_sso || _cow) {
+				_sso = _cow = false;
+				_s = new tstring;
 			}
-			else {
-				if(!e) e = detail::check_need_conv<char_t>(in[pos]);
-				if(e && in[pos] == '\\') ++pos;
+			_e = e;
+			return detail::decode(s, len, *_s, err);
+		}
+		else {
+			assign(s, len, e, cow);
+		}
+		return true;
+	}
+
+	template<class char_t>
+	ValueT<char_t>* ValueT<char_t>::key_value(const char_t* s, size_t len, bool e, int cow, detail::read_error<char_t>* err, bool reuse)
+	{
+		tstring decoded;
+		if(e && cow == INSITU) {
+			// in is writable in this mode
+			detail::insitu_buffer<char_t> out(const_cast<char_t*>(s));
+			if(XPJSON_UNLIKELY(!detail::decode(s, len, out, err))) return NULL;
+			len = out.length();
+		}
+		else if(e) {
+			if(XPJSON_UNLIKELY(!detail::decode(s, len, decoded, err))) return NULL;
+			s = decoded.data();
+			len = decoded.size();
+			cow = false;
+		}
+		if(XPJSON_UNLIKELY(reuse)) {
+			typename ObjectT<char_t>::iterator it = _o->find(KeyT<char_t>::ref(s, len));
+			if(it != _o->end()) {
+				it->second._kept = true;
+				return &it->second;
 			}
-			++pos;
 		}
-		JSON_PARSE_CHECK(false);
+		ValueT<char_t>* v = cow ? &(*_o)[KeyT<char_t>::ref(s, len)] : &(*_o)[KeyT<char_t>(s, len)];
+		v->clear(); // duplicate key overrides
+		v->_kept = true;
+		return v;
 	}
 
 	template<class char_t>
-	size_t ValueT<char_t>::read_number(const char_t* in, size_t len, bool)
+	size_t ValueT<char_t>::parse_number(const char_t* in, size_t len, bool, detail::read_error<char_t>* err)
 	{
 		register size_t pos = 0;
 		register bool neg = false;
-		register int sigfand = 0;
-		register bool dec_overflow = false;
-		register int dec = -1;
-		register uint64_t i = 0;
-
-		while(pos < len && is_ws(in[pos])) ++pos;
+		register bool is_float = false;
+		uint64_t i = 0;                   // significant digits, 19 at most
+		register int sigfand = 0;         // count of significant digits
+		register bool truncated = false;  // nonzero digits dropped after 19 significant ones
+		register int64_t exp = 0;         // decimal exponent of i
 
+		JSON_READ_CHECK(pos < len, ERROR_NUMBER);
 		if(in[pos] == '-') {
 			neg = true;
 			++pos;
 		}
 
-		if(XPJSON_UNLIKELY(in[pos] == '0')) {
-			if(++pos >= len) {
-				clear(INTEGER);
-				_i = 0;
-				return pos;
-			}
+		const size_t start = pos;
+		if(pos < len && in[pos] == '0') {
+			++pos;
 		}
 		else {
-			while(unsigned(in[pos] - '0') < 10) {
-				if(XPJSON_LIKELY(!dec_overflow && i <= 922337203685477580ULL)) {
-					i = i * 10 + (in[pos] - '0');
-					if(XPJSON_UNLIKELY(sigfand == 18 && i > 9223372036854775807ULL + neg)) dec_overflow = true;
-				}
-				else {
-					dec_overflow = true;
-				}
-				++sigfand;
-				if(XPJSON_UNLIKELY(++pos >= len)) break;
+			// 19 digits never overflow uint64_t
+			pos = detail::parse_digits(in, pos, std::min(len, pos + 19), i);
+			sigfand = int(pos - start);
+			JSON_READ_CHECK(sigfand, ERROR_NUMBER);
+			// digits dropped only affect exponent
+			while(pos < len && unsigned(in[pos] - '0') < 10) {
+				truncated |= in[pos++] != '0';
+				++exp;
 			}
-			JSON_PARSE_CHECK(i);
 		}
 
-		if(XPJSON_UNLIKELY(dec_overflow)) {
-			sigfand -= 19 - (i < 1000000000000000000ULL);
-		}
-
-		if(XPJSON_UNLIKELY(in[pos] == '.')) {
-			JSON_PARSE_CHECK(dec++ == -1);
-			++pos;
-			if(XPJSON_LIKELY(i <= 922337203685477580ULL)) {
-				while(unsigned(in[pos] - '0') < 10) {
-					if(XPJSON_LIKELY(i <= 922337203685477580ULL)) {
-						i = i * 10 + (in[pos] - '0');
-						++dec;
-					}
-					else break;
-					if(XPJSON_UNLIKELY(++pos >= len)) break;
-				}
-				JSON_PARSE_CHECK(dec);
+		if(pos < len && in[pos] == '.') {
+			is_float = true;
+			const size_t frac = ++pos;
+			// leading zeros are not significant
+			if(!i) {
+				while(pos < len && in[pos] == '0') ++pos;
+				exp -= int64_t(pos - frac);
 			}
-			while(unsigned(in[pos] - '0') < 10 && ++pos < len);
+			const size_t first = pos;
+			pos = detail::parse_digits(in, pos, std::min(len, pos + (19 - sigfand)), i);
+			sigfand += int(pos - first);
+			exp -= int64_t(pos - first);
+			while(pos < len && unsigned(in[pos] - '0') < 10) truncated |= in[pos++] != '0';
+			JSON_READ_CHECK(pos != frac, ERROR_NUMBER);
 		}
 
-		register int exp = 0;
-		register bool exp_neg = false;
 		if(pos < len && (in[pos] | 0x20) == 'e') {
-			JSON_PARSE_CHECK(++pos < len);
-			if(in[pos] == '-') {
-				exp_neg = true;
-				++pos;
-			}
-			else if(in[pos] == '+') {
+			is_float = true;
+			JSON_READ_CHECK(++pos < len, ERROR_NUMBER);
+			register bool exp_neg = false;
+			if(in[pos] == '-' || in[pos] == '+') exp_neg = in[pos++] == '-';
+			JSON_READ_CHECK(pos < len && unsigned(in[pos] - '0') < 10, ERROR_NUMBER);
+			register int64_t e = 0;
+			while(pos < len && unsigned(in[pos] - '0') < 10) {
+				// far beyond the range of double, keep it from overflow
+				if(XPJSON_LIKELY(e < 0x10000000)) e = e * 10 + (in[pos] - '0');
 				++pos;
 			}
-			JSON_PARSE_CHECK(pos < len && unsigned(in[pos] - '0') < 10);
-			while(unsigned(in[pos] - '0') < 10) {
-				exp = exp * 10 + (in[pos++] - '0');
-			}
-			if(XPJSON_UNLIKELY(dec_overflow)) {
-				if(exp_neg) {
-					exp = sigfand - exp;
-					if(exp < 0)
-						exp = -exp;
-					else
-						exp_neg = false;
-				}
-				else
-					exp += sigfand;
-			}
-			else if(dec != -1)
-				exp -= (exp_neg ? -dec : dec);
-		}
-		else {
-			exp_neg = !dec_overflow;
-			exp = XPJSON_UNLIKELY(dec_overflow) ? sigfand : dec;
+			exp += exp_neg ? -e : e;
 		}
 
 		if(XPJSON_UNLIKELY(pos < len)) {
@@ -1327,50 +3593,38 @@ namespace JSON
 				case_number_ending:
 					break;
 				default:
-					JSON_PARSE_CHECK(false);
+					JSON_READ_CHECK(false, ERROR_NUMBER);
 			}
 		}
 
-		if(dec == -1 && exp == -1) {
+		if(!is_float && (sigfand < 19 || (sigfand == 19 && i <= 9223372036854775807ULL + neg))) {
 			clear(INTEGER);
 			_i = (neg ? -i : i);
 		}
 		else {
 			clear(FLOAT);
-			if (XPJSON_UNLIKELY(exp > 0x1FF)) {
-				// errno = ERANGE;
-				_f = 0;
-			}
-			else {
-				register double base = 1.0;
-				static const double pow10[] = {10., 100., 1.0e4, 1.0e8, 1.0e16, 1.0e32, 1.0e64, 1.0e128, 1.0e256};
-				for(int x = 0; exp && x < 9; exp >>= 1, ++x) {
-					if(exp & 1) base *= pow10[x];
-				}
-				_f = (exp_neg ? (double)i / base : (double)i * base);
-				if(neg) _f = -_f;
-			}
+			if(!i) _f = 0;
+			else if(XPJSON_UNLIKELY(!detail::to_double(i, exp, truncated, _f))) _f = detail::strtod_c(in + start, pos - start);
+			if(neg) _f = -_f;
 		}
 		return pos;
 	}
 
 	template<class char_t>
-	size_t ValueT<char_t>::read_nil(const char_t* in, size_t len, bool)
+	size_t ValueT<char_t>::parse_nil(const char_t* in, size_t len, bool, detail::read_error<char_t>* err)
 	{
 		register size_t pos = 0;
-		while(pos < len && is_ws(in[pos])) ++pos;
 		if(len - pos >= 4 && in[pos] == 'n' && in[pos + 1] == 'u' && in[pos + 2] == 'l' && in[pos + 3] == 'l') {
 			clear();
 			return pos + 4;
 		}
-		JSON_PARSE_CHECK(false);
+		JSON_READ_CHECK(false, ERROR_SYNTAX);
 	}
 
 	template<class char_t>
-	size_t ValueT<char_t>::read_boolean(const char_t* in, size_t len, bool)
+	size_t ValueT<char_t>::parse_boolean(const char_t* in, size_t len, bool, detail::read_error<char_t>* err)
 	{
 		register size_t pos = 0;
-		while(pos < len && is_ws(in[pos])) ++pos;
 		if(len - pos >= 4 && in[pos] == 't' && in[pos + 1] == 'r' && in[pos + 2] == 'u' && in[pos + 3] == 'e') {
 			clear(BOOLEAN);
 			_b = true;
@@ -1381,26 +3635,104 @@ namespace JSON
 			_b = false;
 			return pos + 5;
 		}
-		JSON_PARSE_CHECK(false);
+		JSON_READ_CHECK(false, ERROR_SYNTAX);
 	}
 
 #define OBJECT_ARRAY_PARSE_END(type) {									\
-		JSON_PARSE_CHECK(pv.back()->_type == type);						\
+		JSON_READ_CHECK(pv.back()->_type == type, ERROR_SYNTAX);		\
+		if(XPJSON_UNLIKELY(reuse)) pv.back()->reuse_end();				\
 		pv.pop_back();													\
 		if(pv.empty()) return pos + 1;/* Object/Array parse finished. */\
 		if(pv.back()->_type == OBJECT) state = OBJECT_PAIR_VALUE;		\
 		else if(pv.back()->_type == ARRAY) state = ARRAY_ELEM;			\
 	}
 
+#define CHARGE_LIMITS(charge)											\
+	if(XPJSON_UNLIKELY(limits != NULL)) {JSON_READ_CHECK(charge, ERROR_LIMIT);}
+
 #define PUSH_VALUE_TO_STACK(type)										\
-	if(pv.back()->_type == NIL) pv.back()->clear(type);					\
+	if(pv.back()->_type == NIL) {										\
+		pv.back()->clear(type);											\
+		CHARGE_LIMITS(pv.back()->charge_limits(*limits, 0, 0))			\
+	}																	\
 	else {																\
 		pv.back()->_a->push_back(JSON_MOVE(ValueT<char_t>(type)));		\
 		pv.push_back(&pv.back()->_a->back());							\
+		CHARGE_LIMITS(pv.back()->charge_limits(*limits, 1, sizeof(ValueT<char_t>)))\
+	}																	\
+	JSON_READ_CHECK(pv.size() <= max_depth, detail::depth_error(limits));
+
+/* value of pair is on the top already, and kept as is */
+#define REUSE_VALUE_ON_STACK(type)										\
+	if(state != OBJECT_PAIR_COLON) pv.push_back(&pv.back()->reuse_element());\
+	pv.back()->reuse_begin(type);										\
+	JSON_READ_CHECK(pv.size() <= max_depth, detail::depth_error(limits));
+
+#define READ_SCALAR_VALUE(parse)										\
+	if(state != OBJECT_PAIR_COLON) {									\
+		ValueT<char_t>* v;												\
+		if(XPJSON_UNLIKELY(reuse)) v = &pv.back()->reuse_element();		\
+		else {															\
+			pv.back()->_a->push_back(JSON_MOVE(ValueT<char_t>()));		\
+			v = &pv.back()->_a->back();									\
+		}																\
+		register const size_t n = v->parse(in + pos, len - pos, cow, err);\
+		if(XPJSON_UNLIKELY(!n)) return 0;								\
+		CHARGE_LIMITS(v->charge_limits(*limits, 1, sizeof(ValueT<char_t>), n))\
+		pos += n - 1;													\
+		state = ARRAY_ELEM;												\
+	}																	\
+	else {																\
+		/* value of pair is on the top, pop it after read */			\
+		register const size_t n = pv.back()->parse(in + pos, len - pos, cow, err);\
+		if(XPJSON_UNLIKELY(!n)) return 0;								\
+		CHARGE_LIMITS(pv.back()->charge_limits(*limits, 0, 0, n))		\
+		pos += n - 1;													\
+		pv.pop_back();													\
+		state = OBJECT_PAIR_VALUE;										\
+	}
+
+	template<class char_t>
+	size_t ValueT<char_t>::parse_lazy(const char_t* in, size_t len, bool cow, detail::read_error<char_t>* err)
+	{
+		register size_t pos = detail::skip_container(in, 0, len);
+		// not closed or mismatched
+		JSON_READ_CHECK(pos > 1 && in[pos - 1] == in[0] + 2, pos > len - 1 ? ERROR_END : ERROR_SYNTAX);
+		// span length is limited by _cow_len
+		if(XPJSON_UNLIKELY(pos > (unsigned)-1)) return read(in, len, cow, 0, 1, err);
+		clear();
+		_type = (in[0] == '{') ? OBJECT : ARRAY;
+		_sso = true;
+		_e = cow;
+		_d = in;
+		_cow_len = pos;
+		return pos;
+	}
+
+	template<class char_t>
+	void ValueT<char_t>::expand_raw()
+	{
+		const char_t* in = _d;
+		const size_t len = _cow_len;
+		const bool cow = _e;
+		const unsigned char type = _type;
+		_type = NIL;
+		_sso = false;
+		detail::read_error<char_t> err = {ERROR_NONE, NULL, 0};
+		if(XPJSON_UNLIKELY(!read(in, len, cow, 1, 1, &err))) {
+			// back to the raw span instead of half-built, then throw
+			clear();
+			_type = type;
+			_sso = true;
+			_e = cow;
+			_d = in;
+			_cow_len = (unsigned int)len;
+			detail::read_fail<char_t>(NULL, err.code, in, len, err.at - in, err.line);
+		}
 	}
 
 	template<class char_t>
-	size_t ValueT<char_t>::read(const char_t* in, size_t len, bool cow/* = false*/)
+	size_t ValueT<char_t>::read(const char_t* in, size_t len, int cow, size_t lazy_depth, size_t depth, detail::read_error<char_t>* err, ReadLimits* limits, bool reuse)
 	{
 		// Indicate current parse state
 		enum {OBJECT_LBRACE,          /* { */
@@ -1415,35 +3747,39 @@ namespace JSON
 		};
 		register unsigned char state = 0;
 		register size_t pos = 0;
-		union {
-			size_t start;
-			size_t(ValueT<char_t>::*fp)(const char_t*, size_t, bool);
-		} u;
-		memset(&u, 0, sizeof(u));
-		std::deque<ValueT<char_t>*> pv(1, this);
-		while(pos < len && is_ws(in[pos])) ++pos;
+		register size_t start = 0; // of key
+		detail::parse_stack<ValueT<char_t>*> pv(this);
+		// value to push is at depth pv.size() in array, pv.size() - 1 in object(pair value on top)
+		if(!lazy_depth) lazy_depth = (size_t)-1;
+		size_t limit_depth = __XPJSON_MAX_DEPTH__;
+		if(limits && limits->max_depth && limits->max_depth < limit_depth) limit_depth = limits->max_depth;
+		const size_t max_depth = limit_depth + 1 - std::min(depth, limit_depth);
+		pos = detail::skip_ws(in, pos, len);
+		JSON_READ_CHECK(pos < len, ERROR_END);
 		// Topmost value parse.
-		switch(in[pos++]) {
-			case '{': state = OBJECT_LBRACE;  clear(OBJECT); break;
-			case '[': state = ARRAY_LBRACKET; clear(ARRAY);  break;
-			default: JSON_PARSE_CHECK(false);
+		switch(in[pos]) {
+			case '{': state = OBJECT_LBRACE;  if(XPJSON_UNLIKELY(reuse)) reuse_begin(OBJECT); else clear(OBJECT); break;
+			case '[': state = ARRAY_LBRACKET; if(XPJSON_UNLIKELY(reuse)) reuse_begin(ARRAY);  else clear(ARRAY);  break;
+			default: JSON_READ_CHECK(false, ERROR_SYNTAX);
 		}
+		CHARGE_LIMITS(charge_limits(*limits, 1, 0))
+		++pos;
 		while(pos < len) {
 			switch(state) {
 				case OBJECT_LBRACE:
 				case OBJECT_COMMA:
 					switch(in[pos]) {
-						case '\"': state = OBJECT_PAIR_KEY_QUOTE; u.start = pos + 1; break;
+						case '\"': state = OBJECT_PAIR_KEY_QUOTE; start = pos + 1; break;
 #if __XPJSON_SUPPORT_DANGLING_COMMA__
 						case '}': OBJECT_ARRAY_PARSE_END(OBJECT) break;
 #else
 						case '}':
 							if(state == OBJECT_LBRACE) OBJECT_ARRAY_PARSE_END(OBJECT)
-							else JSON_PARSE_CHECK(false);
+							else JSON_READ_CHECK(false, ERROR_SYNTAX);
 							break;
 #endif
-						case_white_space: break;
-						default: JSON_PARSE_CHECK(false);
+						case_white_space: pos = detail::skip_ws(in, pos + 1, len) - 1; break;
+						default: JSON_READ_CHECK(false, ERROR_SYNTAX);
 					}
 					break;
 				case OBJECT_PAIR_KEY_QUOTE:
@@ -1452,10 +3788,10 @@ namespace JSON
 							while(pos < len) {
 								if(in[pos] == '\"') {
 									state = OBJECT_PAIR_KEY;
-									JSON_TSTRING(char_t) key;
-									detail::decode(in + u.start, pos - u.start, key);
-									pv.push_back(&(*pv.back()->_o)[JSON_MOVE(key)]);
-									u.start = 0;
+									ValueT<char_t>* const v = pv.back()->key_value(in + start, pos - start, true, cow, err, reuse);
+									if(XPJSON_UNLIKELY(!v)) return 0;
+									CHARGE_LIMITS(detail::charge(*limits, 1, (pos - start) * sizeof(char_t), member_bytes(pos - start, cow == INSITU)))
+									pv.push_back(v);
 									break;
 								}
 								else if(in[pos] == '\\') {
@@ -1465,13 +3801,13 @@ namespace JSON
 								}
 								++pos;
 							}
-							JSON_PARSE_CHECK(state == OBJECT_PAIR_KEY);
+							JSON_READ_CHECK(state == OBJECT_PAIR_KEY, ERROR_END);
 							break;
 						case '\"':
 							state = OBJECT_PAIR_KEY;
 							// Insert a value
-							pv.push_back(&(*pv.back()->_o)[JSON_MOVE(JSON_TSTRING(char_t)(in + u.start, pos - u.start))]);
-							u.start = 0;
+							pv.push_back(pv.back()->key_value(in + start, pos - start, false, cow, NULL, reuse));
+							CHARGE_LIMITS(detail::charge(*limits, 1, (pos - start) * sizeof(char_t), member_bytes(pos - start, cow != 0)))
 							break;
 						default: break;
 					}
@@ -1479,20 +3815,29 @@ namespace JSON
 				case OBJECT_PAIR_KEY:
 					switch(in[pos]) {
 						case ':': state = OBJECT_PAIR_COLON; break;
-						case_white_space:                    break;
-						default: JSON_PARSE_CHECK(false);
+						case_white_space: pos = detail::skip_ws(in, pos + 1, len) - 1; break;
+						default: JSON_READ_CHECK(false, ERROR_SYNTAX);
 					}
 					break;
 				case OBJECT_PAIR_COLON:
 				case ARRAY_LBRACKET:
 				case ARRAY_COMMA:
 					switch(in[pos]) {
-						case '\"':                 u.fp = &ValueT::read_string;       break;
-						case '-': case_number_0_9: u.fp = &ValueT::read_number;       break;
-						case 't': case 'f':        u.fp = &ValueT::read_boolean;      break;
-						case 'n':                  u.fp = &ValueT::read_nil;          break;
-						case '{': state = OBJECT_LBRACE;  PUSH_VALUE_TO_STACK(OBJECT) break;
-						case '[': state = ARRAY_LBRACKET; PUSH_VALUE_TO_STACK(ARRAY)  break;
+						// ++pos at last, so minus 1 in READ_SCALAR_VALUE.
+						case '\"':                 READ_SCALAR_VALUE(parse_string)  break;
+						case '-': case_number_0_9: READ_SCALAR_VALUE(parse_number)  break;
+						case 't': case 'f':        READ_SCALAR_VALUE(parse_boolean) break;
+						case 'n':                  READ_SCALAR_VALUE(parse_nil)     break;
+						case '{':
+							if(XPJSON_UNLIKELY(pv.size() - (pv.back()->_type == NIL) >= lazy_depth)) {READ_SCALAR_VALUE(parse_lazy)}
+							else if(XPJSON_UNLIKELY(reuse)) {REUSE_VALUE_ON_STACK(OBJECT) state = OBJECT_LBRACE;}
+							else {state = OBJECT_LBRACE;  PUSH_VALUE_TO_STACK(OBJECT)}
+							break;
+						case '[':
+							if(XPJSON_UNLIKELY(pv.size() - (pv.back()->_type == NIL) >= lazy_depth)) {READ_SCALAR_VALUE(parse_lazy)}
+							else if(XPJSON_UNLIKELY(reuse)) {REUSE_VALUE_ON_STACK(ARRAY) state = ARRAY_LBRACKET;}
+							else {state = ARRAY_LBRACKET; PUSH_VALUE_TO_STACK(ARRAY)}
+							break;
 						case ']':
 #if __XPJSON_SUPPORT_DANGLING_COMMA__
 							if(state != OBJECT_PAIR_COLON)
@@ -1500,57 +3845,1475 @@ namespace JSON
 							if(state == ARRAY_LBRACKET)
 #endif
 							  OBJECT_ARRAY_PARSE_END(ARRAY)
-							else JSON_PARSE_CHECK(false);
+							else JSON_READ_CHECK(false, ERROR_SYNTAX);
 							break;
-						case_white_space: break;
-						default: JSON_PARSE_CHECK(false);
-					}
-					if(u.fp) {
-						// If top elem is array, push a elem.
-						if(pv.back()->_type == ARRAY) {
-							pv.back()->_a->push_back(JSON_MOVE(ValueT<char_t>()));
-							pv.push_back(&pv.back()->_a->back());
-						}
-						// ++pos at last, so minus 1 here.
-						pos += (pv.back()->*u.fp)(in + pos, len - pos, cow) - 1;
-						u.fp = 0;
-						// pop nil/number/boolean/string Value
-						pv.pop_back();
-						JSON_PARSE_CHECK(!pv.empty());
-						switch(pv.back()->_type) {
-							case OBJECT: state = OBJECT_PAIR_VALUE; break;
-							case ARRAY:  state = ARRAY_ELEM;        break;
-							default: JSON_PARSE_CHECK(false);
-						}
+						case_white_space: pos = detail::skip_ws(in, pos + 1, len) - 1; break;
+						default: JSON_READ_CHECK(false, ERROR_SYNTAX);
 					}
 					break;
 				case OBJECT_PAIR_VALUE:
 					switch(in[pos]) {
 						case '}': OBJECT_ARRAY_PARSE_END(OBJECT)  break;
 						case ',': state = OBJECT_COMMA;           break;
-						case_white_space:                         break;
-						default: JSON_PARSE_CHECK(false);
+						case_white_space: pos = detail::skip_ws(in, pos + 1, len) - 1; break;
+						default: JSON_READ_CHECK(false, ERROR_SYNTAX);
 					}
 					break;
 				case ARRAY_ELEM:
 					switch(in[pos]) {
 						case ']': OBJECT_ARRAY_PARSE_END(ARRAY)  break;
 						case ',': state = ARRAY_COMMA;           break;
-						case_white_space:                        break;
-						default: JSON_PARSE_CHECK(false);
+						case_white_space: pos = detail::skip_ws(in, pos + 1, len) - 1; break;
+						default: JSON_READ_CHECK(false, ERROR_SYNTAX);
 					}
 					break;
 			}
 			++pos;
 		}
-		JSON_PARSE_CHECK(false);
+		return detail::read_fail(err, ERROR_END, in, len, pos, __LINE__);
+	}
+
+	template<class char_t>
+	ReadResultT<char_t> ValueT<char_t>::try_read(const char_t* in, size_t len, bool cow)
+	{
+		detail::read_error<char_t> err = {ERROR_NONE, NULL, 0};
+		const size_t ret = read(in, len, cow, 0, 1, &err);
+		return ReadResultT<char_t>(ret, in, len, err);
+	}
+
+	template<class char_t>
+	size_t ValueT<char_t>::read(const char_t* in, size_t len, ReadLimits& limits, bool cow)
+	{
+		limits.nodes = limits.string_bytes = limits.alloc_bytes = 0;
+		limits.exceeded = LIMIT_NONE;
+		return read(in, len, cow, 0, 1, NULL, &limits);
+	}
+
+	template<class char_t>
+	ReadResultT<char_t> ValueT<char_t>::try_read(const char_t* in, size_t len, ReadLimits& limits, bool cow)
+	{
+		limits.nodes = limits.string_bytes = limits.alloc_bytes = 0;
+		limits.exceeded = LIMIT_NONE;
+		detail::read_error<char_t> err = {ERROR_NONE, NULL, 0};
+		const size_t ret = read(in, len, cow, 0, 1, &err, &limits);
+		return ReadResultT<char_t>(ret, in, len, err);
+	}
+
+	template<class char_t>
+	ReadResultT<char_t> ValueT<char_t>::try_read_reuse(const char_t* in, size_t len)
+	{
+		detail::read_error<char_t> err = {ERROR_NONE, NULL, 0};
+		const size_t ret = read(in, len, false, 0, 1, &err, NULL, true);
+		return ReadResultT<char_t>(ret, in, len, err);
+	}
+
+	template<class char_t>
+	void ValueT<char_t>::reuse_begin(unsigned char type)
+	{
+		if(_type != type || _sso) clear(type);
+		else if(type == OBJECT) {
+			for(typename ObjectT<char_t>::iterator it = _o->begin(); it != _o->end(); ++it) it->second._kept = false;
+		}
+		_cow_len = 0;
+	}
+
+	template<class char_t>
+	void ValueT<char_t>::reuse_end()
+	{
+		if(_type == ARRAY) {
+			if(_cow_len < _a->size()) _a->erase(_a->begin() + _cow_len, _a->end());
+		}
+		else {
+			for(typename ObjectT<char_t>::iterator it = _o->begin(); it != _o->end();) {
+				if(it->second._kept) ++it;
+				else _o->erase(it++);
+			}
+		}
+	}
+
+	template<class char_t>
+	bool ValueT<char_t>::charge_limits(ReadLimits& limits, size_t nodes, size_t alloc, size_t n) const
+	{
+		size_t bytes = 0;
+		switch(_type) {
+			case STRING:
+				// without quotes
+				bytes = (n - 2) * sizeof(char_t);
+				if(!_sso && !_cow) alloc += sizeof(tstring) + (_s->capacity() + 1) * sizeof(char_t);
+				break;
+			case OBJECT: if(!_sso) alloc += sizeof(ObjectT<char_t>); break;
+			case ARRAY:  if(!_sso) alloc += sizeof(ArrayT<char_t>);  break;
+			default: break;
+		}
+		return detail::charge(limits, nodes, bytes, alloc);
+	}
+
+	template<class char_t>
+	size_t ValueT<char_t>::read_parallel(const char_t* in, size_t len, unsigned threads, bool cow)
+	{
+#if __XPJSON_SUPPORT_THREAD__
+		// small ranges are not worth a thread
+		static const size_t min_range = 64 * 1024;
+		if(!threads) threads = std::thread::hardware_concurrency();
+		if(threads > len / min_range) threads = (unsigned)(len / min_range);
+		register size_t pos = detail::skip_ws(in, 0, len);
+		if(threads < 2 || pos >= len || in[pos] != '[') return read(in, len, cow, 0);
+		clear(ARRAY);
+		// locate elements, a range starts at first element after each even split
+		std::vector<detail::elements_task<char_t> > tasks;
+		detail::elements_task<char_t> t;
+		t.in = in;
+		t.len = len;
+		t.cow = cow;
+		t.count = 0;
+		size_t total = 0, split = len / threads;
+		JSON_PARSE_CHECK((pos = detail::skip_ws(in, pos + 1, len)) < len);
+		t.begin = pos;
+		if(in[pos] != ']') {
+			while(true) {
+				if(pos >= split && t.count) {
+					tasks.push_back(t);
+					t.begin = pos;
+					t.count = 0;
+					split += len / threads;
+				}
+				++t.count;
+				++total;
+				JSON_PARSE_CHECK((pos = detail::skip_ws(in, detail::skip_value(in, pos, len), len)) < len);
+				if(in[pos] == ']') break;
+				JSON_PARSE_CHECK(in[pos] == ',');
+				JSON_PARSE_CHECK((pos = detail::skip_ws(in, pos + 1, len)) < len);
+#if __XPJSON_SUPPORT_DANGLING_COMMA__
+				if(in[pos] == ']') break;
+#endif
+			}
+		}
+		tasks.push_back(t);
+		_a->resize(total);
+		typename ArrayT<char_t>::iterator it = _a->begin();
+		for(size_t i = 0; i < tasks.size(); it += tasks[i++].count) tasks[i].out = it;
+		std::vector<std::thread> workers;
+		for(size_t i = 1; i < tasks.size(); ++i) workers.push_back(std::thread(read_elements, &tasks[i]));
+		read_elements(&tasks[0]);
+		for(size_t i = 0; i < workers.size(); ++i) workers[i].join();
+#if __XPJSON_SUPPORT_EXCEPTIONS__
+		// the first error in document order
+		for(size_t i = 0; i < tasks.size(); ++i) {
+			if(tasks[i].error) std::rethrow_exception(tasks[i].error);
+		}
+#endif
+		return pos + 1;
+#else
+		(void)threads;
+		return read(in, len, cow, 0);
+#endif
+	}
+
+	template<class char_t>
+	void ValueT<char_t>::read_elements(detail::elements_task<char_t>* t)
+	{
+#if __XPJSON_SUPPORT_THREAD__ && __XPJSON_SUPPORT_EXCEPTIONS__
+		try {
+#endif
+			const char_t* in = t->in;
+			const size_t len = t->len;
+			register size_t pos = t->begin;
+			typename ArrayT<char_t>::iterator v = t->out;
+			for(size_t i = 0; i < t->count; ++i, ++v) {
+				// same as elements read by read, at depth 2
+				switch(in[pos]) {
+					case '\"':                 pos += v->parse_string(in + pos, len - pos, t->cow);  break;
+					case '-': case_number_0_9: pos += v->parse_number(in + pos, len - pos, t->cow);  break;
+					case 't': case 'f':        pos += v->parse_boolean(in + pos, len - pos, t->cow); break;
+					case 'n':                  pos += v->parse_nil(in + pos, len - pos, t->cow);     break;
+					case '{': case '[':        pos += v->read(in + pos, len - pos, t->cow, 0, 2);    break;
+					default: JSON_PARSE_CHECK(false);
+				}
+				JSON_PARSE_CHECK((pos = detail::skip_ws(in, pos, len)) < len && (in[pos] == ',' || in[pos] == ']'));
+				pos = detail::skip_ws(in, pos + 1, len);
+			}
+#if __XPJSON_SUPPORT_THREAD__ && __XPJSON_SUPPORT_EXCEPTIONS__
+		}
+		catch(...) {
+			t->error = std::current_exception();
+		}
+#endif
+	}
+
+	template<class char_t>
+	FieldMaskT<char_t>& FieldMaskT<char_t>::add(const char_t* path, size_t len)
+	{
+		JSON_ASSERT_CHECK1(!len || path[0] == '/', "Path error: %s.", detail::get_cstr(path, len).c_str());
+		bool wildcard = false;
+		std::vector<tstring> tokens;
+		for(size_t pos = 0, end; pos < len; pos = end) {
+			for(end = pos + 1; end < len && path[end] != '/'; ++end);
+			tokens.push_back(tstring());
+			JSON_ASSERT_CHECK1(detail::unescape_pointer(path + pos + 1, end - pos - 1, tokens.back()), "Path error: %s.", detail::get_cstr(path, len).c_str());
+			wildcard = wildcard || (end - pos == 2 && path[pos + 1] == '*');
+		}
+		insert(0, tokens, 0, wildcard);
+		_wildcard = _wildcard || wildcard;
+		return *this;
+	}
+
+	template<class char_t>
+	void FieldMaskT<char_t>::insert(size_t n, const std::vector<tstring>& tokens, size_t i, bool wildcard)
+	{
+		if(i == tokens.size()) {
+			if(!_nodes[n].leaf) {
+				_nodes[n].leaf = true;
+				if(!wildcard) _nodes[n].id = _exact++;
+			}
+			return;
+		}
+		const tstring& token = tokens[i];
+		if(token.length() == 1 && token[0] == '*') {
+			if(!_nodes[n].any) {
+				_nodes[n].any = _nodes.size();
+				_nodes.push_back(detail::mask_node<char_t>());
+			}
+			insert(_nodes[n].any, tokens, i + 1, wildcard);
+			// nodes may be reallocated by insert
+			std::vector<size_t> children;
+			for(typename detail::mask_node<char_t>::key_map::const_iterator it = _nodes[n].keys.begin(); it != _nodes[n].keys.end(); ++it) children.push_back(it->second);
+			for(size_t c = 0; c < children.size(); ++c) insert(children[c], tokens, i + 1, wildcard);
+			return;
+		}
+		size_t child;
+		typename detail::mask_node<char_t>::key_map::iterator it = _nodes[n].keys.find(KeyT<char_t>::ref(token.data(), token.size()));
+		if(it == _nodes[n].keys.end()) {
+			// matches what "*" matches too
+			if(_nodes[n].any) child = copy(_nodes[n].any);
+			else {
+				child = _nodes.size();
+				_nodes.push_back(detail::mask_node<char_t>());
+			}
+			_nodes[n].keys[KeyT<char_t>(token)] = child;
+		}
+		else child = it->second;
+		// also matches array element
+		size_t index;
+		if(detail::pointer_index(token.data(), token.length(), index)) _nodes[n].indexes[index] = child;
+		insert(child, tokens, i + 1, wildcard);
+	}
+
+	template<class char_t>
+	size_t FieldMaskT<char_t>::copy(size_t n)
+	{
+		typedef detail::mask_node<char_t> node_t;
+		const size_t c = _nodes.size();
+		const node_t src(_nodes[n]);
+		_nodes.push_back(node_t());
+		_nodes[c].leaf = src.leaf;
+		if(src.any) {
+			const size_t any = copy(src.any);
+			_nodes[c].any = any;
+		}
+		std::map<size_t, size_t> copied;
+		for(typename node_t::key_map::const_iterator it = src.keys.begin(); it != src.keys.end(); ++it) {
+			const size_t child = copy(it->second);
+			_nodes[c].keys[it->first] = copied[it->second] = child;
+		}
+		for(typename node_t::index_map::const_iterator it = src.indexes.begin(); it != src.indexes.end(); ++it) {
+			_nodes[c].indexes[it->first] = copied[it->second];
+		}
+		return c;
+	}
+
+#define MASK_VALUE_END													\
+	if(f.v->_type == ARRAY) {++f.index; state = ARRAY_ELEM;}			\
+	else state = OBJECT_PAIR_VALUE;
+
+#define MASK_PARSE_END(type) {											\
+		JSON_PARSE_CHECK(pf.back().v->_type == type);					\
+		pf.pop_back();													\
+		if(pf.empty()) return pos + 1;/* Object/Array parse finished. */\
+		state = (pf.back().v->_type == OBJECT) ? OBJECT_PAIR_VALUE : ARRAY_ELEM;\
 	}
 
+	template<class char_t>
+	size_t ValueT<char_t>::read(const char_t* in, size_t len, const FieldMaskT<char_t>& mask, bool cow/* = false*/)
+	{
+		// Indicate current parse state, same as read
+		enum {OBJECT_LBRACE,          /* { */
+			  OBJECT_PAIR_KEY,        /* "..." */
+			  OBJECT_PAIR_COLON,      /* "...": */
+			  OBJECT_PAIR_VALUE,      /* "...":"..." */
+			  OBJECT_COMMA,           /* {..., */
+			  ARRAY_LBRACKET,         /* [ */
+			  ARRAY_ELEM,             /* [...[...,... */
+			  ARRAY_COMMA             /* [..., */
+		};
+		typedef detail::mask_node<char_t> node_t;
+		const std::vector<node_t>& nodes = mask._nodes;
+		if(nodes[0].leaf) return read(in, len, cow, 0);
+		register unsigned char state = 0;
+		register size_t pos = detail::skip_ws(in, 0, len);
+		const detail::mask_frame<char_t> top = {this, 0, 0};
+		detail::parse_stack<detail::mask_frame<char_t> > pf(top);
+		// paths not found yet, only counted if stop early
+		std::vector<bool> found(mask._stop_early && !mask._wildcard ? mask._exact : 0);
+		size_t remaining = found.size();
+		size_t child = 0; // node of current key
+		const char_t* key = NULL; // in or decoded
+		size_t key_len = 0;
+		bool key_cow = false;
+		tstring decoded;
+		JSON_PARSE_CHECK(pos < len);
+		// Topmost value parse.
+		switch(in[pos]) {
+			case '{': state = OBJECT_LBRACE;  clear(OBJECT); break;
+			case '[': state = ARRAY_LBRACKET; clear(ARRAY);  break;
+			default: JSON_PARSE_CHECK(false);
+		}
+		++pos;
+		while(pos < len) {
+			detail::mask_frame<char_t>& f = pf.back();
+			switch(state) {
+				case OBJECT_LBRACE:
+				case OBJECT_COMMA:
+					switch(in[pos]) {
+						case '\"': {
+							bool e = false;
+							const size_t start = pos + 1;
+							JSON_PARSE_CHECK((pos = detail::scan_string(in, start, len, e)) < len);
+							// only escaped keys are decoded, others are looked up in place
+							if(e) {
+								decoded.clear();
+								detail::decode(in + start, pos - start, decoded);
+								key = decoded.data();
+								key_len = decoded.size();
+							}
+							else {
+								key = in + start;
+								key_len = pos - start;
+							}
+							key_cow = cow && !e;
+							typename node_t::key_map::const_iterator it = nodes[f.node].keys.find(KeyT<char_t>::ref(key, key_len));
+							child = (it != nodes[f.node].keys.end()) ? it->second : nodes[f.node].any;
+							state = OBJECT_PAIR_KEY;
+							break;
+						}
+#if __XPJSON_SUPPORT_DANGLING_COMMA__
+						case '}': MASK_PARSE_END(OBJECT) break;
+#else
+						case '}':
+							if(state == OBJECT_LBRACE) MASK_PARSE_END(OBJECT)
+							else JSON_PARSE_CHECK(false);
+							break;
+#endif
+						case_white_space: pos = detail::skip_ws(in, pos + 1, len) - 1; break;
+						default: JSON_PARSE_CHECK(false);
+					}
+					break;
+				case OBJECT_PAIR_KEY:
+					switch(in[pos]) {
+						case ':': state = OBJECT_PAIR_COLON; break;
+						case_white_space: pos = detail::skip_ws(in, pos + 1, len) - 1; break;
+						default: JSON_PARSE_CHECK(false);
+					}
+					break;
+				case OBJECT_PAIR_COLON:
+				case ARRAY_LBRACKET:
+				case ARRAY_COMMA:
+					switch(in[pos]) {
+						case ']':
+#if __XPJSON_SUPPORT_DANGLING_COMMA__
+							if(state != OBJECT_PAIR_COLON)
+#else
+							if(state == ARRAY_LBRACKET)
+#endif
+							  MASK_PARSE_END(ARRAY)
+							else JSON_PARSE_CHECK(false);
+							break;
+						case_white_space: pos = detail::skip_ws(in, pos + 1, len) - 1; break;
+						default: {
+							if(f.v->_type == ARRAY) {
+								typename node_t::index_map::const_iterator it = nodes[f.node].indexes.find(f.index);
+								child = (it != nodes[f.node].indexes.end()) ? it->second : nodes[f.node].any;
+							}
+							const bool container = in[pos] == '{' || in[pos] == '[';
+							if(!child || (!nodes[child].leaf && !container)) {
+								// not selected, skipped without validation
+								const size_t end = detail::skip_value(in, pos, len);
+								JSON_PARSE_CHECK(end > pos);
+								pos = end - 1;
+								MASK_VALUE_END
+								break;
+							}
+							ValueT<char_t>* v;
+							if(f.v->_type == ARRAY) {
+								if(f.index >= f.v->_a->size()) f.v->_a->resize(f.index + 1);
+								v = &(*f.v->_a)[f.index];
+							}
+							else v = f.v->key_value(key, key_len, false, key_cow);
+							if(nodes[child].leaf) {
+								switch(in[pos]) {
+									case '\"':                 pos += v->parse_string(in + pos, len - pos, cow) - 1;  break;
+									case '-': case_number_0_9: pos += v->parse_number(in + pos, len - pos, cow) - 1;  break;
+									case 't': case 'f':        pos += v->parse_boolean(in + pos, len - pos, cow) - 1; break;
+									case 'n':                  pos += v->parse_nil(in + pos, len - pos, cow) - 1;     break;
+									case '{': case '[':        pos += v->read(in + pos, len - pos, cow, 0, pf.size() + 1) - 1; break;
+									default: JSON_PARSE_CHECK(false);
+								}
+								MASK_VALUE_END
+								if(nodes[child].id < found.size() && !found[nodes[child].id]) {
+									found[nodes[child].id] = true;
+									if(!--remaining) return pos + 1;
+								}
+								break;
+							}
+							// on the path of selected ones
+							if(f.v->_type == ARRAY) ++f.index;
+							const detail::mask_frame<char_t> sub = {v, child, 0};
+							if(in[pos] == '{') {state = OBJECT_LBRACE;  v->clear(OBJECT);}
+							else               {state = ARRAY_LBRACKET; v->clear(ARRAY);}
+							pf.push_back(sub);
+							JSON_PARSE_CHECK(pf.size() <= __XPJSON_MAX_DEPTH__);
+							break;
+						}
+					}
+					break;
+				case OBJECT_PAIR_VALUE:
+					switch(in[pos]) {
+						case '}': MASK_PARSE_END(OBJECT) break;
+						case ',': state = OBJECT_COMMA;  break;
+						case_white_space: pos = detail::skip_ws(in, pos + 1, len) - 1; break;
+						default: JSON_PARSE_CHECK(false);
+					}
+					break;
+				case ARRAY_ELEM:
+					switch(in[pos]) {
+						case ']': MASK_PARSE_END(ARRAY) break;
+						case ',': state = ARRAY_COMMA;  break;
+						case_white_space: pos = detail::skip_ws(in, pos + 1, len) - 1; break;
+						default: JSON_PARSE_CHECK(false);
+					}
+					break;
+			}
+			++pos;
+		}
+		JSON_PARSE_CHECK(false);
+		return 0;
+	}
+
+#undef MASK_PARSE_END
+#undef MASK_VALUE_END
+
+#define SAX_CALLBACK(call)												\
+	if(!(call)) return pos + 1;
+
+#define SAX_STRING_VALUE(callback) {									\
+		bool e = false;													\
+		const size_t start = pos + 1;									\
+		pos = detail::scan_string(in, start, len, e);					\
+		JSON_READ_CHECK(pos < len, ERROR_END);							\
+		if(e) {															\
+			if(XPJSON_UNLIKELY(!detail::decode(in + start, pos - start, scratch, err))) return 0;\
+			SAX_CALLBACK(h.callback(scratch.data(), scratch.size()))	\
+			scratch.clear();											\
+		}																\
+		else SAX_CALLBACK(h.callback(in + start, pos - start))			\
+	}
+
+#define SAX_SCALAR_END													\
+	state = (pt.back() == OBJECT) ? OBJECT_PAIR_VALUE : ARRAY_ELEM;
+
+#define SAX_PARSE_END(type, callback) {									\
+		JSON_READ_CHECK(pt.back() == type, ERROR_SYNTAX);				\
+		pt.pop_back();													\
+		SAX_CALLBACK(h.callback())										\
+		if(pt.empty()) return pos + 1;/* Object/Array parse finished. */\
+		SAX_SCALAR_END													\
+	}
+
+#define SAX_PUSH_TYPE(type, callback)									\
+	pt.push_back(type);													\
+	JSON_READ_CHECK(pt.size() <= __XPJSON_MAX_DEPTH__, ERROR_DEPTH);	\
+	SAX_CALLBACK(h.callback())
+
+#define SAX_SCALAR_VALUE(parse) {										\
+		register const size_t n = v.parse(in + pos, len - pos, false, err);\
+		if(XPJSON_UNLIKELY(!n)) return 0;								\
+		pos += n - 1;													\
+	}
+
+	template<class char_t>
+	template<class handler_t>
+	size_t ReaderT<char_t>::parse(handler_t& h, const char_t* in, size_t len, detail::read_error<char_t>* err)
+	{
+		// Indicate current parse state, same as read
+		enum {OBJECT_LBRACE,          /* { */
+			  OBJECT_PAIR_KEY,        /* "..." */
+			  OBJECT_PAIR_COLON,      /* "...": */
+			  OBJECT_PAIR_VALUE,      /* "...":"..." */
+			  OBJECT_COMMA,           /* {..., */
+			  ARRAY_LBRACKET,         /* [ */
+			  ARRAY_ELEM,             /* [...[...,... */
+			  ARRAY_COMMA             /* [..., */
+		};
+		register unsigned char state = 0;
+		register size_t pos = detail::skip_ws(in, 0, len);
+		detail::parse_stack<unsigned char> pt(NIL); // types of open objects/arrays
+		ValueT<char_t> v;                           // holds a scalar, never allocates
+		JSON_TSTRING(char_t) scratch;               // decoded string
+		JSON_READ_CHECK(pos < len, ERROR_END);
+		// Topmost value parse.
+		switch(in[pos]) {
+			case '{': state = OBJECT_LBRACE;  pt.reset(OBJECT); SAX_CALLBACK(h.on_object_begin()) break;
+			case '[': state = ARRAY_LBRACKET; pt.reset(ARRAY);  SAX_CALLBACK(h.on_array_begin())  break;
+			default: JSON_READ_CHECK(false, ERROR_SYNTAX);
+		}
+		++pos;
+		while(pos < len) {
+			switch(state) {
+				case OBJECT_LBRACE:
+				case OBJECT_COMMA:
+					switch(in[pos]) {
+						case '\"': state = OBJECT_PAIR_KEY; SAX_STRING_VALUE(on_key) break;
+#if __XPJSON_SUPPORT_DANGLING_COMMA__
+						case '}': SAX_PARSE_END(OBJECT, on_object_end) break;
+#else
+						case '}':
+							if(state == OBJECT_LBRACE) SAX_PARSE_END(OBJECT, on_object_end)
+							else JSON_READ_CHECK(false, ERROR_SYNTAX);
+							break;
+#endif
+						case_white_space: pos = detail::skip_ws(in, pos + 1, len) - 1; break;
+						default: JSON_READ_CHECK(false, ERROR_SYNTAX);
+					}
+					break;
+				case OBJECT_PAIR_KEY:
+					switch(in[pos]) {
+						case ':': state = OBJECT_PAIR_COLON; break;
+						case_white_space: pos = detail::skip_ws(in, pos + 1, len) - 1; break;
+						default: JSON_READ_CHECK(false, ERROR_SYNTAX);
+					}
+					break;
+				case OBJECT_PAIR_COLON:
+				case ARRAY_LBRACKET:
+				case ARRAY_COMMA:
+					switch(in[pos]) {
+						case '\"': SAX_STRING_VALUE(on_string) SAX_SCALAR_END break;
+						case '-': case_number_0_9:
+							SAX_SCALAR_VALUE(parse_number)
+							SAX_CALLBACK(v._type == INTEGER ? h.on_int(v._i) : h.on_double(v._f))
+							SAX_SCALAR_END
+							break;
+						case 't': case 'f':
+							SAX_SCALAR_VALUE(parse_boolean)
+							SAX_CALLBACK(h.on_boolean(v._b))
+							SAX_SCALAR_END
+							break;
+						case 'n':
+							SAX_SCALAR_VALUE(parse_nil)
+							SAX_CALLBACK(h.on_null())
+							SAX_SCALAR_END
+							break;
+						case '{': state = OBJECT_LBRACE;  SAX_PUSH_TYPE(OBJECT, on_object_begin) break;
+						case '[': state = ARRAY_LBRACKET; SAX_PUSH_TYPE(ARRAY, on_array_begin)   break;
+						case ']':
+#if __XPJSON_SUPPORT_DANGLING_COMMA__
+							if(state != OBJECT_PAIR_COLON)
+#else
+							if(state == ARRAY_LBRACKET)
+#endif
+							  SAX_PARSE_END(ARRAY, on_array_end)
+							else JSON_READ_CHECK(false, ERROR_SYNTAX);
+							break;
+						case_white_space: pos = detail::skip_ws(in, pos + 1, len) - 1; break;
+						default: JSON_READ_CHECK(false, ERROR_SYNTAX);
+					}
+					break;
+				case OBJECT_PAIR_VALUE:
+					switch(in[pos]) {
+						case '}': SAX_PARSE_END(OBJECT, on_object_end) break;
+						case ',': state = OBJECT_COMMA;                break;
+						case_white_space: pos = detail::skip_ws(in, pos + 1, len) - 1; break;
+						default: JSON_READ_CHECK(false, ERROR_SYNTAX);
+					}
+					break;
+				case ARRAY_ELEM:
+					switch(in[pos]) {
+						case ']': SAX_PARSE_END(ARRAY, on_array_end) break;
+						case ',': state = ARRAY_COMMA;               break;
+						case_white_space: pos = detail::skip_ws(in, pos + 1, len) - 1; break;
+						default: JSON_READ_CHECK(false, ERROR_SYNTAX);
+					}
+					break;
+			}
+			++pos;
+		}
+		return detail::read_fail(err, ERROR_END, in, len, pos, __LINE__);
+	}
+
+#undef SAX_SCALAR_VALUE
+#undef SAX_PUSH_TYPE
+#undef SAX_SCALAR_END
+#undef SAX_PARSE_END
+#undef SAX_STRING_VALUE
+#undef SAX_CALLBACK
+
+	namespace detail
+	{
+		/* Output of decode dropping everything, for checking escapes only. */
+		template<class char_t>
+		struct null_buffer
+		{
+			inline size_t length() const {return 0;}
+			inline void reserve(size_t) {}
+			inline void append(const char_t*, size_t) {}
+			inline null_buffer& operator+=(char_t) {return *this;}
+		};
+
+		/* Same grammar as ValueT::parse_number, but not converted. Return its length, 0 if invalid, see read_fail. */
+		template<class char_t>
+		size_t check_number(const char_t* in, size_t len, read_error<char_t>* err)
+		{
+			register size_t pos = (in[0] == '-');
+			if(pos < len && in[pos] == '0') {
+				++pos;
+			}
+			else {
+				const size_t start = pos;
+				while(pos < len && unsigned(in[pos] - '0') < 10) ++pos;
+				JSON_READ_CHECK(pos != start, ERROR_NUMBER);
+			}
+			if(pos < len && in[pos] == '.') {
+				const size_t frac = ++pos;
+				while(pos < len && unsigned(in[pos] - '0') < 10) ++pos;
+				JSON_READ_CHECK(pos != frac, ERROR_NUMBER);
+			}
+			if(pos < len && (in[pos] | 0x20) == 'e') {
+				JSON_READ_CHECK(++pos < len, ERROR_NUMBER);
+				if(in[pos] == '-' || in[pos] == '+') ++pos;
+				JSON_READ_CHECK(pos < len && unsigned(in[pos] - '0') < 10, ERROR_NUMBER);
+				while(pos < len && unsigned(in[pos] - '0') < 10) ++pos;
+			}
+			if(XPJSON_UNLIKELY(pos < len)) {
+				switch(in[pos]) {
+					case_number_ending: break;
+					default: JSON_READ_CHECK(false, ERROR_NUMBER);
+				}
+			}
+			return pos;
+		}
+	}
+
+#define VALIDATE_STRING {												\
+		bool e = false;													\
+		const size_t start = pos + 1;									\
+		pos = detail::scan_string(in, start, len, e);					\
+		JSON_READ_CHECK(pos < len, ERROR_END);							\
+		detail::null_buffer<char_t> out;								\
+		if(e && XPJSON_UNLIKELY(!detail::decode(in + start, pos - start, out, err))) return 0;\
+	}
+
+#define VALIDATE_SCALAR(check) {										\
+		register const size_t n = check;								\
+		if(XPJSON_UNLIKELY(!n)) return 0;								\
+		pos += n - 1;													\
+		state = (pt.back() == OBJECT) ? OBJECT_PAIR_VALUE : ARRAY_ELEM;	\
+	}
+
+#define VALIDATE_END(type) {											\
+		JSON_READ_CHECK(pt.back() == type, ERROR_SYNTAX);				\
+		pt.pop_back();													\
+		if(pt.empty()) return pos + 1;/* Object/Array check finished. */\
+		state = (pt.back() == OBJECT) ? OBJECT_PAIR_VALUE : ARRAY_ELEM;	\
+	}
+
+#define VALIDATE_PUSH(type)												\
+	JSON_READ_CHECK(pt.size() < __XPJSON_MAX_DEPTH__, ERROR_DEPTH);	\
+	pt.push_back(type);													\
+	if(pt.size() > depth) depth = pt.size();
+
+	template<class char_t>
+	ReadResultT<char_t> ReaderT<char_t>::validate(const char_t* in, size_t len, size_t* depth)
+	{
+		detail::read_error<char_t> err = {ERROR_NONE, NULL, 0};
+		size_t max_depth = 0;
+		const size_t ret = validate(in, len, max_depth, &err);
+		if(depth) *depth = max_depth;
+		return ReadResultT<char_t>(ret, in, len, err);
+	}
+
+	template<class char_t>
+	size_t ReaderT<char_t>::validate(const char_t* in, size_t len, size_t& depth, detail::read_error<char_t>* err)
+	{
+		// Indicate current parse state, same as parse
+		enum {OBJECT_LBRACE,          /* { */
+			  OBJECT_PAIR_KEY,        /* "..." */
+			  OBJECT_PAIR_COLON,      /* "...": */
+			  OBJECT_PAIR_VALUE,      /* "...":"..." */
+			  OBJECT_COMMA,           /* {..., */
+			  ARRAY_LBRACKET,         /* [ */
+			  ARRAY_ELEM,             /* [...[...,... */
+			  ARRAY_COMMA             /* [..., */
+		};
+		register unsigned char state = 0;
+		register size_t pos = detail::skip_ws(in, 0, len);
+		detail::type_stack pt;
+		ValueT<char_t> v; // null/true/false only, never allocates
+		JSON_READ_CHECK(pos < len, ERROR_END);
+		// Topmost value check.
+		switch(in[pos]) {
+			case '{': state = OBJECT_LBRACE;  VALIDATE_PUSH(OBJECT) break;
+			case '[': state = ARRAY_LBRACKET; VALIDATE_PUSH(ARRAY)  break;
+			default: JSON_READ_CHECK(false, ERROR_SYNTAX);
+		}
+		++pos;
+		while(pos < len) {
+			switch(state) {
+				case OBJECT_LBRACE:
+				case OBJECT_COMMA:
+					switch(in[pos]) {
+						case '\"': state = OBJECT_PAIR_KEY; VALIDATE_STRING break;
+#if __XPJSON_SUPPORT_DANGLING_COMMA__
+						case '}': VALIDATE_END(OBJECT) break;
+#else
+						case '}':
+							if(state == OBJECT_LBRACE) VALIDATE_END(OBJECT)
+							else JSON_READ_CHECK(false, ERROR_SYNTAX);
+							break;
+#endif
+						case_white_space: pos = detail::skip_ws(in, pos + 1, len) - 1; break;
+						default: JSON_READ_CHECK(false, ERROR_SYNTAX);
+					}
+					break;
+				case OBJECT_PAIR_KEY:
+					switch(in[pos]) {
+						case ':': state = OBJECT_PAIR_COLON; break;
+						case_white_space: pos = detail::skip_ws(in, pos + 1, len) - 1; break;
+						default: JSON_READ_CHECK(false, ERROR_SYNTAX);
+					}
+					break;
+				case OBJECT_PAIR_COLON:
+				case ARRAY_LBRACKET:
+				case ARRAY_COMMA:
+					switch(in[pos]) {
+						case '\"':
+							VALIDATE_STRING
+							state = (pt.back() == OBJECT) ? OBJECT_PAIR_VALUE : ARRAY_ELEM;
+							break;
+						case '-': case_number_0_9: VALIDATE_SCALAR(detail::check_number(in + pos, len - pos, err))    break;
+						case 't': case 'f':        VALIDATE_SCALAR(v.parse_boolean(in + pos, len - pos, false, err)) break;
+						case 'n':                  VALIDATE_SCALAR(v.parse_nil(in + pos, len - pos, false, err))     break;
+						case '{': state = OBJECT_LBRACE;  VALIDATE_PUSH(OBJECT) break;
+						case '[': state = ARRAY_LBRACKET; VALIDATE_PUSH(ARRAY)  break;
+						case ']':
+#if __XPJSON_SUPPORT_DANGLING_COMMA__
+							if(state != OBJECT_PAIR_COLON)
+#else
+							if(state == ARRAY_LBRACKET)
+#endif
+							  VALIDATE_END(ARRAY)
+							else JSON_READ_CHECK(false, ERROR_SYNTAX);
+							break;
+						case_white_space: pos = detail::skip_ws(in, pos + 1, len) - 1; break;
+						default: JSON_READ_CHECK(false, ERROR_SYNTAX);
+					}
+					break;
+				case OBJECT_PAIR_VALUE:
+					switch(in[pos]) {
+						case '}': VALIDATE_END(OBJECT) break;
+						case ',': state = OBJECT_COMMA; break;
+						case_white_space: pos = detail::skip_ws(in, pos + 1, len) - 1; break;
+						default: JSON_READ_CHECK(false, ERROR_SYNTAX);
+					}
+					break;
+				case ARRAY_ELEM:
+					switch(in[pos]) {
+						case ']': VALIDATE_END(ARRAY) break;
+						case ',': state = ARRAY_COMMA; break;
+						case_white_space: pos = detail::skip_ws(in, pos + 1, len) - 1; break;
+						default: JSON_READ_CHECK(false, ERROR_SYNTAX);
+					}
+					break;
+			}
+			++pos;
+		}
+		return detail::read_fail(err, ERROR_END, in, len, pos, __LINE__);
+	}
+
+#undef VALIDATE_PUSH
+#undef VALIDATE_END
+#undef VALIDATE_SCALAR
+#undef VALIDATE_STRING
+
+	template<class char_t>
+	size_t IncrementalReaderT<char_t>::scan_string(const char_t* in, size_t pos, size_t len)
+	{
+		const size_t start = pos;
+		if(_escaped) {
+			_escaped = false;
+			++pos;
+		}
+		pos = detail::scan_string(in, pos, len, _e);
+		if(pos >= len) {
+			_escaped = pos > len;
+			_tok.append(in + start, len - start);
+			return len;
+		}
+		// not buffered if all in this chunk
+		if(!_tok.empty()) _tok.append(in + start, pos - start);
+		return pos;
+	}
+
+#define POP_SCALAR_VALUE												\
+	pv.pop_back();														\
+	state = (pv.back()->_type == OBJECT) ? OBJECT_PAIR_VALUE : ARRAY_ELEM;
+
+	template<class char_t>
+	size_t IncrementalReaderT<char_t>::parse(const char_t* in, size_t len)
+	{
+		// throws as before, no limits or reuse, for macros shared with ValueT::read
+		detail::read_error<char_t>* const err = NULL;
+		ReadLimits* const limits = NULL;
+		const bool reuse = false;
+		register size_t pos = 0;
+		unsigned char& state = _state;
+		detail::parse_stack<ValueT<char_t>*>& pv = _pv;
+		const size_t max_depth = __XPJSON_MAX_DEPTH__;
+		// finished, reset first
+		JSON_PARSE_CHECK(!pv.empty());
+		while(pos < len) {
+			switch(state) {
+				case TOPMOST:
+					switch(in[pos]) {
+						case '{': state = OBJECT_LBRACE;  pv.back()->clear(OBJECT); break;
+						case '[': state = ARRAY_LBRACKET; pv.back()->clear(ARRAY);  break;
+						case_white_space: pos = detail::skip_ws(in, pos + 1, len) - 1; break;
+						default: JSON_PARSE_CHECK(false);
+					}
+					break;
+				case OBJECT_LBRACE:
+				case OBJECT_COMMA:
+					switch(in[pos]) {
+						case '\"': state = OBJECT_PAIR_KEY_QUOTE; _e = false; break;
+#if __XPJSON_SUPPORT_DANGLING_COMMA__
+						case '}': OBJECT_ARRAY_PARSE_END(OBJECT) break;
+#else
+						case '}':
+							if(state == OBJECT_LBRACE) OBJECT_ARRAY_PARSE_END(OBJECT)
+							else JSON_PARSE_CHECK(false);
+							break;
+#endif
+						case_white_space: pos = detail::skip_ws(in, pos + 1, len) - 1; break;
+						default: JSON_PARSE_CHECK(false);
+					}
+					break;
+				case OBJECT_PAIR_KEY_QUOTE: {
+					const size_t start = pos;
+					if((pos = scan_string(in, pos, len)) == len) continue;
+					if(_tok.empty()) pv.push_back(pv.back()->key_value(in + start, pos - start, _e, _cow));
+					else {
+						pv.push_back(pv.back()->key_value(_tok.data(), _tok.size(), _e, false));
+						_tok.clear();
+					}
+					state = OBJECT_PAIR_KEY;
+					break;
+				}
+				case OBJECT_PAIR_KEY:
+					switch(in[pos]) {
+						case ':': state = OBJECT_PAIR_COLON; break;
+						case_white_space: pos = detail::skip_ws(in, pos + 1, len) - 1; break;
+						default: JSON_PARSE_CHECK(false);
+					}
+					break;
+				case OBJECT_PAIR_COLON:
+				case ARRAY_LBRACKET:
+				case ARRAY_COMMA:
+					switch(in[pos]) {
+						case '\"': case '-': case_number_0_9: case 't': case 'f': case 'n':
+							// If top elem is array, push a elem, pop it after read.
+							if(pv.back()->_type == ARRAY) {
+								pv.back()->_a->push_back(JSON_MOVE(ValueT<char_t>()));
+								pv.push_back(&pv.back()->_a->back());
+							}
+							if(in[pos] == '\"') {
+								state = STRING_VALUE;
+								_e = false;
+								break;
+							}
+							// first char is a part of scalar
+							state = SCALAR_VALUE;
+							continue;
+						case '{': state = OBJECT_LBRACE;  PUSH_VALUE_TO_STACK(OBJECT) break;
+						case '[': state = ARRAY_LBRACKET; PUSH_VALUE_TO_STACK(ARRAY)  break;
+						case ']':
+#if __XPJSON_SUPPORT_DANGLING_COMMA__
+							if(state != OBJECT_PAIR_COLON)
+#else
+							if(state == ARRAY_LBRACKET)
+#endif
+							  OBJECT_ARRAY_PARSE_END(ARRAY)
+							else JSON_PARSE_CHECK(false);
+							break;
+						case_white_space: pos = detail::skip_ws(in, pos + 1, len) - 1; break;
+						default: JSON_PARSE_CHECK(false);
+					}
+					break;
+				case STRING_VALUE: {
+					const size_t start = pos;
+					if((pos = scan_string(in, pos, len)) == len) continue;
+					if(_tok.empty()) pv.back()->assign_raw(in + start, pos - start, _e, _cow);
+					else {
+						pv.back()->assign_raw(_tok.data(), _tok.size(), _e, false);
+						_tok.clear();
+					}
+					POP_SCALAR_VALUE
+					break;
+				}
+				case SCALAR_VALUE: {
+					const size_t start = pos;
+					while(pos < len && detail::is_scalar_char(in[pos])) ++pos;
+					if(pos == len) {
+						_tok.append(in + start, len - start);
+						continue;
+					}
+					const char_t* s = in + start;
+					size_t n = pos - start;
+					if(!_tok.empty()) {
+						_tok.append(s, n);
+						s = _tok.data();
+						n = _tok.size();
+					}
+					switch(*s) {
+						case '-': case_number_0_9: JSON_PARSE_CHECK(pv.back()->parse_number(s, n, false) == n);  break;
+						case 't': case 'f':        JSON_PARSE_CHECK(pv.back()->parse_boolean(s, n, false) == n); break;
+						default:                   JSON_PARSE_CHECK(pv.back()->parse_nil(s, n, false) == n);     break;
+					}
+					_tok.clear();
+					POP_SCALAR_VALUE
+					// char after scalar is not consumed yet
+					continue;
+				}
+				case OBJECT_PAIR_VALUE:
+					switch(in[pos]) {
+						case '}': OBJECT_ARRAY_PARSE_END(OBJECT)  break;
+						case ',': state = OBJECT_COMMA;           break;
+						case_white_space: pos = detail::skip_ws(in, pos + 1, len) - 1; break;
+						default: JSON_PARSE_CHECK(false);
+					}
+					break;
+				case ARRAY_ELEM:
+					switch(in[pos]) {
+						case ']': OBJECT_ARRAY_PARSE_END(ARRAY)  break;
+						case ',': state = ARRAY_COMMA;           break;
+						case_white_space: pos = detail::skip_ws(in, pos + 1, len) - 1; break;
+						default: JSON_PARSE_CHECK(false);
+					}
+					break;
+			}
+			++pos;
+		}
+		return pos;
+	}
+
+#undef POP_SCALAR_VALUE
+
+	template<class char_t>
+	size_t CursorT<char_t>::read_scalar(ValueT<char_t>& v, bool cow) const
+	{
+		const char_t* in = _in;
+		const size_t len = _len;
+		const size_t pos = _pos;
+		JSON_PARSE_CHECK(pos < len);
+		switch(in[pos]) {
+			case '\"':                 return v.parse_string(in + pos, len - pos, cow);
+			case '-': case_number_0_9: return v.parse_number(in + pos, len - pos, cow);
+			case 't': case 'f':        return v.parse_boolean(in + pos, len - pos, cow);
+			case 'n':                  return v.parse_nil(in + pos, len - pos, cow);
+			case '{': v.clear(OBJECT); return 0;
+			case '[': v.clear(ARRAY);  return 0;
+			default: JSON_PARSE_CHECK(false);
+		}
+	}
+
+	template<class char_t>
+	Type CursorT<char_t>::type() const
+	{
+		const char_t* in = _in;
+		const size_t len = _len;
+		const size_t pos = _pos;
+		JSON_PARSE_CHECK(pos < len);
+		switch(in[pos]) {
+			case '\"':          return STRING;
+			case '{':           return OBJECT;
+			case '[':           return ARRAY;
+			case 't': case 'f': return BOOLEAN;
+			case 'n':           return NIL;
+			default: {
+				ValueT<char_t> v;
+				read_scalar(v);
+				return v.type();
+			}
+		}
+	}
+
+	template<class char_t>
+	CursorT<char_t> CursorT<char_t>::find_field(const char_t* key, size_t key_len) const
+	{
+		const char_t* in = _in;
+		const size_t len = _len;
+		register size_t pos = _pos;
+		if(pos >= len) return *this;
+		JSON_CHECK_TYPE(type(), OBJECT);
+		JSON_PARSE_CHECK((pos = detail::skip_ws(in, pos + 1, len)) < len);
+		if(in[pos] == '}') return CursorT(in, len, len);
+		tstring decoded;
+		while(true) {
+			bool e = false;
+			JSON_PARSE_CHECK(in[pos] == '\"');
+			const size_t start = pos + 1;
+			JSON_PARSE_CHECK((pos = detail::scan_string(in, start, len, e)) < len);
+			bool found;
+			if(e) {
+				decoded.clear();
+				detail::decode(in + start, pos - start, decoded);
+				found = decoded.length() == key_len && !detail::tcsncmp(decoded.data(), key, key_len);
+			}
+			else found = pos - start == key_len && !detail::tcsncmp(in + start, key, key_len);
+			JSON_PARSE_CHECK((pos = detail::skip_ws(in, pos + 1, len)) < len && in[pos] == ':');
+			JSON_PARSE_CHECK((pos = detail::skip_ws(in, pos + 1, len)) < len);
+			if(found) return CursorT(in, len, pos);
+			// skip the value
+			JSON_PARSE_CHECK((pos = detail::skip_ws(in, detail::skip_value(in, pos, len), len)) < len);
+			if(in[pos] == '}') return CursorT(in, len, len);
+			JSON_PARSE_CHECK(in[pos] == ',');
+			JSON_PARSE_CHECK((pos = detail::skip_ws(in, pos + 1, len)) < len);
+		}
+	}
+
+	template<class char_t>
+	CursorT<char_t> CursorT<char_t>::begin() const
+	{
+		const char_t* in = _in;
+		const size_t len = _len;
+		size_t pos = _pos;
+		JSON_PARSE_CHECK(pos < len);
+		JSON_CHECK_TYPE(type(), ARRAY);
+		JSON_PARSE_CHECK((pos = detail::skip_ws(in, pos + 1, len)) < len);
+		return CursorT(in, len, in[pos] == ']' ? len : pos);
+	}
+
+	template<class char_t>
+	CursorT<char_t> CursorT<char_t>::next() const
+	{
+		const char_t* in = _in;
+		const size_t len = _len;
+		register size_t pos = _pos;
+		JSON_PARSE_CHECK(pos < len);
+		JSON_PARSE_CHECK((pos = detail::skip_ws(in, detail::skip_value(in, pos, len), len)) < len);
+		if(in[pos] == ']') return CursorT(in, len, len);
+		JSON_PARSE_CHECK(in[pos] == ',');
+		JSON_PARSE_CHECK((pos = detail::skip_ws(in, pos + 1, len)) < len);
+		return CursorT(in, len, pos);
+	}
+
+	template<class char_t>
+	bool CursorT<char_t>::view(const char_t*& s, size_t& slen) const
+	{
+		const char_t* in = _in;
+		const size_t len = _len;
+		register size_t pos = _pos;
+		bool e = false;
+		JSON_PARSE_CHECK(pos < len);
+		JSON_CHECK_TYPE(type(), STRING);
+		JSON_PARSE_CHECK((pos = detail::scan_string(in, pos + 1, len, e)) < len);
+		s = in + _pos + 1;
+		slen = pos - _pos - 1;
+		// e is set by '/', control and non-ASCII chars too, only backslashes need decoding
+		return !e || detail::find_quote_or_backslash(in, _pos + 1, pos) == pos;
+	}
+
+	template<class char_t>
+	void CursorT<char_t>::raw(const char_t*& s, size_t& slen) const
+	{
+		const char_t* in = _in;
+		const size_t len = _len;
+		const size_t pos = _pos;
+		JSON_PARSE_CHECK(pos < len);
+		s = in + pos;
+		slen = detail::skip_value(in, pos, len) - pos;
+	}
+
+	template<class char_t>
+	CursorT<char_t> CursorT<char_t>::field(const char_t* key, size_t key_len) const
+	{
+		if(_pos >= _len || _in[_pos] != '{') return CursorT(_in, _len, _len);
+		return find_field(key, key_len);
+	}
+
+	template<class char_t>
+	CursorT<char_t> CursorT<char_t>::element(size_t index) const
+	{
+		if(_pos >= _len || _in[_pos] != '[') return CursorT(_in, _len, _len);
+		CursorT e = begin();
+		for(; index && e.valid(); --index) e = e.next();
+		return e;
+	}
+
+	template<class char_t>
+	CursorT<char_t> CursorT<char_t>::at(const char_t* pointer, size_t plen) const
+	{
+		JSON_ASSERT_CHECK1(!plen || pointer[0] == '/', "Path error: %s.", detail::get_cstr(pointer, plen).c_str());
+		CursorT c(*this);
+		tstring token;
+		for(size_t pos = 0, end; pos < plen; pos = end) {
+			bool escaped = false;
+			for(end = pos + 1; end < plen && pointer[end] != '/'; ++end) escaped = escaped || pointer[end] == '~';
+			const char_t* s = pointer + pos + 1;
+			size_t n = end - pos - 1;
+			// unescape only if needed, so no allocation for common tokens
+			if(escaped) {
+				JSON_ASSERT_CHECK1(detail::unescape_pointer(s, n, token), "Path error: %s.", detail::get_cstr(pointer, plen).c_str());
+				s = token.data();
+				n = token.length();
+			}
+			size_t index;
+			if(!c.valid()) continue;
+			else if(c._in[c._pos] != '[') c = c.field(s, n);
+			else if(detail::pointer_index(s, n, index)) c = c.element(index);
+			else c = CursorT(_in, _len, _len);
+		}
+		return c;
+	}
+
+	template<class char_t>
+	CursorT<char_t> CursorT<char_t>::path(const char_t* expr, size_t plen) const
+	{
+		CursorT c(*this);
+		for(size_t pos = 0, end; pos < plen; pos = end) {
+			if(expr[pos] == '[') {
+				size_t index;
+				for(end = pos + 1; end < plen && expr[end] != ']'; ++end);
+				JSON_ASSERT_CHECK1(end < plen && detail::pointer_index(expr + pos + 1, end - pos - 1, index), "Path error: %s.", detail::get_cstr(expr, plen).c_str());
+				c = c.element(index);
+				++end;
+			}
+			else {
+				if(pos) {
+					JSON_ASSERT_CHECK1(expr[pos] == '.', "Path error: %s.", detail::get_cstr(expr, plen).c_str());
+					++pos;
+				}
+				for(end = pos; end < plen && expr[end] != '.' && expr[end] != '['; ++end);
+				JSON_ASSERT_CHECK1(end > pos, "Path error: %s.", detail::get_cstr(expr, plen).c_str());
+				c = c.field(expr + pos, end - pos);
+			}
+		}
+		return c;
+	}
+
+	template<class char_t>
+	size_t CursorT<char_t>::read(ValueT<char_t>& v, bool cow) const
+	{
+		const char_t* in = _in;
+		const size_t len = _len;
+		const size_t pos = _pos;
+		JSON_PARSE_CHECK(pos < len);
+		if(in[pos] == '{' || in[pos] == '[') return v.read(in + pos, len - pos, cow);
+		return read_scalar(v, cow);
+	}
+
+	template<class char_t>
+	size_t ReaderT<char_t>::readv(ValueT<char_t>& v, const struct iovec* iov, int iovcnt, bool cow)
+	{
+		IncrementalReaderT<char_t> r(v, cow);
+		size_t total = 0;
+		for(int i = 0; i < iovcnt; ++i) {
+			const size_t len = iov[i].iov_len / sizeof(char_t);
+			if(r.feed((const char_t*)iov[i].iov_base, len) == IncrementalReaderT<char_t>::DONE) return total + r.consumed();
+			total += len;
+		}
+		JSON_ASSERT_CHECK1(false, "Parse error: document not finished in %d segments.", iovcnt);
+		return total;
+	}
+
+	namespace detail
+	{
+		template<class istream_t>
+		struct istream_source
+		{
+			istream_t& in;
+			template<class char_t> size_t read(char_t* buf, size_t n) {in.read(buf, n); return (size_t)in.gcount();}
+		};
+
+		struct file_source
+		{
+			FILE* fp;
+			template<class char_t> size_t read(char_t* buf, size_t n) {return fread(buf, sizeof(char_t), n, fp);}
+		};
+
+		/* Feed blocks read from source to incremental reader until document finished. */
+		template<class char_t, class source_t>
+		size_t read_blocks(ValueT<char_t>& v, source_t& src, size_t block)
+		{
+			std::vector<char_t> buf(block ? block : 1);
+			IncrementalReaderT<char_t> r(v);
+			size_t total = 0;
+			for(size_t n; (n = src.read(&buf[0], buf.size())); total += n) {
+				if(r.feed(&buf[0], n) == IncrementalReaderT<char_t>::DONE) return total + r.consumed();
+			}
+			JSON_ASSERT_CHECK1(false, "Parse error: document not finished at %lu.", (unsigned long)total);
+			return total;
+		}
+	}
+
+	template<class char_t>
+	template<class istream_t>
+	size_t ReaderT<char_t>::read_stream(ValueT<char_t>& v, istream_t& in, size_t block)
+	{
+		detail::istream_source<istream_t> src = {in};
+		return detail::read_blocks(v, src, block);
+	}
+
+	template<class char_t>
+	size_t ReaderT<char_t>::read_stream(ValueT<char_t>& v, FILE* fp, size_t block)
+	{
+		detail::file_source src = {fp};
+		return detail::read_blocks(v, src, block);
+	}
+
+	namespace detail
+	{
+		inline bool mapped_file::open(const char* path)
+		{
+			close();
+#if __XPJSON_SUPPORT_MMAP__
+			const int fd = ::open(path, O_RDONLY);
+			if(fd < 0) return false;
+			struct stat st;
+			if(fstat(fd, &st) || !S_ISREG(st.st_mode)) {
+				::close(fd);
+				return false;
+			}
+			_size = (size_t)st.st_size;
+			if(_size) {
+				_p = mmap(NULL, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+				if(_p == MAP_FAILED) _p = NULL;
+			}
+			::close(fd);
+			return _p || !_size;
+#else
+			FILE* fp = fopen(path, "rb");
+			if(!fp) return false;
+			bool ok = !fseek(fp, 0, SEEK_END);
+			const long size = ok ? ftell(fp) : -1;
+			ok = size >= 0 && !fseek(fp, 0, SEEK_SET);
+			if(ok && size) {
+				_size = (size_t)size;
+				ok = (_p = malloc(_size)) && fread(_p, 1, _size, fp) == _size;
+			}
+			fclose(fp);
+			if(!ok) close();
+			return ok;
+#endif
+		}
+
+		inline void mapped_file::close()
+		{
+#if __XPJSON_SUPPORT_MMAP__
+			if(_p) munmap(_p, _size);
+#else
+			free(_p);
+#endif
+			_p = NULL;
+			_size = 0;
+		}
+
+		inline void mapped_file::advise(bool sequential)
+		{
+#if __XPJSON_SUPPORT_MMAP__ && defined(MADV_SEQUENTIAL)
+			if(_p) madvise(_p, _size, sequential ? MADV_SEQUENTIAL : MADV_NORMAL);
+#else
+			(void)sequential;
+#endif
+		}
+	}
+
+	template<class char_t>
+	size_t DocumentT<char_t>::read_file(const char* path)
+	{
+		close();
+		JSON_ASSERT_CHECK1(_file.open(path), "File error: can't read %.200s.", path);
+		_file.advise(true);
+		const ReadResultT<char_t> r = this->try_read((const char_t*)_file.data(), _file.size() / sizeof(char_t), true);
+		if(XPJSON_UNLIKELY(!r.ok())) {
+			// format before the input is released
+			const JSON_TSTRING(char) what = r.message();
+			close();
+			JSON_THROW(std::logic_error(what));
+		}
+		_file.advise(false);
+		return r.offset;
+	}
+
+	template<class char_t>
+	size_t ReaderT<char_t>::read_file(ValueT<char_t>& v, const char* path)
+	{
+		detail::mapped_file file;
+		JSON_ASSERT_CHECK1(file.open(path), "File error: can't read %.200s.", path);
+		file.advise(true);
+		return v.read((const char_t*)file.data(), file.size() / sizeof(char_t), false);
+	}
+
+	namespace detail
+	{
+		/* Offset after the line begins at in[pos], i.e., of '\n' or len. */
+		template<class char_t>
+		inline size_t line_end(const char_t* in, size_t pos, size_t len)
+		{
+			const char_t* p = find_newline(in + pos, len - pos);
+			return p ? p - in : len;
+		}
+
+		// lines [begin, end) of NDJSON read by one thread, values go to out[first, first + count)
+		template<class char_t>
+		struct lines_task
+		{
+			const char_t* in;
+			size_t begin, end;
+			size_t count;
+			size_t first;
+			ValueT<char_t>* out;
+			bool cow;
+			std::vector<size_t> bad;
+
+			static void count_lines(lines_task* t)
+			{
+				t->count = 0;
+				for(size_t pos = t->begin, eol; pos < t->end; pos = eol + 1) {
+					eol = line_end(t->in, pos, t->end);
+					if(skip_ws(t->in, pos, eol) < eol) ++t->count;
+				}
+			}
+
+			static void read_lines(lines_task* t)
+			{
+				const char_t* in = t->in;
+				ValueT<char_t>* v = t->out + t->first;
+				for(size_t pos = t->begin, eol; pos < t->end; pos = eol + 1) {
+					eol = line_end(in, pos, t->end);
+					if((pos = skip_ws(in, pos, eol)) == eol) continue;
+					const ReadResultT<char_t> r = v->try_read(in + pos, eol - pos, t->cow);
+					// rest of the line must be blank
+					if(!r.ok() || skip_ws(in, pos + r.offset, eol) != eol) {
+						*v = ValueT<char_t>();
+						t->bad.push_back(v - t->out);
+					}
+					++v;
+				}
+			}
+		};
+
+		// forwards events to handler, remembers it returned false
+		template<class handler_t, class char_t>
+		struct line_handler
+		{
+			handler_t& h;
+			bool stopped;
+			line_handler(handler_t& handler) : h(handler), stopped(false) {}
+#define FORWARD_CALLBACK(callback, params, args)	inline bool callback params {stopped = !h.callback args; return !stopped;}
+			FORWARD_CALLBACK(on_null, (), ())
+			FORWARD_CALLBACK(on_boolean, (bool b), (b))
+			FORWARD_CALLBACK(on_int, (int64_t i), (i))
+			FORWARD_CALLBACK(on_double, (double f), (f))
+			FORWARD_CALLBACK(on_string, (const char_t* s, size_t len), (s, len))
+			FORWARD_CALLBACK(on_key, (const char_t* s, size_t len), (s, len))
+			FORWARD_CALLBACK(on_object_begin, (), ())
+			FORWARD_CALLBACK(on_object_end, (), ())
+			FORWARD_CALLBACK(on_array_begin, (), ())
+			FORWARD_CALLBACK(on_array_end, (), ())
+#undef FORWARD_CALLBACK
+		};
+	}
+
+	template<class char_t>
+	size_t ReaderT<char_t>::read_lines(std::vector<ValueT<char_t> >& out, const char_t* in, size_t len, std::vector<size_t>* bad, unsigned threads, bool cow)
+	{
+		// small chunks are not worth a thread
+		static const size_t min_chunk = 64 * 1024;
+#if __XPJSON_SUPPORT_THREAD__
+		if(!threads) threads = std::thread::hardware_concurrency();
+#else
+		threads = 1;
+#endif
+		if(!threads) threads = 1;
+		if(threads > len / min_chunk + 1) threads = (unsigned)(len / min_chunk + 1);
+		std::vector<detail::lines_task<char_t> > tasks(threads);
+		// split at newlines after even offsets
+		for(size_t i = 0, pos = 0; i < threads; ++i) {
+			const size_t split = len / threads * (i + 1);
+			tasks[i].in = in;
+			tasks[i].cow = cow;
+			tasks[i].begin = pos;
+			if(i + 1 == threads) pos = len;
+			else if(pos < split) pos = std::min(detail::line_end(in, split, len) + 1, len);
+			tasks[i].end = pos;
+		}
+#if __XPJSON_SUPPORT_THREAD__
+#	define RUN_TASKS(fn)																\
+		{																				\
+			std::vector<std::thread> workers;											\
+			for(size_t i = 1; i < threads; ++i) workers.push_back(std::thread(fn, &tasks[i]));	\
+			fn(&tasks[0]);																\
+			for(size_t i = 0; i < workers.size(); ++i) workers[i].join();				\
+		}
+#else
+#	define RUN_TASKS(fn)	fn(&tasks[0]);
+#endif
+		RUN_TASKS(detail::lines_task<char_t>::count_lines)
+		size_t total = 0;
+		for(size_t i = 0; i < threads; ++i) {
+			tasks[i].first = total;
+			total += tasks[i].count;
+		}
+		out.clear();
+		out.resize(total);
+		for(size_t i = 0; i < threads; ++i) tasks[i].out = total ? &out[0] : NULL;
+		RUN_TASKS(detail::lines_task<char_t>::read_lines)
+#undef RUN_TASKS
+		if(bad) {
+			for(size_t i = 0; i < threads; ++i) bad->insert(bad->end(), tasks[i].bad.begin(), tasks[i].bad.end());
+		}
+		return total;
+	}
+
+	template<class char_t>
+	template<class handler_t>
+	ReadResultT<char_t> ReaderT<char_t>::try_parse(handler_t& handler, const char_t* in, size_t len)
+	{
+		detail::read_error<char_t> err = {ERROR_NONE, NULL, 0};
+		const size_t ret = parse(handler, in, len, &err);
+		return ReadResultT<char_t>(ret, in, len, err);
+	}
+
+	template<class char_t>
+	template<class handler_t>
+	size_t ReaderT<char_t>::parse_lines(handler_t& handler, const char_t* in, size_t len, std::vector<size_t>* bad)
+	{
+		size_t count = 0;
+		for(size_t pos = 0, eol; pos < len; pos = eol + 1) {
+			eol = detail::line_end(in, pos, len);
+			if((pos = detail::skip_ws(in, pos, eol)) == eol) continue;
+			detail::line_handler<handler_t, char_t> h(handler);
+			const ReadResultT<char_t> r = try_parse(h, in + pos, eol - pos);
+			if(bad && (!r.ok() || (!h.stopped && detail::skip_ws(in, pos + r.offset, eol) != eol))) bad->push_back(count);
+			++count;
+		}
+		return count;
+	}
 #undef case_white_space
 #undef case_number_0_9
 #undef case_number_ending
 #undef OBJECT_ARRAY_PARSE_END
 #undef PUSH_VALUE_TO_STACK
+#undef READ_SCALAR_VALUE
+#undef REUSE_VALUE_ON_STACK
+#undef CHARGE_LIMITS
 
 	template<class char_t>
 	void WriterT<char_t>::write(const ObjectT<char_t>& o, JSON_TSTRING(char_t)& out)
@@ -1558,7 +5321,7 @@ namespace JSON
 		out += '{';
 		for(typename ObjectT<char_t>::const_iterator it = o.begin(); it != o.end(); ++it) {
 			out += '\"';
-			detail::encode(it->first.c_str(), it->first.length(), out);
+			detail::encode(it->first.data(), it->first.length(), out);
 			out += '\"';
 			out += ':';
 			it->second.write(out);
@@ -1608,7 +5371,7 @@ namespace JSON
 			case NIL:     return true;
 			case BOOLEAN: return lhs.b() == rhs.b();
 			case INTEGER: return lhs.i() == rhs.i();
-			case FLOAT:   return fabs(lhs.f() - rhs.f()) < JSON_EPSILON;
+			case FLOAT:   return lhs.f() == rhs.f() || fabs(lhs.f() - rhs.f()) < JSON_EPSILON; // infinities equal
 			case STRING:  return lhs.length() == rhs.length() && !memcmp(lhs.c_str(), rhs.c_str(), lhs.length());
 			case OBJECT:  return lhs.o() == rhs.o();
 			case ARRAY:   return lhs.a() == rhs.a();